@@ -7,6 +7,7 @@
 #include "runtime/runtime_error.hpp"
 #include "runtime/ptc_arguments.hpp"
 #include "runtime/instantiated_function.hpp"
+#include "runtime/global_context.hpp"
 #include "llds/reference_stack.hpp"
 #include "utils.hpp"
 namespace asteria {
@@ -44,6 +45,9 @@ Reference&
 cow_function::
 invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack) const
   {
+    // Charge storage that is allocated by this function to `global`.
+    ::rocket::xmemacct_scope acct_scope(global.memory_accountant());
+
     try {
       stack.clear_red_zone();
 
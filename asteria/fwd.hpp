@@ -130,6 +130,7 @@ class Simple_Script;
 
 // Low-level data structures
 class Variable_HashMap;
+class Variable_Arena;
 class Reference_Dictionary;
 class Reference_Stack;
 class AVM_Rod;
@@ -154,6 +155,7 @@ class Global_Context;
 class Garbage_Collector;
 class Random_Engine;
 class Module_Loader;
+class Regex_Cache;
 class Variadic_Arguer;
 class Instantiated_Function;
 class AIR_Node;
@@ -173,6 +175,7 @@ class Statement;
 class Infix_Element;
 class Statement_Sequence;
 class AIR_Optimizer;
+class AIR_Serializer;
 
 // Native binding prototype
 using simple_function =
@@ -564,6 +567,13 @@ class cow_function
     explicit operator bool() const noexcept
       { return this->m_fptr || this->m_sptr;  }
 
+    // Gets the target function object if it is an instance of `xFunc`, or a
+    // null pointer otherwise.
+    template<typename xFunc>
+    const xFunc*
+    get_opt() const noexcept
+      { return dynamic_cast<const xFunc*>(this->m_sptr.get());  }
+
     const type_info&
     type() const
       {
@@ -773,6 +783,13 @@ enum GC_Generation : uint8_t
     gc_generation_oldest  = 2,
   };
 
+// Garbage collection threshold policies
+enum GC_Policy : uint8_t
+  {
+    gc_policy_fixed     = 0,  // thresholds are only set by the user
+    gc_policy_adaptive  = 1,  // thresholds follow a target overhead
+  };
+
 // Options for source parsing and code generation
 template<uint32_t... paramsT>
 struct Compiler_Options_template;
@@ -832,7 +849,8 @@ struct Compiler_Options_fragment<1>
     // Treat unresolved names as global references.
     bool implicit_global_names = false;
 
-    // Enable optimization.
+    // Enable optimization. Level 3 also merges common sequences of nodes into
+    // superinstructions.
     uint8_t optimization_level = 2;
   };
 
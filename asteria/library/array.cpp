@@ -6,8 +6,14 @@
 #include "../runtime/argument_reader.hpp"
 #include "../runtime/binding_generator.hpp"
 #include "../runtime/global_context.hpp"
+#include "../runtime/instantiated_function.hpp"
+#include "../runtime/air_optimizer.hpp"
+#include "../runtime/air_serializer.hpp"
 #include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
+#include "../../rocket/mutex.hpp"
+#include "../../rocket/condition_variable.hpp"
+#include <thread>
 namespace asteria {
 namespace {
 
@@ -237,6 +243,246 @@ do_merge_blocks(V_array& output, bool unique, V_array& input, xComparator&& comp
     return output;
   }
 
+// Parallel algorithms split their input into chunks, and process each chunk
+// on a worker thread. The callback is not called directly, as it may refer to
+// variables of the calling thread. Instead, it is serialized, and instantiated
+// again by each worker in a `Global_Context` of its own. Elements are shared
+// by workers, which is safe because reference counting is atomic and values
+// are copy-on-write, but they shall not contain functions or opaque values.
+constexpr size_t parallel_max_threads = 64;
+constexpr size_t parallel_min_chunk_size = 256;
+
+struct Parallel_Chunk
+  {
+    size_t begin;
+    size_t end;
+    V_array output;
+    cow_string error;
+  };
+
+using Parallel_Chunks = static_vector<Parallel_Chunk, parallel_max_threads>;
+
+struct Parallel_Batch
+  {
+    void (*run)(void*, Global_Context&, Parallel_Chunk&) noexcept;
+    void* param;
+    Parallel_Chunks* chunks;
+
+    // These are protected by the mutex of the pool.
+    size_t next = 0;
+    size_t pending = 0;
+    ::rocket::condition_variable done;
+  };
+
+// This is set on worker threads. A parallel call from a callback is run on
+// the calling worker, because waiting for other workers could deadlock.
+thread_local bool s_is_parallel_worker;
+
+// Worker threads are started on demand, and are shared by all calls. Each
+// worker creates its global context only once, and resets it after each
+// chunk. Workers are detached and the pool is never destroyed, so there is
+// nothing to do when the process exits.
+class Parallel_Worker_Pool
+  {
+  private:
+    ::rocket::mutex m_mutex;
+    ::rocket::condition_variable m_avail;
+    cow_vector<Parallel_Batch*> m_queue;
+    size_t m_nthreads = 0;
+
+  public:
+    Parallel_Worker_Pool() = default;
+
+    Parallel_Worker_Pool(const Parallel_Worker_Pool&) = delete;
+    Parallel_Worker_Pool& operator=(const Parallel_Worker_Pool&) & = delete;
+
+  private:
+    void
+    do_worker_loop() noexcept
+      {
+        s_is_parallel_worker = true;
+        Global_Context global;
+
+        ::rocket::mutex::unique_lock lock(this->m_mutex);
+        for(;;) {
+          while(this->m_queue.empty())
+            this->m_avail.wait(lock);
+
+          // Take a chunk from the oldest batch.
+          auto batch = this->m_queue.front();
+          size_t k = batch->next ++;
+          if(batch->next == batch->chunks->size())
+            this->m_queue.erase(this->m_queue.begin());
+
+          lock.unlock();
+          batch->run(batch->param, global, batch->chunks->mut(k));
+
+          try {
+            global.reset();
+          }
+          catch(exception& stdex) {
+            ASTERIA_TERMINATE(("Could not reset global context of worker: $1"), stdex);
+          }
+
+          lock.lock(this->m_mutex);
+          if(-- batch->pending == 0)
+            batch->done.notify_all();
+        }
+      }
+
+  public:
+    // Processes all chunks of `batch`, and waits for them to finish.
+    void
+    run(Parallel_Batch& batch)
+      {
+        ::rocket::mutex::unique_lock lock(this->m_mutex);
+        while(this->m_nthreads < batch.chunks->size()) {
+          ::std::thread(&Parallel_Worker_Pool::do_worker_loop, this).detach();
+          this->m_nthreads ++;
+        }
+
+        batch.next = 0;
+        batch.pending = batch.chunks->size();
+        this->m_queue.emplace_back(&batch);
+        this->m_avail.notify_all();
+
+        while(batch.pending != 0)
+          batch.done.wait(lock);
+      }
+  };
+
+Parallel_Worker_Pool&
+do_get_worker_pool()
+  {
+    static auto s_pool = new Parallel_Worker_Pool;
+    return *s_pool;
+  }
+
+bool
+do_is_transferable(const Value& val) noexcept
+  {
+    switch(val.type())
+      {
+      case type_null:
+      case type_boolean:
+      case type_integer:
+      case type_real:
+      case type_string:
+        return true;
+
+      case type_opaque:
+      case type_function:
+        return false;
+
+      case type_array:
+        return ::std::all_of(val.as_array().begin(), val.as_array().end(),
+                  [](const Value& elem) { return do_is_transferable(elem);  });
+
+      case type_object:
+        return ::std::all_of(val.as_object().begin(), val.as_object().end(),
+                  [](const auto& pair) { return do_is_transferable(pair.second);  });
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), val.type());
+    }
+  }
+
+template<typename xWork>
+void
+do_run_parallel(Parallel_Chunks& chunks, Global_Context& global, const V_function& callback,
+                const V_array& data, xWork&& work)
+  {
+    // Serialize the callback. This fails if it captures any variables.
+    auto qfunc = callback.get_opt<Instantiated_Function>();
+    if(!qfunc)
+      ASTERIA_THROW(("Callback `$1` is not a script function"), callback);
+
+    auto qcode = qfunc->source_opt();
+    if(!qcode)
+      ASTERIA_THROW(("Callback `$1` captures variables and is not callable on worker threads"),
+                    callback);
+
+    cow_string bytes;
+    try {
+      AIR_Serializer ser;
+      bytes = ser.save(qfunc->opts(), qfunc->func(), qfunc->params(), *qcode);
+    }
+    catch(exception& stdex) {
+      ASTERIA_THROW(("Callback `$1` not callable on worker threads: $2"), callback, stdex.what());
+    }
+
+    for(const auto& elem : data)
+      if(!do_is_transferable(elem))
+        ASTERIA_THROW(("Element `$1` not sharable with worker threads"), elem);
+
+    // Divide elements evenly.
+    size_t nthreads = ::rocket::min(::rocket::max(::std::thread::hardware_concurrency(), 1U),
+                                    parallel_max_threads,
+                                    (data.size() + parallel_min_chunk_size - 1) / parallel_min_chunk_size);
+
+    if(nthreads == 0)
+      return;
+
+    if((nthreads == 1) || s_is_parallel_worker) {
+      // This is not worth a worker thread, or this is a nested call on a
+      // worker thread, so call the callback directly. The same checks are
+      // made, so results do not depend on the size of `data`.
+      auto& chunk = chunks.emplace_back();
+      chunk.begin = 0;
+      chunk.end = data.size();
+      work(global, callback, data, chunk);
+
+      for(const auto& elem : chunk.output)
+        if(!do_is_transferable(elem))
+          ASTERIA_THROW(("Result `$1` not returnable from worker threads"), elem);
+
+      return;
+    }
+
+    for(size_t k = 0;  k != nthreads;  ++k) {
+      auto& chunk = chunks.emplace_back();
+      chunk.begin = data.size() * k / nthreads;
+      chunk.end = data.size() * (k + 1) / nthreads;
+    }
+
+    auto run_chunk = [&](Global_Context& wglobal, Parallel_Chunk& chunk) noexcept
+      {
+        try {
+          Compiler_Options opts;
+          cow_string name;
+          cow_vector<phsh_string> params;
+          cow_vector<AIR_Node> code;
+          AIR_Serializer ser;
+          ser.load(opts, name, params, code, bytes.data(), bytes.size());
+
+          // Instantiate the callback for this thread.
+          AIR_Optimizer optmz(opts);
+          optmz.rebind(nullptr, params, code);
+          auto func = optmz.create_function(qfunc->sloc(), name);
+          work(wglobal, func, data, chunk);
+
+          for(const auto& elem : chunk.output)
+            if(!do_is_transferable(elem))
+              ASTERIA_THROW(("Result `$1` not returnable from worker threads"), elem);
+        }
+        catch(exception& stdex) {
+          chunk.output.clear();
+          chunk.error = cow_string(stdex.what());
+        }
+      };
+
+    Parallel_Batch batch;
+    batch.run = [](void* param, Global_Context& wglobal, Parallel_Chunk& chunk) noexcept
+      { (*static_cast<decltype(run_chunk)*>(param))(wglobal, chunk);  };
+    batch.param = &run_chunk;
+    batch.chunks = &chunks;
+    do_get_worker_pool().run(batch);
+
+    for(const auto& chunk : chunks)
+      if(!chunk.error.empty())
+        ASTERIA_THROW(("Exception on worker thread: $1"), chunk.error);
+  }
+
 }  // namespace
 
 V_array
@@ -642,6 +888,103 @@ std_array_copy_values(V_object source)
     return data;
   }
 
+V_array
+std_array_pmap(Global_Context& global, V_array data, V_function callback)
+  {
+    Parallel_Chunks chunks;
+    do_run_parallel(chunks, global, callback, data,
+      [](Global_Context& wglobal, const V_function& func, const V_array& input, Parallel_Chunk& chunk)
+      {
+        Reference self;
+        Reference_Stack stack;
+        chunk.output.reserve(chunk.end - chunk.begin);
+        for(size_t k = chunk.begin;  k != chunk.end;  ++k) {
+          stack.clear();
+          stack.push().set_temporary(input[k]);
+          self.clear();
+          func.invoke(self, wglobal, move(stack));
+          chunk.output.emplace_back(self.dereference_readonly());
+        }
+      });
+
+    // Concatenate results.
+    V_array result;
+    result.reserve(data.size());
+    for(size_t k = 0;  k != chunks.size();  ++k)
+      result.append(chunks.mut(k).output.move_begin(), chunks.mut(k).output.move_end());
+    return result;
+  }
+
+V_array
+std_array_pfilter(Global_Context& global, V_array data, V_function callback)
+  {
+    Parallel_Chunks chunks;
+    do_run_parallel(chunks, global, callback, data,
+      [](Global_Context& wglobal, const V_function& func, const V_array& input, Parallel_Chunk& chunk)
+      {
+        Reference self;
+        Reference_Stack stack;
+        for(size_t k = chunk.begin;  k != chunk.end;  ++k) {
+          stack.clear();
+          stack.push().set_temporary(input[k]);
+          self.clear();
+          func.invoke(self, wglobal, move(stack));
+          if(self.dereference_readonly().test())
+            chunk.output.emplace_back(input[k]);
+        }
+      });
+
+    // Concatenate results.
+    V_array result;
+    for(size_t k = 0;  k != chunks.size();  ++k)
+      result.append(chunks.mut(k).output.move_begin(), chunks.mut(k).output.move_end());
+    return result;
+  }
+
+Value
+std_array_preduce(Global_Context& global, V_array data, V_function callback, opt<Value> initial)
+  {
+    Parallel_Chunks chunks;
+    do_run_parallel(chunks, global, callback, data,
+      [](Global_Context& wglobal, const V_function& func, const V_array& input, Parallel_Chunk& chunk)
+      {
+        Reference self;
+        Reference_Stack stack;
+        Value acc = input[chunk.begin];
+        for(size_t k = chunk.begin + 1;  k != chunk.end;  ++k) {
+          stack.clear();
+          stack.push().set_temporary(move(acc));
+          stack.push().set_temporary(input[k]);
+          self.clear();
+          func.invoke(self, wglobal, move(stack));
+          acc = self.dereference_readonly();
+        }
+        chunk.output.emplace_back(move(acc));
+      });
+
+    // Combine partial results on this thread. If there is no initial value,
+    // start from the first partial result. An explicit `null` is a valid
+    // initial value.
+    Value acc;
+    size_t k = 0;
+    if(initial)
+      acc = move(*initial);
+    else if(!chunks.empty())
+      acc = move(chunks.mut(k++).output.mut(0));
+
+    Reference self;
+    Reference_Stack stack;
+    while(k != chunks.size()) {
+      stack.clear();
+      stack.push().set_temporary(move(acc));
+      stack.push().set_temporary(move(chunks.mut(k++).output.mut(0)));
+      self.clear();
+      callback.invoke(self, global, move(stack));
+      acc = self.dereference_readonly();
+    }
+    return acc;
+  }
+
 void
 create_bindings_array(V_object& result, API_Version /*version*/)
   {
@@ -1234,6 +1577,64 @@ create_bindings_array(V_object& result, API_Version /*version*/)
 
         reader.throw_no_matching_function_call();
       });
+
+    result.insert_or_assign(&"pmap",
+      ASTERIA_BINDING(
+        "std.array.pmap", "data, callback",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_array data;
+        V_function func;
+
+        reader.start_overload();
+        reader.required(data);
+        reader.required(func);
+        if(reader.end_overload())
+          return (Value) std_array_pmap(global, data, func);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"pfilter",
+      ASTERIA_BINDING(
+        "std.array.pfilter", "data, callback",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_array data;
+        V_function func;
+
+        reader.start_overload();
+        reader.required(data);
+        reader.required(func);
+        if(reader.end_overload())
+          return (Value) std_array_pfilter(global, data, func);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"preduce",
+      ASTERIA_BINDING(
+        "std.array.preduce", "data, callback, [initial]",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_array data;
+        V_function func;
+        Reference init;
+
+        reader.start_overload();
+        reader.required(data);
+        reader.required(func);
+        reader.optional(init);
+        if(reader.end_overload()) {
+          // Distinguish an explicit `null` from an absent argument.
+          opt<Value> qinit;
+          if(!init.is_invalid())
+            qinit = init.dereference_readonly();
+          return (Value) std_array_preduce(global, data, func, move(qinit));
+        }
+
+        reader.throw_no_matching_function_call();
+      });
   }
 
 }  // namespace asteria
@@ -111,6 +111,18 @@ std_array_copy_keys(V_object source);
 V_array
 std_array_copy_values(V_object source);
 
+// `std.array.pmap`
+V_array
+std_array_pmap(Global_Context& global, V_array data, V_function callback);
+
+// `std.array.pfilter`
+V_array
+std_array_pfilter(Global_Context& global, V_array data, V_function callback);
+
+// `std.array.preduce`
+Value
+std_array_preduce(Global_Context& global, V_array data, V_function callback, opt<Value> initial);
+
 // Create an object that is to be referenced as `std.array`.
 void
 create_bindings_array(V_object& result, API_Version version);
@@ -9,6 +9,25 @@
 #include "../runtime/garbage_collector.hpp"
 #include "../utils.hpp"
 namespace asteria {
+namespace {
+
+V_string
+do_policy_name(GC_Policy policy)
+  {
+    switch(policy)
+      {
+      case gc_policy_fixed:
+        return &"fixed";
+
+      case gc_policy_adaptive:
+        return &"adaptive";
+
+      default:
+        ROCKET_ASSERT(false);
+    }
+  }
+
+}  // namespace
 
 V_integer
 std_gc_count_variables(Global_Context& global, V_integer generation)
@@ -56,6 +75,133 @@ std_gc_set_threshold(Global_Context& global, V_integer generation, V_integer thr
     return static_cast<int64_t>(oldval);
   }
 
+V_string
+std_gc_get_policy(Global_Context& global)
+  {
+    const auto gcoll = global.garbage_collector();
+    return do_policy_name(gcoll->get_policy());
+  }
+
+V_string
+std_gc_set_policy(Global_Context& global, V_string policy, optV_real target_overhead)
+  {
+    GC_Policy rpol;
+    if(policy == "fixed")
+      rpol = gc_policy_fixed;
+    else if(policy == "adaptive")
+      rpol = gc_policy_adaptive;
+    else
+      ASTERIA_THROW((
+          "Invalid garbage collection policy `$1`"),
+          policy);
+
+    // Set the policy and return its old value.
+    const auto gcoll = global.garbage_collector();
+    auto oldval = do_policy_name(gcoll->get_policy());
+    gcoll->set_policy(rpol, target_overhead.value_or(0.05));
+    return oldval;
+  }
+
+V_integer
+std_gc_get_incremental_budget(Global_Context& global)
+  {
+    // Get the maximum number of variables that are checked in each step.
+    const auto gcoll = global.garbage_collector();
+    size_t budget = gcoll->get_incremental_budget();
+    return static_cast<int64_t>(budget);
+  }
+
+V_integer
+std_gc_set_incremental_budget(Global_Context& global, V_integer budget)
+  {
+    // Set the budget and return its old value.
+    const auto gcoll = global.garbage_collector();
+    size_t oldval = gcoll->get_incremental_budget();
+    gcoll->set_incremental_budget(::rocket::clamp_cast<size_t>(budget, 0, PTRDIFF_MAX));
+    return static_cast<int64_t>(oldval);
+  }
+
+V_object
+std_gc_get_statistics(Global_Context& global)
+  {
+    const auto gcoll = global.garbage_collector();
+    const auto& stats = gcoll->get_statistics();
+    V_object result;
+
+    V_array gens;
+    for(const auto& gstat : stats.generations) {
+      V_object gen;
+
+      gen.try_emplace(&"collections",
+        V_integer(
+          (int64_t) gstat.collections  // number of collections
+        ));
+
+      gen.try_emplace(&"scanned",
+        V_integer(
+          (int64_t) gstat.scanned  // number of variables that have been traced
+        ));
+
+      gen.try_emplace(&"freed",
+        V_integer(
+          (int64_t) gstat.freed  // number of variables that have been collected
+        ));
+
+      gen.try_emplace(&"promoted",
+        V_integer(
+          (int64_t) gstat.promoted  // number of variables moved to the next generation
+        ));
+
+      gen.try_emplace(&"pool_hits",
+        V_integer(
+          (int64_t) gstat.pool_hits  // number of variables reused from the pool
+        ));
+
+      gen.try_emplace(&"pool_misses",
+        V_integer(
+          (int64_t) gstat.pool_misses  // number of variables allocated anew
+        ));
+
+      gen.try_emplace(&"time_ns",
+        V_integer(
+          (int64_t) gstat.time_ns  // total duration of collections
+        ));
+
+      gens.emplace_back(move(gen));
+    }
+
+    result.try_emplace(&"generations",
+      V_array(
+        move(gens)  // statistics of each generation
+      ));
+
+    result.try_emplace(&"pause_count",
+      V_integer(
+        (int64_t) stats.pause_count  // number of pauses
+      ));
+
+    result.try_emplace(&"pause_total_ns",
+      V_integer(
+        (int64_t) stats.pause_total_ns  // total duration of pauses
+      ));
+
+    result.try_emplace(&"pause_max_ns",
+      V_integer(
+        (int64_t) stats.pause_max_ns  // duration of the longest pause
+      ));
+
+    V_array hist;
+    for(uint64_t count : stats.pause_histogram)
+      hist.emplace_back(V_integer((int64_t) count));
+
+    result.try_emplace(&"pause_histogram",
+      V_array(
+        move(hist)  // number of pauses by binary logarithm of microseconds
+      ));
+
+    return result;
+  }
+
 V_integer
 std_gc_collect(Global_Context& global, optV_integer generation_limit)
   {
@@ -123,6 +269,74 @@ create_bindings_gc(V_object& result, API_Version /*version*/)
         reader.throw_no_matching_function_call();
       });
 
+    result.insert_or_assign(&"get_policy",
+      ASTERIA_BINDING(
+        "std.gc.get_policy", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_gc_get_policy(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"set_policy",
+      ASTERIA_BINDING(
+        "std.gc.set_policy", "policy, [target_overhead]",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_string policy;
+        optV_real target;
+
+        reader.start_overload();
+        reader.required(policy);
+        reader.optional(target);
+        if(reader.end_overload())
+          return (Value) std_gc_set_policy(global, policy, target);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"get_incremental_budget",
+      ASTERIA_BINDING(
+        "std.gc.get_incremental_budget", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_gc_get_incremental_budget(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"set_incremental_budget",
+      ASTERIA_BINDING(
+        "std.gc.set_incremental_budget", "budget",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_integer budget;
+
+        reader.start_overload();
+        reader.required(budget);
+        if(reader.end_overload())
+          return (Value) std_gc_set_incremental_budget(global, budget);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"get_statistics",
+      ASTERIA_BINDING(
+        "std.gc.get_statistics", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_gc_get_statistics(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
     result.insert_or_assign(&"collect",
       ASTERIA_BINDING(
         "std.gc.collect", "[generation_limit]",
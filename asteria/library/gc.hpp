@@ -19,6 +19,26 @@ std_gc_get_threshold(Global_Context& global, V_integer generation);
 V_integer
 std_gc_set_threshold(Global_Context& global, V_integer generation, V_integer threshold);
 
+// `std.gc.get_policy`
+V_string
+std_gc_get_policy(Global_Context& global);
+
+// `std.gc.set_policy`
+V_string
+std_gc_set_policy(Global_Context& global, V_string policy, optV_real target_overhead);
+
+// `std.gc.get_incremental_budget`
+V_integer
+std_gc_get_incremental_budget(Global_Context& global);
+
+// `std.gc.set_incremental_budget`
+V_integer
+std_gc_set_incremental_budget(Global_Context& global, V_integer budget);
+
+// `std.gc.get_statistics`
+V_object
+std_gc_get_statistics(Global_Context& global);
+
 // `std.gc.collect`
 V_integer
 std_gc_collect(Global_Context& global, optV_integer generation_limit);
@@ -6,6 +6,9 @@
 #include "../runtime/argument_reader.hpp"
 #include "../runtime/binding_generator.hpp"
 #include "../utils.hpp"
+#ifdef __GLIBC__
+#  include <stdio_ext.h>  // __fbufsize()
+#endif
 namespace asteria {
 namespace {
 
@@ -118,53 +121,149 @@ do_format_write_utf8_common(const IOF_Sentry& sentry, const V_string& templ, con
     return do_write_utf8_common(sentry, fmt.get_string());
   }
 
+void
+do_enlarge_input_buffer(const IOF_Sentry& sentry) noexcept
+  {
+#ifdef __GLIBC__
+    // The default buffer of a pipe is only 4 KiB. The buffer can be replaced
+    // only before the first read, when glibc has not allocated one yet. This
+    // is protected by the lock of the stream.
+    static char s_buf[65536];
+    static bool s_done;
+
+    if(s_done)
+      return;
+
+    if(::__fbufsize(sentry) == 0)
+      ::setvbuf(sentry, s_buf, _IOFBF, sizeof(s_buf));
+    s_done = true;
+#else
+    (void) sentry;
+#endif
+  }
+
+class Line_Buffer
+  {
+  private:
+    char* m_data = nullptr;
+    size_t m_cap = 0;
+
+  public:
+    Line_Buffer() noexcept = default;
+
+    Line_Buffer(const Line_Buffer&) = delete;
+    Line_Buffer& operator=(const Line_Buffer&) & = delete;
+
+    ~Line_Buffer()
+      {
+        ::free(this->m_data);
+      }
+
+    bool
+    read_line(cow_string& line, const IOF_Sentry& sentry)
+      {
+        // `getline()` searches for the LF in the buffer of the stream, and
+        // copies bytes in blocks.
+        ::ssize_t nread = ::getline(&(this->m_data), &(this->m_cap), sentry);
+        if((nread < 0) && ::ferror(sentry))
+          ASTERIA_THROW((
+              "Error reading standard input",
+              "[`getline()` failed: ${errno:full}]"));
+
+        if(nread < 0)
+          return false;
+
+        size_t len = (size_t) nread;
+        if((len != 0) && (this->m_data[len - 1] == '\n'))
+          len --;
+
+        if(!utf8_validate(this->m_data, len))
+          ASTERIA_THROW((
+              "Invalid UTF-8 string from standard input"));
+
+        line.assign(this->m_data, len);
+        return true;
+      }
+  };
+
+// This buffer is reused by all calls. It is protected by the lock of `stdin`,
+// so it shall only be used while an `IOF_Sentry` is alive.
+Line_Buffer s_stdin_line_buf;
+
 }  // namespace
 
 optV_integer
 std_io_getc()
   {
-    wint_t wch;
-    const IOF_Sentry sentry(stdin, iof_mode_input_wide);
+    char u8str[4];
+    size_t u8len;
+    const IOF_Sentry sentry(stdin, iof_mode_input_narrow);
 
-    wch = ::fgetwc(sentry);
-    if((wch == WEOF) && ::ferror(sentry))
+    int ch = ::getc_unlocked(sentry);
+    if((ch == EOF) && ::ferror(sentry))
       ASTERIA_THROW((
           "Error reading standard input",
-          "[`fgetwc()` failed: ${errno:full}]"));
+          "[`getc_unlocked()` failed: ${errno:full}]"));
 
-    if(wch == WEOF)
+    if(ch == EOF)
       return nullopt;
 
-    return (int64_t)(uint32_t) wch;
+    // Read trailing bytes of this code point, if any.
+    u8str[0] = (char) ch;
+    u8len = 1;
+    if(((uint8_t) ch >= 0xC0U) && ((uint8_t) ch < 0xF8U)) {
+      size_t total = 2U + ((uint8_t) ch >= 0xE0U) + ((uint8_t) ch >= 0xF0U);
+      while((u8len < total) && ((ch = ::getc_unlocked(sentry)) != EOF))
+        u8str[u8len++] = (char) ch;
+
+      if((ch == EOF) && ::ferror(sentry))
+        ASTERIA_THROW((
+            "Error reading standard input",
+            "[`getc_unlocked()` failed: ${errno:full}]"));
+    }
+
+    char32_t cp;
+    const char* pos = u8str;
+    if(!utf8_decode(cp, pos, u8len) || (pos != u8str + u8len))
+      ASTERIA_THROW((
+          "Invalid UTF-8 sequence from standard input"));
+
+    return (int64_t) cp;
   }
 
 optV_string
 std_io_getln()
   {
-    cow_string u8str;
-    wint_t wch;
-    const IOF_Sentry sentry(stdin, iof_mode_input_wide);
+    cow_string line;
+    const IOF_Sentry sentry(stdin, iof_mode_input_narrow);
+    do_enlarge_input_buffer(sentry);
 
-    for(;;) {
-      wch = ::fgetwc(sentry);
-      if((wch == WEOF) && ::ferror(sentry))
-        ASTERIA_THROW((
-            "Error reading standard input",
-            "[`fgetwc()` failed: ${errno:full}]"));
+    if(!s_stdin_line_buf.read_line(line, sentry))
+      return nullopt;
+
+    return move(line);
+  }
+
+optV_array
+std_io_getlns(optV_integer limit)
+  {
+    const size_t nmax = ::rocket::clamp_cast<size_t>(limit.value_or(INT_MAX), 0, INT_MAX);
+    V_array lines;
+    cow_string line;
+    const IOF_Sentry sentry(stdin, iof_mode_input_narrow);
+    do_enlarge_input_buffer(sentry);
 
-      if((wch == L'\n') || (wch == WEOF))
+    while(lines.size() < nmax) {
+      if(!s_stdin_line_buf.read_line(line, sentry))
         break;
 
-      if(!utf8_encode(u8str, (char32_t) wch))
-        ASTERIA_THROW((
-            "Invalid UTF code point from standard input (value `$1`)"),
-            wch);
+      lines.emplace_back(move(line));
     }
 
-    if((wch == WEOF) && u8str.empty())
+    if((nmax != 0) && lines.empty())
       return nullopt;
 
-    return move(u8str);
+    return move(lines);
   }
 
 optV_integer
@@ -326,6 +425,21 @@ create_bindings_io(V_object& result, API_Version /*version*/)
         reader.throw_no_matching_function_call();
       });
 
+    result.insert_or_assign(&"getlns",
+      ASTERIA_BINDING(
+        "std.io.getlns", "[limit]",
+        Argument_Reader&& reader)
+      {
+        optV_integer limit;
+
+        reader.start_overload();
+        reader.optional(limit);
+        if(reader.end_overload())
+          return (Value) std_io_getlns(limit);
+
+        reader.throw_no_matching_function_call();
+      });
+
     result.insert_or_assign(&"putc",
       ASTERIA_BINDING(
         "std.io.putc", "value",
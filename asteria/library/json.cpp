@@ -6,10 +6,16 @@
 #include "../runtime/argument_reader.hpp"
 #include "../runtime/binding_generator.hpp"
 #include "../runtime/global_context.hpp"
-#include "../compiler/token_stream.hpp"
-#include "../compiler/compiler_error.hpp"
-#include "../compiler/enums.hpp"
+#include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
 namespace asteria {
 namespace {
 
@@ -19,7 +25,11 @@ struct Indenter
 
     virtual
     void
-    break_line(tinyfmt& fmt) const = 0;
+    break_line(cow_string& str) const = 0;
+
+    virtual
+    size_t
+    break_size() const noexcept = 0;
 
     virtual
     void
@@ -46,10 +56,16 @@ struct Indenter_none : Indenter
       }
 
     void
-    break_line(tinyfmt& /*fmt*/) const override
+    break_line(cow_string& /*str*/) const override
       {
       }
 
+    size_t
+    break_size() const noexcept override
+      {
+        return 0;
+      }
+
     void
     increment_level() override
       {
@@ -79,9 +95,15 @@ struct Indenter_string : Indenter
       }
 
     void
-    break_line(tinyfmt& fmt) const override
+    break_line(cow_string& str) const override
       {
-        fmt << this->cur;
+        str.append(this->cur);
+      }
+
+    size_t
+    break_size() const noexcept override
+      {
+        return this->cur.size();
       }
 
     void
@@ -115,30 +137,23 @@ struct Indenter_spaces : Indenter
       }
 
     void
-    break_line(tinyfmt& fmt) const override
+    break_line(cow_string& str) const override
       {
-        static constexpr char s_spaces[] =
-          {
-#define do_spaces_8_   ' ',' ',' ',' ',' ',' ',' ',' ',
-#define do_spaces_32_  do_spaces_8_ do_spaces_8_ do_spaces_8_ do_spaces_8_
-            do_spaces_32_ do_spaces_32_ do_spaces_32_ do_spaces_32_
-            do_spaces_32_ do_spaces_32_ do_spaces_32_ do_spaces_32_
-          };
-
         // When `step` is zero, separate fields with a single space.
         if(ROCKET_EXPECT(this->add == 0)) {
-          fmt << s_spaces[0];
+          str.push_back(' ');
           return;
         }
 
         // Otherwise, terminate the current line, and indent the next.
-        fmt << '\n';
-        size_t nrem = this->cur;
-        while(nrem != 0) {
-          size_t nslen = ::rocket::min(nrem, sizeof(s_spaces));
-          nrem -= nslen;
-          fmt.putn(s_spaces, nslen);
-        }
+        str.push_back('\n');
+        str.append(this->cur, ' ');
+      }
+
+    size_t
+    break_size() const noexcept override
+      {
+        return (this->add == 0) ? 1 : (1 + this->cur);
       }
 
     void
@@ -160,59 +175,108 @@ struct Indenter_spaces : Indenter
       }
   };
 
+const char*
+do_find_escapable(const char* sptr, const char* eptr) noexcept
+  {
+    // Find the first character that can't be written verbatim, which is a
+    // double quote, a backslash, a control character, DEL or a non-ASCII
+    // character. Plain characters are checked in blocks.
+#ifdef __AVX2__
+    while(eptr - sptr >= 32) {
+      __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sptr));
+      __m256i m = _mm256_cmpeq_epi8(t, _mm256_set1_epi8('\"'));
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi8(t, _mm256_set1_epi8('\\')));
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi8(t, _mm256_set1_epi8(0x7F)));
+      m = _mm256_or_si256(m, _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), t));
+      uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+      if(bits != 0)
+        return sptr + ROCKET_TZCNT32(bits);
+      sptr += 32;
+    }
+#endif
+#ifdef __SSE2__
+    while(eptr - sptr >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sptr));
+      __m128i m = _mm_cmpeq_epi8(t, _mm_set1_epi8('\"'));
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(t, _mm_set1_epi8('\\')));
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(t, _mm_set1_epi8(0x7F)));
+      m = _mm_or_si128(m, _mm_cmplt_epi8(t, _mm_set1_epi8(0x20)));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m));
+      if(bits != 0)
+        return sptr + ROCKET_TZCNT32(bits);
+      sptr += 16;
+    }
+#endif
+    while((sptr != eptr) && (*sptr != '\"') && (*sptr != '\\') && (*sptr != 0x7F)
+          && (static_cast<int8_t>(*sptr) >= 0x20))
+      sptr ++;
+    return sptr;
+  }
+
 void
-do_quote_string(tinyfmt& fmt, cow_stringR str)
+do_quote_string(cow_string& str, cow_stringR src)
   {
     // Although JavaScript uses UCS-2 rather than UTF-16, the JSON
     // specification adopts UTF-16.
-    fmt << '\"';
-    size_t offset = 0;
-    while(offset < str.size()) {
-      // Convert UTF-8 to UTF-16.
-      char32_t cp;
-      if(!utf8_decode(cp, str, offset)) {
-        cp = 0xFFFD;
-        offset ++;
-      }
+    str.push_back('\"');
+    const char* bptr = src.data();
+    const char* eptr = bptr + src.size();
+    for(;;) {
+      // Copy plain characters in a run.
+      const char* sptr = do_find_escapable(bptr, eptr);
+      str.append(bptr, static_cast<size_t>(sptr - bptr));
+      bptr = sptr;
+      if(bptr == eptr)
+        break;
 
       // Escape double quotes, backslashes, and control characters.
-      switch(cp)
+      switch(*bptr)
         {
         case '\"':
-          fmt << "\\\"";
+          str.append("\\\"", 2);
+          bptr ++;
           break;
 
         case '\\':
-          fmt << "\\\\";
+          str.append("\\\\", 2);
+          bptr ++;
           break;
 
         case '\b':
-          fmt << "\\b";
+          str.append("\\b", 2);
+          bptr ++;
           break;
 
         case '\f':
-          fmt << "\\f";
+          str.append("\\f", 2);
+          bptr ++;
           break;
 
         case '\n':
-          fmt << "\\n";
+          str.append("\\n", 2);
+          bptr ++;
           break;
 
         case '\r':
-          fmt << "\\r";
+          str.append("\\r", 2);
+          bptr ++;
           break;
 
         case '\t':
-          fmt << "\\t";
+          str.append("\\t", 2);
+          bptr ++;
           break;
 
         default:
           {
-            if((0x20 <= cp) && (cp <= 0x7E)) {
-              // Write printable characters as is.
-              fmt << (char) cp;
-              break;
+            // Convert UTF-8 to UTF-16. An invalid byte is replaced.
+            char32_t cp;
+            const char* tptr = bptr;
+            if(!utf8_decode(cp, tptr, static_cast<size_t>(eptr - bptr))) {
+              cp = 0xFFFD;
+              tptr = bptr + 1;
             }
+            bptr = tptr;
 
             // Encode the character in UTF-16.
             char16_t ustr[2];
@@ -220,36 +284,117 @@ do_quote_string(tinyfmt& fmt, cow_stringR str)
             utf16_encode(epos, cp);
 
             // Write code units.
-            ::rocket::ascii_numput nump;
+            static constexpr char s_xdigits[] = "0123456789ABCDEF";
             for(auto p = ustr;  p != epos;  ++p) {
-              nump.put_XU(*p, 4);
-              char seq[8] = { "\\u" };
-              ::memcpy(seq + 2, nump.data() + 2, 4);
-              fmt.putn(seq, 6);
+              char seq[6] = { '\\', 'u', s_xdigits[*p >> 12 & 15], s_xdigits[*p >> 8 & 15],
+                              s_xdigits[*p >> 4 & 15], s_xdigits[*p & 15] };
+              str.append(seq, 6);
             }
             break;
           }
       }
     }
-    fmt << '\"';
+    str.push_back('\"');
+  }
+
+size_t
+do_estimate_quoted_size(cow_stringR src)
+  {
+    // Calculate the length of the string after it has been quoted by
+    // `do_quote_string()`, including escape sequences.
+    size_t total = src.size() + 2;
+    const char* bptr = src.data();
+    const char* eptr = bptr + src.size();
+    for(;;) {
+      bptr = do_find_escapable(bptr, eptr);
+      if(bptr == eptr)
+        break;
+
+      if(::rocket::is_any_of(*bptr, { '\"', '\\', '\b', '\f', '\n', '\r', '\t' })) {
+        // This is replaced with two characters.
+        total += 1;
+        bptr ++;
+        continue;
+      }
+
+      // This is replaced with one or two UTF-16 code units, six characters
+      // for each.
+      char32_t cp;
+      const char* tptr = bptr;
+      if(!utf8_decode(cp, tptr, static_cast<size_t>(eptr - bptr))) {
+        cp = 0xFFFD;
+        tptr = bptr + 1;
+      }
+      total += ((cp >= 0x10000) ? 12U : 6U) - static_cast<size_t>(tptr - bptr);
+      bptr = tptr;
+    }
+    return total;
+  }
+
+bool
+do_is_json5_key(cow_stringR name)
+  {
+    return name.size() && is_cmask(name[0], cmask_namei)
+           && ::std::all_of(name.begin() + 1, name.end(),
+                 [](char c) { return is_cmask(c, cmask_namei | cmask_digit);  });
+  }
+
+size_t
+do_estimate_object_key_size(bool json5, cow_stringR name)
+  {
+    // The colon may be followed by a space.
+    if(json5 && do_is_json5_key(name))
+      return name.size() + 2;
+    else
+      return do_estimate_quoted_size(name) + 2;
   }
 
 void
-do_format_object_key(tinyfmt& fmt, bool json5, const Indenter& indent, cow_stringR name)
+do_format_object_key(cow_string& str, bool json5, const Indenter& indent, cow_stringR name)
   {
     // Write the key.
-    if(json5 && name.size() && is_cmask(name[0], cmask_namei)
-         && ::std::all_of(name.begin() + 1, name.end(),
-               [](char c) { return is_cmask(c, cmask_namei | cmask_digit);  }))
-      fmt << name;
+    if(json5 && do_is_json5_key(name))
+      str.append(name);
     else
-      do_quote_string(fmt, name);
+      do_quote_string(str, name);
 
     // Write the colon.
     if(indent.has_indention())
-      fmt << ": ";
+      str.append(": ", 2);
+    else
+      str.push_back(':');
+  }
+
+void
+do_format_number(cow_string& str, const Value& value, bool json5)
+  {
+    // Integers that can be represented exactly are written without the
+    // detour via `double`, and produce the same result.
+    ::rocket::ascii_numput nump;
+    if(value.is_integer()) {
+      V_integer ival = value.as_integer();
+      if((ival > -1000000000000000) && (ival < 1000000000000000))
+        nump.put_DI(ival);
+      else
+        nump.put_DD(static_cast<double>(ival));
+      str.append(nump.data(), nump.size());
+      return;
+    }
+
+    // Write the real number in decimal. JSON5 allows infinities and NaN;
+    // otherwise they are replaced with nulls.
+    double rval = value.as_real();
+    int cls = ::std::fpclassify(rval);
+    if((cls == FP_ZERO) || (cls == FP_NORMAL) || (cls == FP_SUBNORMAL)) {
+      nump.put_DD(rval);
+      str.append(nump.data(), nump.size());
+    }
+    else if((cls == FP_NAN) && json5)
+      str.append("NaN", 3);
+    else if((cls == FP_INFINITE) && json5)
+      str.append("-Infinity" + !::std::signbit(rval));
     else
-      fmt << ':';
+      str.append("null", 4);
   }
 
 bool
@@ -280,11 +425,118 @@ struct Xformat_object
 
 using Xformat = ::rocket::variant<Xformat_array, Xformat_object>;
 
+size_t
+do_estimate_size_nonrecursive(const Value& value, bool json5, Indenter& indent)
+  {
+    // This walks the value in the same way as `do_format_nonrecursive()`,
+    // but only counts characters, so the output can be allocated once. The
+    // lengths of strings include escape sequences, and the lengths of real
+    // numbers are upper bounds.
+    size_t total = 0;
+    auto qval = &value;
+    cow_vector<Xformat> stack;
+
+  estimate_next:
+    if(qval->is_boolean())
+      total += 5;
+    else if(qval->is_integer()) {
+      // Large integers are written as real numbers.
+      V_integer ival = qval->as_integer();
+      if((ival <= -1000000000000000) || (ival >= 1000000000000000))
+        total += 24;
+      else {
+        uint64_t uval = static_cast<uint64_t>(ival);
+        if(ival < 0)
+          uval = -uval, total ++;
+        do
+          uval /= 10, total ++;
+        while(uval != 0);
+      }
+    }
+    else if(qval->is_real())
+      total += 24;
+    else if(qval->is_string())
+      total += do_estimate_quoted_size(qval->as_string());
+    else if(qval->is_array()) {
+      const auto& array = qval->as_array();
+      Xformat_array ctxa = { &array, array.begin() };
+      if(ctxa.curp != array.end()) {
+        indent.increment_level();
+        total += 1 + indent.break_size();
+
+        qval = &*(ctxa.curp);
+        stack.emplace_back(move(ctxa));
+        goto estimate_next;
+      }
+      total += 2;
+    }
+    else if(qval->is_object()) {
+      const auto& object = qval->as_object();
+      Xformat_object ctxo = { &object, object.begin() };
+      if(do_find_uncensored(ctxo.curp, object)) {
+        indent.increment_level();
+        total += 1 + indent.break_size();
+        total += do_estimate_object_key_size(json5, ctxo.curp->first);
+
+        qval = &(ctxo.curp->second);
+        stack.emplace_back(move(ctxo));
+        goto estimate_next;
+      }
+      total += 2;
+    }
+    else
+      total += 4;
+
+    while(stack.size()) {
+      auto& ctx = stack.mut_back();
+      switch(ctx.index())
+        {
+        case 0:
+          {
+            auto& ctxa = ctx.mut<0>();
+            ++ ctxa.curp;
+            if(ctxa.curp != ctxa.refa->end()) {
+              total += 1 + indent.break_size();
+              qval = &*(ctxa.curp);
+              goto estimate_next;
+            }
+            break;
+          }
+
+        case 1:
+          {
+            auto& ctxo = ctx.mut<1>();
+            if(do_find_uncensored(++(ctxo.curp), *(ctxo.refo))) {
+              total += 1 + indent.break_size();
+              total += do_estimate_object_key_size(json5, ctxo.curp->first);
+              qval = &(ctxo.curp->second);
+              goto estimate_next;
+            }
+            break;
+          }
+
+        default:
+          ROCKET_ASSERT(false);
+      }
+
+      // Close this array or object.
+      total += json5 && indent.has_indention();
+      indent.decrement_level();
+      total += indent.break_size() + 1;
+      stack.pop_back();
+    }
+
+    return total;
+  }
+
 V_string
 do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
   {
+    // Reserve storage for the result, so it will not be reallocated.
+    V_string str;
+    str.reserve(do_estimate_size_nonrecursive(value, json5, indent));
+
     // Transform recursion to iteration using a handwritten stack.
-    ::rocket::tinyfmt_str fmt;
     auto qval = &value;
     cow_vector<Xformat> stack;
 
@@ -292,59 +544,52 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
   format_next:
     if(qval->is_boolean()) {
       // Write `true` or `false`.
-      fmt << qval->as_boolean();
+      if(qval->as_boolean())
+        str.append("true", 4);
+      else
+        str.append("false", 5);
     }
     else if(qval->is_real()) {
-      // Write the real number in decimal. JSON5 allows infinities and NaN;
-      // otherwise they are replaced with nulls.
-      double rval = qval->as_real();
-      int cls = ::std::fpclassify(rval);
-      if((cls == FP_ZERO) || (cls == FP_NORMAL) || (cls == FP_SUBNORMAL))
-        fmt << rval;
-      else if((cls == FP_NAN) && json5)
-        fmt << "NaN";
-      else if((cls == FP_INFINITE) && json5)
-        fmt << ("-Infinity" + !::std::signbit(rval));
-      else
-        fmt << "null";
+      // Write the number in decimal.
+      do_format_number(str, *qval, json5);
     }
     else if(qval->is_string()) {
       // Write the string in double quotes.
-      do_quote_string(fmt, qval->as_string());
+      do_quote_string(str, qval->as_string());
     }
     else if(qval->is_array()) {
       const auto& array = qval->as_array();
       Xformat_array ctxa = { &array, array.begin() };
       if(ctxa.curp != array.end()) {
         // Open an array.
-        fmt << '[';
+        str.push_back('[');
         indent.increment_level();
-        indent.break_line(fmt);
+        indent.break_line(str);
 
         qval = &*(ctxa.curp);
         stack.emplace_back(move(ctxa));
         goto format_next;
       }
-      fmt << "[]";
+      str.append("[]", 2);
     }
     else if(qval->is_object()) {
       const auto& object = qval->as_object();
       Xformat_object ctxo = { &object, object.begin() };
       if(do_find_uncensored(ctxo.curp, object)) {
         // Open an object.
-        fmt << '{';
+        str.push_back('{');
         indent.increment_level();
-        indent.break_line(fmt);
-        do_format_object_key(fmt, json5, indent, ctxo.curp->first);
+        indent.break_line(str);
+        do_format_object_key(str, json5, indent, ctxo.curp->first);
 
         qval = &(ctxo.curp->second);
         stack.emplace_back(move(ctxo));
         goto format_next;
       }
-      fmt << "{}";
+      str.append("{}", 2);
     }
     else
-      fmt << "null";
+      str.append("null", 4);
 
     while(stack.size()) {
       // Advance to the next element.
@@ -356,8 +601,8 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
             auto& ctxa = ctx.mut<0>();
             ++ ctxa.curp;
             if(ctxa.curp != ctxa.refa->end()) {
-              fmt << ',';
-              indent.break_line(fmt);
+              str.push_back(',');
+              indent.break_line(str);
 
               // Format the next element.
               qval = &*(ctxa.curp);
@@ -366,11 +611,11 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
 
             // Close this array.
             if(json5 && indent.has_indention())
-              fmt << ',';
+              str.push_back(',');
 
             indent.decrement_level();
-            indent.break_line(fmt);
-            fmt << ']';
+            indent.break_line(str);
+            str.push_back(']');
             break;
           }
 
@@ -378,9 +623,9 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
           {
             auto& ctxo = ctx.mut<1>();
             if(do_find_uncensored(++(ctxo.curp), *(ctxo.refo))) {
-              fmt << ',';
-              indent.break_line(fmt);
-              do_format_object_key(fmt, json5, indent, ctxo.curp->first);
+              str.push_back(',');
+              indent.break_line(str);
+              do_format_object_key(str, json5, indent, ctxo.curp->first);
 
               // Format the next value.
               qval = &(ctxo.curp->second);
@@ -389,11 +634,11 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
 
             // Close this object.
             if(json5 && indent.has_indention())
-              fmt << ',';
+              str.push_back(',');
 
             indent.decrement_level();
-            indent.break_line(fmt);
-            fmt << '}';
+            indent.break_line(str);
+            str.push_back('}');
             break;
           }
 
@@ -404,7 +649,7 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter& indent)
       stack.pop_back();
     }
 
-    return fmt.extract_string();
+    return str;
   }
 
 V_string
@@ -413,239 +658,988 @@ do_format_nonrecursive(const Value& value, bool json5, Indenter&& indent)
     return do_format_nonrecursive(value, json5, indent);
   }
 
-opt<Punctuator>
-do_accept_punctuator_opt(Token_Stream& tstrm, initializer_list<Punctuator> accept)
-  {
-    auto qtok = tstrm.peek_opt();
-    if(!qtok)
-      return nullopt;
-
-    if(!qtok->is_punctuator())
-      return nullopt;
-
-    auto punct = qtok->as_punctuator();
-    if(::rocket::is_none_of(punct, accept))
-      return nullopt;
-
-    tstrm.shift();
-    return punct;
-  }
-
 struct Xparse_array
   {
     V_array arr;
+    V_integer index = 0;
   };
 
 struct Xparse_object
   {
     V_object obj;
     phsh_string key;
-    Source_Location key_sloc;
   };
 
 using Xparse = ::rocket::variant<Xparse_array, Xparse_object>;
 
-void
-do_accept_object_key(Xparse_object& ctxo, Token_Stream& tstrm)
+const char*
+do_find_string_special(const char* sptr, const char* eptr, char head) noexcept
   {
-    auto qtok = tstrm.peek_opt();
-    if(!qtok)
-      throw Compiler_Error(xtc_status,
-                compiler_status_closing_brace_or_json5_key_expected, tstrm.next_sloc());
+    // Find the first character in a string literal that needs attention, which
+    // is the closing quote, a backslash, a control character or a non-ASCII
+    // character. Plain characters are checked in blocks.
+#ifdef __AVX2__
+    while(eptr - sptr >= 32) {
+      __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sptr));
+      __m256i m = _mm256_cmpeq_epi8(t, _mm256_set1_epi8(head));
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi8(t, _mm256_set1_epi8('\\')));
+      m = _mm256_or_si256(m, _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), t));
+      uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+      if(bits != 0)
+        return sptr + ROCKET_TZCNT32(bits);
+      sptr += 32;
+    }
+#endif
+#ifdef __SSE2__
+    while(eptr - sptr >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sptr));
+      __m128i m = _mm_cmpeq_epi8(t, _mm_set1_epi8(head));
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(t, _mm_set1_epi8('\\')));
+      m = _mm_or_si128(m, _mm_cmplt_epi8(t, _mm_set1_epi8(0x20)));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m));
+      if(bits != 0)
+        return sptr + ROCKET_TZCNT32(bits);
+      sptr += 16;
+    }
+#endif
+    while((sptr != eptr) && (*sptr != head) && (*sptr != '\\') && (static_cast<int8_t>(*sptr) >= 0x20))
+      sptr ++;
+    return sptr;
+  }
 
-    if(qtok->is_identifier())
-      ctxo.key = qtok->as_identifier();
-    else if(qtok->is_string_literal())
-      ctxo.key = qtok->as_string_literal();
-    else
-      throw Compiler_Error(xtc_status,
-                compiler_status_closing_brace_or_json5_key_expected, tstrm.next_sloc());
+int
+do_xdigit_value(char c) noexcept
+  {
+    uint32_t dval = static_cast<uint8_t>(c) | 0x20U;
+    return static_cast<int>((dval <= '9') ? (dval - '0') : (dval - 'a' + 10));
+  }
 
-    ctxo.key_sloc = qtok->sloc();
-    tstrm.shift();
+class JSON_Parser
+  {
+  private:
+    enum Expect : uint8_t
+      {
+        expect_value           = 0,  // a value
+        expect_value_or_close  = 1,  // a value or `]`
+        expect_key_or_close    = 2,  // a key or `}`
+        expect_colon           = 3,  // `:`
+        expect_comma_or_close  = 4,  // `,`, or `]` or `}`
+        expect_end             = 5,  // nothing but spaces and comments
+      };
+
+    // Values at `m_depth` are moved into `m_emitted` with their keys, instead
+    // of being stored into their parents. If `m_ndjson` is set, documents are
+    // separated by line breaks.
+    int64_t m_depth;
+    bool m_ndjson;
+    cow_vector<pair<Value, Value>> m_emitted;
+
+    cow_vector<Xparse> m_stack;
+    Value m_value;
+    Expect m_expect = expect_value;
+    bool m_bom_done = false;
+    int64_t m_end_line = 0;
+
+    // A token that straddles two chunks is saved here, and is parsed again
+    // when more characters arrive. To avoid scanning a long token again for
+    // every small chunk, it is not parsed again until `m_pend` has grown to
+    // `m_pend_retry` characters.
+    cow_string m_pend;
+    size_t m_pend_retry = 0;
+
+    // These are used for error reporting. `m_offset` is the offset of the
+    // first character that has not been consumed.
+    const char* m_bptr = nullptr;
+    int64_t m_offset = 0;
+    int64_t m_line = 1;
+    int64_t m_line_offset = 0;
+
+  public:
+    explicit JSON_Parser(int64_t depth = -1, bool ndjson = false) noexcept
+      :
+        m_depth(depth), m_ndjson(ndjson)
+      { }
+
+  private:
+    int64_t
+    do_offset_of(const char* sptr) const noexcept
+      {
+        return this->m_offset + (sptr - this->m_bptr);
+      }
 
-    auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_colon });
-    if(!kpunct)
-      throw Compiler_Error(xtc_status,
-                compiler_status_colon_expected, tstrm.next_sloc());
-  }
+    [[noreturn]]
+    void
+    do_throw_error(const char* sptr, const char* msg) const
+      {
+        ASTERIA_THROW((
+            "$1 at line $2, column $3"),
+            msg, this->m_line, this->do_offset_of(sptr) - this->m_line_offset + 1);
+      }
 
-Value
-do_parse_nonrecursive(Token_Stream& tstrm)
-  {
-    // Implement a non-recursive descent parser.
-    Value value;
-    cow_vector<Xparse> stack;
-
-    // Accept a value. No other things such as closed brackets are allowed.
-  parse_next:
-    auto qtok = tstrm.peek_opt();
-    if(!qtok)
-      throw Compiler_Error(xtc_format,
-                compiler_status_expression_expected, tstrm.next_sloc(),
-                "Value expected");
-
-    if(qtok->is_punctuator()) {
-      // Accept an `[` or `{`.
-      if(qtok->as_punctuator() == punctuator_bracket_op) {
-        tstrm.shift();
-
-        auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_bracket_cl });
-        if(!kpunct) {
-          stack.emplace_back(Xparse_array());
-          goto parse_next;
+    const char*
+    do_incomplete_opt(const char* sptr, bool final, const char* msg) const
+      {
+        // If this is the last chunk, no more characters will come.
+        if(final)
+          this->do_throw_error(sptr, msg);
+        return nullptr;
+      }
+
+    const char*
+    do_skip_spaces(const char* sptr, const char* eptr)
+      {
+        // Line breaks are counted for error reporting.
+#ifdef __AVX2__
+        while(eptr - sptr >= 32) {
+          __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sptr));
+          __m256i w = _mm256_cmpeq_epi8(t, _mm256_set1_epi8(' '));
+          w = _mm256_or_si256(w, _mm256_and_si256(_mm256_cmpgt_epi8(t, _mm256_set1_epi8('\t' - 1)),
+                                                  _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), t)));
+          uint32_t wbits = static_cast<uint32_t>(_mm256_movemask_epi8(w));
+          uint32_t lbits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(t, _mm256_set1_epi8('\n'))));
+          uint32_t n = ROCKET_TZCNT32(~wbits);
+          this->do_count_lines(sptr, lbits & (uint32_t) ((1ULL << n) - 1));
+          sptr += n;
+          if(n != 32)
+            return sptr;
         }
+#endif
+#ifdef __SSE2__
+        while(eptr - sptr >= 16) {
+          __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sptr));
+          __m128i w = _mm_cmpeq_epi8(t, _mm_set1_epi8(' '));
+          w = _mm_or_si128(w, _mm_and_si128(_mm_cmpgt_epi8(t, _mm_set1_epi8('\t' - 1)),
+                                            _mm_cmplt_epi8(t, _mm_set1_epi8('\r' + 1))));
+          uint32_t wbits = static_cast<uint32_t>(_mm_movemask_epi8(w));
+          uint32_t lbits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(t, _mm_set1_epi8('\n'))));
+          uint32_t n = ROCKET_TZCNT32(~wbits);
+          this->do_count_lines(sptr, lbits & ((1U << n) - 1));
+          sptr += n;
+          if(n != 16)
+            return sptr;
+        }
+#endif
+        while((sptr != eptr) && is_cmask(*sptr, cmask_space)) {
+          if(*sptr == '\n')
+            this->do_count_lines(sptr, 1);
+          sptr ++;
+        }
+        return sptr;
+      }
+
+    void
+    do_count_lines(const char* sptr, uint32_t lbits) noexcept
+      {
+        // Each bit in `lbits` denotes a line feed after `sptr`.
+        if(lbits == 0)
+          return;
+
+        this->m_line_offset = this->do_offset_of(sptr) + 32 - ROCKET_LZCNT32(lbits);
+        while(lbits != 0) {
+          lbits &= lbits - 1;
+          this->m_line ++;
+        }
+      }
 
-        // Accept an empty array.
-        value = V_array();
+    void
+    do_check_comment(const char* sptr, const char* eptr) const
+      {
+        // Comments are not copied, but they shall still be valid UTF-8.
+        const char* tptr = sptr;
+        while(tptr != eptr)
+          if(static_cast<uint8_t>(*tptr) < 0x80)
+            tptr ++;
+          else {
+            char32_t cp;
+            const char* pptr = tptr;
+            if(!utf8_decode(cp, pptr, (size_t) (eptr - tptr)))
+              this->do_throw_error(tptr, "Invalid UTF-8 sequence");
+            tptr = pptr;
+          }
       }
-      else if(qtok->as_punctuator() == punctuator_brace_op) {
-        tstrm.shift();
 
-        auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl });
-        if(!kpunct) {
-          stack.emplace_back(Xparse_object());
-          do_accept_object_key(stack.mut_back().mut<Xparse_object>(), tstrm);
-          goto parse_next;
+    const char*
+    do_skip_comment_opt(const char* sptr, const char* eptr, bool final)
+      {
+        // A comment is consumed only if it is complete.
+        if(eptr - sptr < 2)
+          return this->do_incomplete_opt(sptr, final, "Invalid character");
+
+        const char* tptr;
+        if(sptr[1] == '/') {
+          tptr = static_cast<const char*>(::memchr(sptr + 2, '\n', (size_t) (eptr - sptr - 2)));
+          if(!tptr) {
+            if(!final)
+              return nullptr;
+            tptr = eptr;
+          }
+          this->do_check_comment(sptr + 2, tptr);
+          return tptr;
         }
+        else if(sptr[1] == '*') {
+          tptr = static_cast<const char*>(::memmem(sptr + 2, (size_t) (eptr - sptr - 2), "*/", 2));
+          if(!tptr)
+            return this->do_incomplete_opt(sptr, final, "Block comment unclosed");
+
+          this->do_check_comment(sptr + 2, tptr);
 
-        // Accept an empty object.
-        value = V_object();
+          for(auto p = sptr + 2;  p != tptr;  ++p)
+            if(*p == '\n')
+              this->do_count_lines(p, 1);
+          return tptr + 2;
+        }
+        else
+          this->do_throw_error(sptr, "Invalid character");
       }
-      else
-        throw Compiler_Error(xtc_format,
-                  compiler_status_expression_expected, tstrm.next_sloc(),
-                  "Value expected");
-    }
-    else if(qtok->is_identifier()) {
-      // Accept a literal.
-      if(qtok->as_identifier() == "null") {
-        tstrm.shift();
-        value = nullopt;
+
+    const char*
+    do_scan_string_opt(cow_string& str, const char* sptr, const char* eptr, bool final) const
+      {
+        // Both single and double quotes are allowed, and escape sequences are
+        // processed in both cases.
+        char head = *sptr;
+        const char* tptr = sptr + 1;
+        for(;;) {
+          const char* pptr = do_find_string_special(tptr, eptr, head);
+          str.append(tptr, pptr);
+          tptr = pptr;
+          if(tptr == eptr)
+            return this->do_incomplete_opt(sptr, final, "String unclosed");
+
+          char c = *tptr;
+          if(c == head)
+            return tptr + 1;
+
+          if(c == '\n')
+            this->do_throw_error(sptr, "String unclosed");
+
+          if(c == 0)
+            this->do_throw_error(tptr, "Null character disallowed");
+
+          if(static_cast<uint8_t>(c) >= 0x80) {
+            // Validate a UTF-8 sequence, which may be truncated at the end of
+            // this chunk.
+            char32_t cp;
+            pptr = tptr;
+            if(!utf8_decode(cp, pptr, (size_t) (eptr - tptr))) {
+              if(eptr - tptr < 4)
+                return this->do_incomplete_opt(tptr, final, "Invalid UTF-8 sequence");
+              this->do_throw_error(tptr, "Invalid UTF-8 sequence");
+            }
+            str.append(tptr, pptr);
+            tptr = pptr;
+            continue;
+          }
+
+          if(c != '\\') {
+            // Other control characters are copied as is.
+            str.push_back(c);
+            tptr ++;
+            continue;
+          }
+
+          // Translate an escape sequence.
+          if(eptr - tptr < 2)
+            return this->do_incomplete_opt(tptr, final, "Escape sequence incomplete");
+
+          int xcnt = 0;
+          switch(tptr[1])
+            {
+            case '\'':
+            case '\"':
+            case '\\':
+            case '?':
+            case '/':
+              str.push_back(tptr[1]);
+              break;
+
+            case 'a':
+              str.push_back('\a');
+              break;
+
+            case 'b':
+              str.push_back('\b');
+              break;
+
+            case 'f':
+              str.push_back('\f');
+              break;
+
+            case 'n':
+              str.push_back('\n');
+              break;
+
+            case 'r':
+              str.push_back('\r');
+              break;
+
+            case 't':
+              str.push_back('\t');
+              break;
+
+            case 'v':
+              str.push_back('\v');
+              break;
+
+            case '0':
+              str.push_back('\0');
+              break;
+
+            case 'Z':
+              str.push_back('\x1A');
+              break;
+
+            case 'e':
+              str.push_back('\x1B');
+              break;
+
+            {
+            case 'U':     // "\U123456"
+              xcnt += 2;
+            case 'u':     // "\u1234"
+              xcnt += 2;
+            case 'x':     // "\x12"
+              xcnt += 2;
+
+              if(eptr - tptr < 2 + xcnt)
+                return this->do_incomplete_opt(tptr, final, "Escape sequence incomplete");
+
+              char32_t cp = 0;
+              for(int i = 0;  i < xcnt;  ++i)
+                if(!is_cmask(tptr[2 + i], cmask_xdigit))
+                  this->do_throw_error(tptr, "Invalid hexadecimal digit");
+                else
+                  cp = cp * 16 + (char32_t) do_xdigit_value(tptr[2 + i]);
+
+              if(tptr[1] == 'x') {
+                // Write the character verbatim.
+                str.push_back(static_cast<char>(cp));
+                break;
+              }
+
+              if((tptr[1] == 'u') && (cp >= 0xD800) && (cp <= 0xDBFF)) {
+                // Combine a UTF-16 surrogate pair.
+                if(eptr - tptr < 12)
+                  return this->do_incomplete_opt(tptr, final, "Invalid UTF code point");
+
+                char32_t lo = 0;
+                for(int i = 0;  (i < 4) && (tptr[6] == '\\') && (tptr[7] == 'u');  ++i)
+                  if(is_cmask(tptr[8 + i], cmask_xdigit))
+                    lo = lo * 16 + (char32_t) do_xdigit_value(tptr[8 + i]);
+                  else
+                    break;
+
+                if((lo < 0xDC00) || (lo > 0xDFFF))
+                  this->do_throw_error(tptr, "Invalid UTF code point");
+
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                tptr += 6;
+              }
+
+              // Write a Unicode code point.
+              if(!utf8_encode(str, cp))
+                this->do_throw_error(tptr, "Invalid UTF code point");
+              break;
+            }
+
+            default:
+              this->do_throw_error(tptr, "Unknown escape sequence");
+          }
+          tptr += 2 + xcnt;
+        }
       }
-      else if(qtok->as_identifier() == "true") {
-        tstrm.shift();
-        value = true;
+
+    const char*
+    do_scan_word_opt(const char* sptr, const char* eptr, bool final) const
+      {
+        // Get the end of a sequence of identifier characters, which may be
+        // truncated at the end of this chunk.
+        const char* tptr = sptr;
+        while((tptr != eptr) && is_cmask(*tptr, cmask_namei | cmask_digit))
+          tptr ++;
+        if((tptr == eptr) && !final)
+          return nullptr;
+        return tptr;
       }
-      else if(qtok->as_identifier() == "false") {
-        tstrm.shift();
-        value = false;
+
+    const char*
+    do_scan_number_opt(double& val, const char* sptr, const char* eptr, bool final) const
+      {
+        // Get the end of this number. A sign is allowed at the beginning, and
+        // after an exponent character.
+        const char* nptr = sptr + (*sptr == '+' || *sptr == '-');
+        const char* tptr = nptr;
+        while(tptr != eptr) {
+          if(is_cmask(*tptr, cmask_namei | cmask_digit) || (*tptr == '.') || (*tptr == '`'))
+            tptr ++;
+          else if((*tptr == '+' || *tptr == '-') && (tptr != nptr)
+                  && ::rocket::is_any_of(tptr[-1] | 0x20, { 'e', 'p' }))
+            tptr ++;
+          else
+            break;
+        }
+        if((tptr == eptr) && !final)
+          return nullptr;
+
+        // Check for infinities and NaNs.
+        size_t nlen = (size_t) (tptr - nptr);
+        if(nlen == 0)
+          this->do_throw_error(sptr, "Value expected");
+
+        if(!is_cmask(*nptr, cmask_digit)) {
+          if((nlen == 3) && (::memcmp(nptr, "nan", 3) == 0 || ::memcmp(nptr, "NaN", 3) == 0))
+            val = ::std::numeric_limits<double>::quiet_NaN();
+          else if((nlen == 8) && (::memcmp(nptr + 1, "nfinity", 7) == 0) && (*nptr | 0x20) == 'i')
+            val = ::std::numeric_limits<double>::infinity();
+          else
+            this->do_throw_error(sptr, "Value expected");
+
+          val = ::std::copysign(val, (*sptr == '-') ? -1.0 : 1.0);
+          return tptr;
+        }
+
+        // Remove digit separators. Usually there are none.
+        const char* text = sptr;
+        size_t tlen = (size_t) (tptr - sptr);
+        cow_string tstr;
+        if(::memchr(sptr, '`', tlen)) {
+          // A radix prefix shall not contain any separator.
+          if((nptr[0] == '0') && (nptr[1] == '`')) {
+            auto p = nptr + 1;
+            while((p != tptr) && (*p == '`'))
+              p ++;
+            if((p != tptr) && ::rocket::is_any_of(*p | 0x20, { 'b', 'x' }))
+              this->do_throw_error(sptr, "Invalid numeric literal");
+          }
+
+          for(auto p = sptr;  p != tptr;  ++p)
+            if(*p != '`')
+              tstr.push_back(*p);
+
+          text = tstr.data();
+          tlen = tstr.size();
+        }
+
+        ::rocket::ascii_numget numg;
+        if(numg.parse_D(text, tlen) != tlen)
+          this->do_throw_error(sptr, "Invalid numeric literal");
+
+        numg.cast_D(val, -DBL_MAX, DBL_MAX);
+        if(numg.overflowed())
+          this->do_throw_error(sptr, "Real literal overflow");
+        if(numg.underflowed())
+          this->do_throw_error(sptr, "Real literal underflow");
+        return tptr;
       }
-      else if(qtok->as_identifier() == "Infinity") {
-        tstrm.shift();
-        value = ::std::numeric_limits<double>::infinity();
+
+    void
+    do_push_value(const char* sptr, Value&& value)
+      {
+        bool emit = this->m_stack.size() == (uint64_t) this->m_depth;
+
+        if(this->m_stack.empty()) {
+          // The top-level value is complete.
+          if(emit)
+            this->m_emitted.emplace_back(nullopt, move(value));
+          else
+            this->m_value = move(value);
+
+          this->m_end_line = this->m_line;
+          this->m_expect = expect_end;
+          return;
+        }
+
+        auto& ctx = this->m_stack.mut_back();
+        if(ctx.index() == 0) {
+          auto& ctxa = ctx.mut<Xparse_array>();
+          if(emit)
+            this->m_emitted.emplace_back(ctxa.index, move(value));
+          else
+            ctxa.arr.emplace_back(move(value));
+          ctxa.index ++;
+        }
+        else {
+          // Keys of values that are emitted are stored with null values, so
+          // duplicate keys are detected in either case.
+          auto& ctxo = ctx.mut<Xparse_object>();
+          auto result = ctxo.obj.try_emplace(move(ctxo.key));
+          if(!result.second)
+            this->do_throw_error(sptr, "Duplicate key in object");
+
+          if(emit)
+            this->m_emitted.emplace_back(result.first->first.rdstr(), move(value));
+          else
+            result.first->second = move(value);
+        }
+        this->m_expect = expect_comma_or_close;
       }
-      else if(qtok->as_identifier() == "NaN") {
-        tstrm.shift();
-        value = ::std::numeric_limits<double>::quiet_NaN();
+
+    void
+    do_close(const char* sptr)
+      {
+        Value value;
+        auto& ctx = this->m_stack.mut_back();
+        if(ctx.index() == 0)
+          value = move(ctx.mut<Xparse_array>().arr);
+        else if(this->m_stack.size() != (uint64_t) this->m_depth)
+          value = move(ctx.mut<Xparse_object>().obj);
+        else
+          value = V_object();  // keys of emitted values only
+
+        this->m_stack.pop_back();
+        this->do_push_value(sptr, move(value));
       }
-      else
-        throw Compiler_Error(xtc_format,
-                  compiler_status_expression_expected, tstrm.next_sloc(),
-                  "Value expected");
-    }
-    else if(qtok->is_real_literal()) {
-      // Accept a number.
-      value = qtok->as_real_literal();
-      tstrm.shift();
-    }
-    else if(qtok->is_string_literal()) {
-      // Accept a UTF-8 string.
-      value = qtok->as_string_literal();
-      tstrm.shift();
-    }
-    else
-      throw Compiler_Error(xtc_format,
-                compiler_status_expression_expected, tstrm.next_sloc(),
-                "Value expected");
 
-    while(stack.size()) {
-      // Advance to the next element.
-      auto& ctx = stack.mut_back();
-      switch(ctx.index())
-        {
-        case 0:
+    const char*
+    do_accept_value_opt(const char* sptr, const char* eptr, bool final)
+      {
+        const char* tptr;
+        switch(*sptr)
           {
-            auto& ctxa = ctx.mut<Xparse_array>();
-            ctxa.arr.emplace_back(move(value));
+          case '[':
+            this->m_stack.emplace_back(Xparse_array());
+            this->m_expect = expect_value_or_close;
+            return sptr + 1;
+
+          case '{':
+            this->m_stack.emplace_back(Xparse_object());
+            this->m_expect = expect_key_or_close;
+            return sptr + 1;
+
+          case '\"':
+          case '\'':
+            {
+              cow_string str;
+              tptr = this->do_scan_string_opt(str, sptr, eptr, final);
+              if(tptr)
+                this->do_push_value(sptr, move(str));
+              return tptr;
+            }
 
-            // Look for the next element.
-            auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_bracket_cl, punctuator_comma });
-            if(!kpunct)
-              throw Compiler_Error(xtc_status,
-                        compiler_status_closing_bracket_or_comma_expected, tstrm.next_sloc());
-
-            if(*kpunct == punctuator_comma) {
-              // A closing bracket may still follow.
-              kpunct = do_accept_punctuator_opt(tstrm, { punctuator_bracket_cl });
-              if(!kpunct)
-                goto parse_next;
+          case '+':
+          case '-':
+          case '0':
+          case '1':
+          case '2':
+          case '3':
+          case '4':
+          case '5':
+          case '6':
+          case '7':
+          case '8':
+          case '9':
+            {
+              double val;
+              tptr = this->do_scan_number_opt(val, sptr, eptr, final);
+              if(tptr)
+                this->do_push_value(sptr, val);
+              return tptr;
             }
 
-            // Close this array.
-            value = move(ctxa.arr);
+          default:
+            {
+              if(!is_cmask(*sptr, cmask_namei))
+                this->do_throw_error(sptr, "Value expected");
+
+              tptr = this->do_scan_word_opt(sptr, eptr, final);
+              if(!tptr)
+                return nullptr;
+
+              // Accept a literal. Infinities and NaNs are numbers.
+              size_t tlen = (size_t) (tptr - sptr);
+              if((tlen == 4) && (::memcmp(sptr, "null", 4) == 0))
+                this->do_push_value(sptr, nullopt);
+              else if((tlen == 4) && (::memcmp(sptr, "true", 4) == 0))
+                this->do_push_value(sptr, true);
+              else if((tlen == 5) && (::memcmp(sptr, "false", 5) == 0))
+                this->do_push_value(sptr, false);
+              else {
+                double val;
+                this->do_scan_number_opt(val, sptr, tptr, true);
+                this->do_push_value(sptr, val);
+              }
+              return tptr;
+            }
+        }
+      }
+
+    const char*
+    do_accept_key_opt(const char* sptr, const char* eptr, bool final)
+      {
+        const char* tptr;
+        cow_string str;
+        if((*sptr == '\"') || (*sptr == '\'')) {
+          tptr = this->do_scan_string_opt(str, sptr, eptr, final);
+          if(!tptr)
+            return nullptr;
+        }
+        else if(is_cmask(*sptr, cmask_namei)) {
+          tptr = this->do_scan_word_opt(sptr, eptr, final);
+          if(!tptr)
+            return nullptr;
+          str.append(sptr, tptr);
+        }
+        else
+          this->do_throw_error(sptr, "Closing brace or JSON5 key expected");
+
+        this->m_stack.mut_back().mut<Xparse_object>().key = move(str);
+        this->m_expect = expect_colon;
+        return tptr;
+      }
+
+    size_t
+    do_parse_some(const char* bptr, const char* eptr, bool final)
+      {
+        // Parse as many tokens as possible, and return the number of
+        // characters that have been consumed.
+        this->m_bptr = bptr;
+        const char* sptr = bptr;
+
+        if(!this->m_bom_done) {
+          // Remove the UTF-8 BOM, if any.
+          size_t n = ::rocket::min((size_t) (eptr - sptr), (size_t) 3);
+          if(::memcmp(sptr, "\xEF\xBB\xBF", n) == 0) {
+            if((n != 0) && (n < 3)) {
+              if(!final)
+                return 0;
+              this->do_throw_error(sptr, "Invalid UTF-8 sequence");
+            }
+            sptr += n;
+          }
+          this->m_bom_done = true;
+        }
+
+        for(;;) {
+          sptr = this->do_skip_spaces(sptr, eptr);
+          if(sptr == eptr)
             break;
+
+          const char* tptr = nullptr;
+          if(*sptr == '/') {
+            tptr = this->do_skip_comment_opt(sptr, eptr, final);
+            if(!tptr)
+              break;
+
+            sptr = tptr;
+            continue;
           }
 
-        case 1:
-          {
-            auto& ctxo = ctx.mut<Xparse_object>();
-            auto pair = ctxo.obj.try_emplace(move(ctxo.key), move(value));
-            if(!pair.second)
-              throw Compiler_Error(xtc_status,
-                        compiler_status_duplicate_key_in_object, ctxo.key_sloc);
-
-            // Look for the next element.
-            auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl, punctuator_comma });
-            if(!kpunct)
-              throw Compiler_Error(xtc_status,
-                        compiler_status_closing_brace_or_comma_expected, tstrm.next_sloc());
-
-            if(*kpunct == punctuator_comma) {
-              // A closing brace may still follow.
-              kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl });
-              if(!kpunct) {
-                do_accept_object_key(stack.mut_back().mut<Xparse_object>(), tstrm);
-                goto parse_next;
+          switch(this->m_expect)
+            {
+            case expect_value_or_close:
+              if(*sptr == ']') {
+                this->do_close(sptr);
+                tptr = sptr + 1;
+                break;
               }
-            }
+              // fallthrough
 
-            // Close this object.
-            value = move(ctxo.obj);
+            case expect_value:
+              tptr = this->do_accept_value_opt(sptr, eptr, final);
+              break;
+
+            case expect_key_or_close:
+              if(*sptr == '}') {
+                this->do_close(sptr);
+                tptr = sptr + 1;
+                break;
+              }
+              tptr = this->do_accept_key_opt(sptr, eptr, final);
+              break;
+
+            case expect_colon:
+              if(*sptr != ':')
+                this->do_throw_error(sptr, "Colon expected");
+
+              this->m_expect = expect_value;
+              tptr = sptr + 1;
+              break;
+
+            case expect_comma_or_close:
+              if(this->m_stack.back().index() == 0) {
+                if(*sptr == ',')
+                  this->m_expect = expect_value_or_close;
+                else if(*sptr == ']')
+                  this->do_close(sptr);
+                else
+                  this->do_throw_error(sptr, "Closing bracket or comma expected");
+              }
+              else {
+                if(*sptr == ',')
+                  this->m_expect = expect_key_or_close;
+                else if(*sptr == '}')
+                  this->do_close(sptr);
+                else
+                  this->do_throw_error(sptr, "Closing brace or comma expected");
+              }
+              tptr = sptr + 1;
+              break;
+
+            case expect_end:
+              // In NDJSON mode, another document may start on a new line.
+              if(!this->m_ndjson || (this->m_line == this->m_end_line))
+                this->do_throw_error(sptr, "Excess text at end of JSON string");
+
+              tptr = this->do_accept_value_opt(sptr, eptr, final);
+              break;
+
+            default:
+              ROCKET_ASSERT(false);
+          }
+
+          if(!tptr)
             break;
+
+          sptr = tptr;
+        }
+
+        size_t nconsumed = (size_t) (sptr - bptr);
+        this->m_offset += (int64_t) nconsumed;
+        return nconsumed;
+      }
+
+  public:
+    cow_vector<pair<Value, Value>>&
+    mut_emitted() noexcept
+      { return this->m_emitted;  }
+
+    void
+    clear() noexcept
+      {
+        this->m_emitted.clear();
+        this->m_stack.clear();
+        this->m_value = nullopt;
+        this->m_expect = expect_value;
+        this->m_bom_done = false;
+        this->m_end_line = 0;
+        this->m_pend.clear();
+        this->m_pend_retry = 0;
+        this->m_bptr = nullptr;
+        this->m_offset = 0;
+        this->m_line = 1;
+        this->m_line_offset = 0;
+      }
+
+    void
+    feed(const char* data, size_t size)
+      {
+        // Characters are parsed in place, unless there is an incomplete token
+        // from the last chunk.
+        if(this->m_pend.empty()) {
+          size_t n = this->do_parse_some(data, data + size, false);
+          this->m_pend.append(data + n, size - n);
+        }
+        else {
+          // Wait until the incomplete token has at least doubled, so the
+          // total work is linear in the length of the token.
+          this->m_pend.append(data, size);
+          if(this->m_pend.size() < this->m_pend_retry)
+            return;
+
+          size_t n = this->do_parse_some(this->m_pend.data(),
+                                         this->m_pend.data() + this->m_pend.size(), false);
+          this->m_pend.erase(0, n);
+        }
+        this->m_pend_retry = this->m_pend.size() * 2;
+      }
+
+    Value
+    finish()
+      {
+        this->do_parse_some(this->m_pend.data(),
+                            this->m_pend.data() + this->m_pend.size(), true);
+        this->m_pend.clear();
+        this->m_pend_retry = 0;
+
+        if(this->m_expect != expect_end) {
+          if(this->m_stack.empty() && (this->m_expect == expect_value)) {
+            // An NDJSON stream may contain no document at all.
+            if(this->m_ndjson)
+              return nullopt;
+
+            ASTERIA_THROW(("Empty JSON string"));
           }
 
-        default:
-          ROCKET_ASSERT(false);
+          this->do_throw_error(this->m_bptr, "Unexpected end of JSON string");
+        }
+        return move(this->m_value);
       }
+  };
 
-      stack.pop_back();
+struct JSON_Emitted_Queue
+  :
+    public rcfwd<JSON_Emitted_Queue>
+  {
+    // Values are passed to the callback one by one. If the callback throws
+    // an exception, values after `next` are kept, and are passed first by
+    // the next call to `feed()` or `finish()`. This is shared with callers,
+    // so it remains valid if the callback destroys the parser.
+    cow_vector<pair<Value, Value>> values;
+    size_t next = 0;
+  };
+
+class JSON_Stream_Parser
+  :
+    public Abstract_Opaque
+  {
+  private:
+    JSON_Parser m_parser;
+    refcnt_ptr<JSON_Emitted_Queue> m_queue;
+
+  public:
+    JSON_Stream_Parser(int64_t depth, bool ndjson)
+      :
+        m_parser(depth, ndjson), m_queue(::rocket::make_refcnt<JSON_Emitted_Queue>())
+      { }
+
+  private:
+    refcnt_ptr<JSON_Emitted_Queue>
+    do_take_emitted()
+      {
+        auto& emitted = this->m_parser.mut_emitted();
+        for(auto it = emitted.mut_begin();  it != emitted.end();  ++it)
+          this->m_queue->values.emplace_back(move(*it));
+        emitted.clear();
+        return this->m_queue;
+      }
+
+  public:
+    tinyfmt&
+    describe(tinyfmt& fmt) const override
+      {
+        return format(fmt, "instance of `std.json.Parser` at `$1`", this);
+      }
+
+    void
+    collect_variables(Variable_HashMap&, Variable_HashMap&) const override
+      {
+      }
+
+    JSON_Stream_Parser*
+    clone_opt(refcnt_ptr<Abstract_Opaque>& out) const override
+      {
+        auto queue = ::rocket::make_refcnt<JSON_Emitted_Queue>();
+        queue->values = this->m_queue->values;
+        queue->next = this->m_queue->next;
+
+        auto ptr = new auto(*this);
+        out.reset(ptr);
+        ptr->m_queue = move(queue);
+        return ptr;
+      }
+
+    void
+    clear() noexcept
+      {
+        this->m_parser.clear();
+        this->m_queue->values.clear();
+        this->m_queue->next = 0;
+      }
+
+    refcnt_ptr<JSON_Emitted_Queue>
+    feed(const char* data, size_t size)
+      {
+        this->m_parser.feed(data, size);
+        return this->do_take_emitted();
+      }
+
+    refcnt_ptr<JSON_Emitted_Queue>
+    finish()
+      {
+        // Reset the parser after the last chunk, no matter whether it
+        // succeeds or not.
+        try {
+          this->m_parser.finish();
+        }
+        catch(...) {
+          this->m_parser.clear();
+          throw;
+        }
+        auto queue = this->do_take_emitted();
+        this->m_parser.clear();
+        return queue;
+      }
+  };
+
+void
+do_invoke_on_value(Global_Context& global, const V_function& on_value,
+                   const refcnt_ptr<JSON_Emitted_Queue>& queue)
+  {
+    // The parser is not referenced here, so the callback may do anything with
+    // it, including feeding more data. A nested call passes values that are
+    // left in the queue, so `next` is checked again after each call.
+    Reference self;
+    Reference_Stack stack;
+    while(queue->next < queue->values.size()) {
+      auto& elem = queue->values.mut(queue->next ++);
+      stack.clear();
+      stack.push().set_temporary(move(elem.first));
+      stack.push().set_temporary(move(elem.second));
+      self.clear();
+      on_value.invoke(self, global, move(stack));
     }
 
-    return value;
+    // All values have been passed.
+    queue->values.clear();
+    queue->next = 0;
   }
 
-Value
-do_parse(tinybuf& cbuf)
-  {
-    // We reuse the lexer of Asteria here, allowing quite a few extensions e.g. binary numeric
-    // literals and comments.
-    Compiler_Options opts;
-    opts.escapable_single_quotes = true;
-    opts.keywords_as_identifiers = true;
-    opts.integers_as_reals = true;
-
-    Token_Stream tstrm(opts);
-    tstrm.reload(&"[JSON text]", 1, move(cbuf));
-    if(tstrm.empty())
-      ASTERIA_THROW(("Empty JSON string"));
-
-    // Parse a single value.
-    auto value = do_parse_nonrecursive(tstrm);
-    if(!tstrm.empty())
-      ASTERIA_THROW(("Excess text at end of JSON string"));
-
-    return value;
+void
+do_construct_Parser(V_object& result, optV_integer depth, optV_boolean ndjson)
+  {
+    static constexpr auto s_private_uuid = &"{6b2b8b3e-5b0a-4a55-9f1e-1b9d8e3c0f7a}";
+    result.insert_or_assign(s_private_uuid, std_json_Parser_private(depth, ndjson));
+
+    result.insert_or_assign(&"feed",
+      ASTERIA_BINDING(
+        "std.json.Parser::feed", "data, on_value",
+        Global_Context& global, Reference&& self, Argument_Reader&& reader)
+      {
+        auto& self_obj = self.dereference_mutable().mut_object();
+        auto& parser = self_obj.mut(s_private_uuid).mut_opaque();
+        V_string data;
+        V_function on_value;
+
+        reader.start_overload();
+        reader.required(data);
+        reader.required(on_value);
+        if(reader.end_overload())
+          return (void) std_json_Parser_feed(global, parser, data, on_value);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"finish",
+      ASTERIA_BINDING(
+        "std.json.Parser::finish", "on_value",
+        Global_Context& global, Reference&& self, Argument_Reader&& reader)
+      {
+        auto& self_obj = self.dereference_mutable().mut_object();
+        auto& parser = self_obj.mut(s_private_uuid).mut_opaque();
+        V_function on_value;
+
+        reader.start_overload();
+        reader.required(on_value);
+        if(reader.end_overload())
+          return (void) std_json_Parser_finish(global, parser, on_value);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"clear",
+      ASTERIA_BINDING(
+        "std.json.Parser::clear", "",
+        Reference&& self, Argument_Reader&& reader)
+      {
+        auto& self_obj = self.dereference_mutable().mut_object();
+        auto& parser = self_obj.mut(s_private_uuid).mut_opaque();
+
+        reader.start_overload();
+        if(reader.end_overload())
+          return (void) std_json_Parser_clear(parser);
+
+        reader.throw_no_matching_function_call();
+      });
   }
 
 }  // namespace
@@ -671,26 +1665,81 @@ std_json_format(Value value, V_integer indent, optV_boolean json5)
 Value
 std_json_parse(V_string text)
   {
-    // Parse characters from the string.
-    ::rocket::tinybuf_str cbuf;
-    cbuf.set_string(text, tinybuf::open_read);
-    return do_parse(cbuf);
+    // Parse characters from the string in place.
+    JSON_Parser parser;
+    parser.feed(text.data(), text.size());
+    return parser.finish();
   }
 
 Value
 std_json_parse_file(V_string path)
   {
     // Try opening the file.
-    ::rocket::unique_posix_file fp(::fopen(path.safe_c_str(), "rb"));
-    if(!fp)
+    ::rocket::unique_posix_fd fd(::open(path.safe_c_str(), O_RDONLY));
+    if(!fd)
       ASTERIA_THROW((
           "Could not open file '$1'",
-          "[`fopen()` failed: ${errno:full}]"),
+          "[`open()` failed: ${errno:full}]"),
           path);
 
-    // Parse characters from the file.
-    ::rocket::tinybuf_file cbuf(move(fp));
-    return do_parse(cbuf);
+    // Parse characters from the file in chunks, so the file is never loaded
+    // into memory as a whole.
+    size_t nbuf = 0x10000;
+    unique_ptr<char, void (void*)> pbuf(static_cast<char*>(::operator new(nbuf)), ::operator delete);
+
+    JSON_Parser parser;
+    for(;;) {
+      ::ssize_t nread = ::read(fd, pbuf, nbuf);
+      if(nread <= 0) {
+        // Check for end of file.
+        if(nread == 0)
+          break;
+
+        ASTERIA_THROW((
+            "Error reading file '$1'",
+            "[`read()` failed: ${errno:full}]"),
+            path);
+      }
+      parser.feed(pbuf, static_cast<size_t>(nread));
+    }
+    return parser.finish();
+  }
+
+V_object
+std_json_Parser(optV_integer depth, optV_boolean ndjson)
+  {
+    V_object result;
+    do_construct_Parser(result, depth, ndjson);
+    return result;
+  }
+
+V_opaque
+std_json_Parser_private(optV_integer depth, optV_boolean ndjson)
+  {
+    if(depth && (*depth < 0))
+      ASTERIA_THROW(("Negative depth (`$1` not valid)"), *depth);
+
+    return ::rocket::make_refcnt<JSON_Stream_Parser>(depth.value_or(0), ndjson == true);
+  }
+
+void
+std_json_Parser_feed(Global_Context& global, V_opaque& p, V_string data, V_function on_value)
+  {
+    auto queue = p.open<JSON_Stream_Parser>().feed(data.data(), data.size());
+    do_invoke_on_value(global, on_value, queue);
+  }
+
+void
+std_json_Parser_finish(Global_Context& global, V_opaque& p, V_function on_value)
+  {
+    auto queue = p.open<JSON_Stream_Parser>().finish();
+    do_invoke_on_value(global, on_value, queue);
+  }
+
+void
+std_json_Parser_clear(V_opaque& p)
+  {
+    p.open<JSON_Stream_Parser>().clear();
   }
 
 void
@@ -752,6 +1801,23 @@ create_bindings_json(V_object& result, API_Version /*version*/)
 
         reader.throw_no_matching_function_call();
       });
+
+    result.insert_or_assign(&"Parser",
+      ASTERIA_BINDING(
+        "std.json.Parser", "[depth], [ndjson]",
+        Argument_Reader&& reader)
+      {
+        optV_integer depth;
+        optV_boolean ndjson;
+
+        reader.start_overload();
+        reader.optional(depth);
+        reader.optional(ndjson);
+        if(reader.end_overload())
+          return (Value) std_json_Parser(depth, ndjson);
+
+        reader.throw_no_matching_function_call();
+      });
   }
 
 }  // namespace asteria
@@ -22,6 +22,22 @@ std_json_parse(V_string text);
 Value
 std_json_parse_file(V_string path);
 
+// `std.json.Parser`
+V_object
+std_json_Parser(optV_integer depth, optV_boolean ndjson);
+
+V_opaque
+std_json_Parser_private(optV_integer depth, optV_boolean ndjson);
+
+void
+std_json_Parser_feed(Global_Context& global, V_opaque& p, V_string data, V_function on_value);
+
+void
+std_json_Parser_finish(Global_Context& global, V_opaque& p, V_function on_value);
+
+void
+std_json_Parser_clear(V_opaque& p);
+
 // Create an object that is to be referenced as `std.json`.
 void
 create_bindings_json(V_object& result, API_Version version);
@@ -5,10 +5,21 @@
 #include "string.hpp"
 #include "../runtime/argument_reader.hpp"
 #include "../runtime/binding_generator.hpp"
+#include "../runtime/global_context.hpp"
+#include "../runtime/regex_cache.hpp"
 #include "../utils.hpp"
 #include <iconv.h>
 #define PCRE2_CODE_UNIT_WIDTH 8
 #include <pcre2.h>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#  include <tmmintrin.h>
+#endif
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
 namespace asteria {
 namespace {
 
@@ -58,16 +69,153 @@ do_slice(const V_string& text, const V_integer& from, const optV_integer& length
     return do_slice(text, text.begin(), rfrom + *length);
   }
 
+const char*
+do_find_short(const char* tcur, const char* tend, const char* pptr, size_t plen) noexcept
+  {
+    // Search forward for a pattern of at most 32 bytes. `tend - tcur` shall
+    // not be less than `plen`.
+    if(plen == 1)
+      return static_cast<const char*>(::memchr(tcur, pptr[0], static_cast<size_t>(tend - tcur)));
+
+    // Compare the first and last bytes of each candidate interval in blocks,
+    // and check the others only for intervals where both match.
+    const char* tfinal = tend - plen;
+#ifdef __AVX2__
+    const __m256i f32 = _mm256_set1_epi8(pptr[0]);
+    const __m256i l32 = _mm256_set1_epi8(pptr[plen - 1]);
+    while(tfinal - tcur >= 31) {
+      __m256i tf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tcur));
+      __m256i tl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tcur + plen - 1));
+      __m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(tf, f32), _mm256_cmpeq_epi8(tl, l32));
+      uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+      while(bits != 0) {
+        const char* tcand = tcur + ROCKET_TZCNT32(bits);
+        if(::memcmp(tcand, pptr, plen) == 0)
+          return tcand;
+        bits &= bits - 1;
+      }
+      tcur += 32;
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i f16 = _mm_set1_epi8(pptr[0]);
+    const __m128i l16 = _mm_set1_epi8(pptr[plen - 1]);
+    while(tfinal - tcur >= 15) {
+      __m128i tf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tcur));
+      __m128i tl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tcur + plen - 1));
+      __m128i m = _mm_and_si128(_mm_cmpeq_epi8(tf, f16), _mm_cmpeq_epi8(tl, l16));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m));
+      while(bits != 0) {
+        const char* tcand = tcur + ROCKET_TZCNT32(bits);
+        if(::memcmp(tcand, pptr, plen) == 0)
+          return tcand;
+        bits &= bits - 1;
+      }
+      tcur += 16;
+    }
+#endif
+    while(tcur <= tfinal) {
+      tcur = static_cast<const char*>(::memchr(tcur, pptr[0], static_cast<size_t>(tfinal - tcur + 1)));
+      if(!tcur)
+        return nullptr;
+
+      if((tcur[plen - 1] == pptr[plen - 1]) && (::memcmp(tcur, pptr, plen) == 0))
+        return tcur;
+
+      tcur ++;
+    }
+    return nullptr;
+  }
+
+const char*
+do_rfind_short(const char* tbegin, const char* tcur, const char* pptr, size_t plen) noexcept
+  {
+    // Search backward for a pattern of at most 32 bytes. Candidate intervals
+    // start before `tnext`. `tcur - tbegin` shall not be less than `plen`.
+    const char* tnext = tcur - plen + 1;
+#ifdef __AVX2__
+    const __m256i f32 = _mm256_set1_epi8(pptr[0]);
+    const __m256i l32 = _mm256_set1_epi8(pptr[plen - 1]);
+    while(tnext - tbegin >= 32) {
+      const char* tblk = tnext - 32;
+      __m256i tf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tblk));
+      __m256i tl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tblk + plen - 1));
+      __m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(tf, f32), _mm256_cmpeq_epi8(tl, l32));
+      uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+      while(bits != 0) {
+        uint32_t k = 31U - static_cast<uint32_t>(ROCKET_LZCNT32(bits));
+        if(::memcmp(tblk + k, pptr, plen) == 0)
+          return tblk + k;
+        bits &= ~(1U << k);
+      }
+      tnext = tblk;
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i f16 = _mm_set1_epi8(pptr[0]);
+    const __m128i l16 = _mm_set1_epi8(pptr[plen - 1]);
+    while(tnext - tbegin >= 16) {
+      const char* tblk = tnext - 16;
+      __m128i tf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tblk));
+      __m128i tl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tblk + plen - 1));
+      __m128i m = _mm_and_si128(_mm_cmpeq_epi8(tf, f16), _mm_cmpeq_epi8(tl, l16));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m));
+      while(bits != 0) {
+        uint32_t k = 31U - static_cast<uint32_t>(ROCKET_LZCNT32(bits));
+        if(::memcmp(tblk + k, pptr, plen) == 0)
+          return tblk + k;
+        bits &= ~(1U << k);
+      }
+      tnext = tblk;
+    }
+#endif
+    while(tnext != tbegin) {
+      tnext --;
+      if((tnext[0] == pptr[0]) && (::memcmp(tnext, pptr, plen) == 0))
+        return tnext;
+    }
+    return nullptr;
+  }
+
+opt<cow_string::const_iterator>
+do_search_short(cow_string::const_iterator tbegin, cow_string::const_iterator tend,
+                const char* pptr, size_t plen) noexcept
+  {
+    const char* tptr = &*tbegin;
+    const char* qptr = do_find_short(tptr, tptr + (tend - tbegin), pptr, plen);
+    if(!qptr)
+      return nullopt;
+    return tbegin + (qptr - tptr);
+  }
+
+opt<cow_string::const_reverse_iterator>
+do_search_short(cow_string::const_reverse_iterator tbegin, cow_string::const_reverse_iterator tend,
+                const char* pptr, size_t plen) noexcept
+  {
+    // Reverse iterators denote the last byte of a match, so convert them to
+    // forward pointers, which denote the first. `pptr` is not reversed.
+    const char* tptr = &*tbegin + 1;
+    const char* qptr = do_rfind_short(tptr - (tend - tbegin), tptr, pptr, plen);
+    if(!qptr)
+      return nullopt;
+    return tbegin + (tptr - qptr - static_cast<ptrdiff_t>(plen));
+  }
+
 template<typename xIter>
-class BMH_Searcher
+class Substring_Searcher
   {
   private:
     xIter m_pbegin, m_pend;
-    ptrdiff_t m_bcr_offsets[0x100];
+    ptrdiff_t m_bcr_offsets[0x100];  // long patterns only
 
   public:
+    // Single bytes are searched with `memchr()`. Patterns of no more than 32
+    // bytes are searched by comparing their first and last bytes in blocks.
+    // The Boyer-Moore-Horspool algorithm is used for longer ones.
+    static constexpr ptrdiff_t max_short_length = 32;
+
     inline
-    BMH_Searcher(xIter pbegin, xIter pend)
+    Substring_Searcher(xIter pbegin, xIter pend)
       :
         m_pbegin(pbegin), m_pend(pend)
       {
@@ -75,6 +223,9 @@ class BMH_Searcher
         if(plen <= 0)
           ASTERIA_THROW(("Empty pattern string not allowed"));
 
+        if(plen <= max_short_length)
+          return;
+
         // Create a table according to the Bad Character Rule.
         for(ptrdiff_t k = 0;  k != 0x100;  ++k)
           this->m_bcr_offsets[k] = plen;
@@ -102,6 +253,16 @@ class BMH_Searcher
         return btext;
       }
 
+    static
+    const char*
+    do_xpattern_data(cow_string::const_iterator pbegin, ptrdiff_t /*plen*/) noexcept
+      { return &*pbegin;  }
+
+    static
+    const char*
+    do_xpattern_data(cow_string::const_reverse_iterator pbegin, ptrdiff_t plen) noexcept
+      { return &*pbegin + 1 - plen;  }
+
   public:
     opt<xIter>
     search_opt(xIter tbegin, xIter tend) const
@@ -113,6 +274,10 @@ class BMH_Searcher
         if(tend - tbegin < plen)
           return nullopt;
 
+        if(plen <= max_short_length)
+          return do_search_short(tbegin, tend, this->do_xpattern_data(this->m_pbegin, plen),
+                                 static_cast<size_t>(plen));
+
         // Perform a linear search for the first byte.
         // This has to be fast, but need not be very accurate.
         constexpr uintptr_t bmask = UINTPTR_MAX / 0xFF;
@@ -157,10 +322,10 @@ class BMH_Searcher
   };
 
 template<typename xIter>
-BMH_Searcher<xIter>
+Substring_Searcher<xIter>
 do_create_searcher_for_pattern(xIter pbegin, xIter pend)
   {
-    return BMH_Searcher<xIter>(pbegin, pend);
+    return Substring_Searcher<xIter>(pbegin, pend);
   }
 
 template<typename xIter>
@@ -168,7 +333,7 @@ opt<xIter>
 do_find_opt(xIter tbegin, xIter tend, xIter pbegin, xIter pend)
   {
     // If the pattern is empty, there is a match at the beginning.
-    // Don't pass empty patterns to the BMH searcher.
+    // Don't pass empty patterns to the searcher.
     if(pbegin == pend)
       return tbegin;
 
@@ -176,7 +341,6 @@ do_find_opt(xIter tbegin, xIter tend, xIter pbegin, xIter pend)
     if(tbegin == tend)
       return nullopt;
 
-    // This is the slow path.
     const auto srch = do_create_searcher_for_pattern(pbegin, pend);
     return srch.search_opt(tbegin, tend);
   }
@@ -185,18 +349,50 @@ template<typename xIter>
 opt<xIter>
 do_find_of_opt(xIter begin, xIter end, const V_string& set, bool match)
   {
-    bool table[256] = { };
+    // A single byte to accept is searched like a pattern.
+    if(match && (set.size() == 1) && (begin != end))
+      return do_search_short(begin, end, set.data(), 1);
+
+    // Use a bitmap, which is cheaper to initialize than an array of `bool`s.
+    uint32_t table[8] = { };
 
     for(char c : set)
-      table[(uint8_t)c] = true;
+      table[uint8_t(c) / 32] |= 1U << uint8_t(c) % 32;
 
     for(auto it = begin;  it != end;  ++it)
-      if(table[(uint8_t)*it] == match)
+      if(((table[uint8_t(*it) / 32] >> uint8_t(*it) % 32) & 1) == match)
         return move(it);
 
     return nullopt;
   }
 
+size_t
+do_count_utf8_code_points(const char* pos, const char* end) noexcept
+  {
+    // Count bytes other than continuation bytes, which are in the range
+    // [0x80,0xBF], i.e. [-128,-65] as signed integers.
+    size_t count = 0;
+#ifdef __AVX2__
+    while(end - pos >= 32) {
+      __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+      __m256i m = _mm256_cmpgt_epi8(t, _mm256_set1_epi8(-65));
+      count += (uint32_t) ROCKET_POPCNT32(static_cast<uint32_t>(_mm256_movemask_epi8(m)));
+      pos += 32;
+    }
+#endif
+#ifdef __SSE2__
+    while(end - pos >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+      __m128i m = _mm_cmpgt_epi8(t, _mm_set1_epi8(-65));
+      count += (uint32_t) ROCKET_POPCNT32(static_cast<uint32_t>(_mm_movemask_epi8(m)));
+      pos += 16;
+    }
+#endif
+    while(pos != end)
+      count += (int8_t) *(pos++) > -65;
+    return count;
+  }
+
 V_string
 do_get_reject(const optV_string& reject)
   {
@@ -271,6 +467,341 @@ do_xstrchr(const char* str, char c) noexcept
     return nullptr;
   }
 
+#ifdef __SSSE3__
+inline
+__m128i
+do_select_by_mask_128(__m128i mask, __m128i yes, __m128i no) noexcept
+  {
+    return _mm_or_si128(_mm_and_si128(mask, yes), _mm_andnot_si128(mask, no));
+  }
+
+inline
+__m128i
+do_less_equal_epu8_128(__m128i t, char limit) noexcept
+  {
+    return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(limit)), t);
+  }
+
+inline
+bool
+do_all_set_128(__m128i t) noexcept
+  {
+    return _mm_movemask_epi8(t) == 0xFFFF;
+  }
+#endif
+
+void
+do_hex_encode_blocks(char*& wptr, const char*& rptr, const char* rend) noexcept
+  {
+    // Encode 16 bytes into 32 digits at a time.
+#ifdef __SSSE3__
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    while(rend - rptr >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rptr));
+      __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(t, 4), nibble));
+      __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(t, nibble));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(wptr), _mm_unpacklo_epi8(hi, lo));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(wptr + 16), _mm_unpackhi_epi8(hi, lo));
+      rptr += 16;
+      wptr += 32;
+    }
+#endif
+    (void) wptr;
+    (void) rptr;
+    (void) rend;
+  }
+
+size_t
+do_hex_decode_blocks(V_string& data, const char* str, size_t len)
+  {
+    // Decode 32 digits into 16 bytes at a time, until a character that is
+    // not a digit is encountered. The number of characters consumed is
+    // returned.
+    size_t nread = 0;
+#ifdef __SSSE3__
+    while(len - nread >= 32) {
+      __m128i v[2];
+      bool valid = true;
+      for(size_t k = 0;  k != 2;  ++k) {
+        __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + nread + k * 16));
+        __m128i d = _mm_sub_epi8(t, _mm_set1_epi8('0'));
+        __m128i a = _mm_sub_epi8(_mm_or_si128(t, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i is_d = do_less_equal_epu8_128(d, 9);
+        __m128i is_a = do_less_equal_epu8_128(a, 5);
+        valid &= do_all_set_128(_mm_or_si128(is_d, is_a));
+        v[k] = do_select_by_mask_128(is_d, d, _mm_add_epi8(a, _mm_set1_epi8(10)));
+      }
+      if(!valid)
+        break;
+
+      // Combine pairs of digits. The first one is the more significant.
+      __m128i w0 = _mm_maddubs_epi16(v[0], _mm_set1_epi16(0x0110));
+      __m128i w1 = _mm_maddubs_epi16(v[1], _mm_set1_epi16(0x0110));
+      char out[16];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(w0, w1));
+      data.append(out, 16);
+      nread += 32;
+    }
+#endif
+    (void) data;
+    (void) str;
+    (void) len;
+    return nread;
+  }
+
+void
+do_base32_encode_blocks(char*& wptr, const char*& rptr, const char* rend) noexcept
+  {
+    // Encode 10 bytes into 16 digits at a time. 16 bytes are loaded, so
+    // there must be some more bytes after them.
+#ifdef __SSSE3__
+    // Each digit is taken from a big-endian word that contains it, which is
+    // then shifted right by multiplication.
+    const __m128i words = _mm_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4);
+    const __m128i shifts = _mm_setr_epi16(32, 1024, 128, 4096, 512, 64, 2048, 256);
+    while(rend - rptr >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rptr));
+      __m128i w0 = _mm_shuffle_epi8(t, words);
+      __m128i w1 = _mm_shuffle_epi8(t, _mm_add_epi8(words, _mm_set1_epi8(5)));
+      w0 = _mm_and_si128(_mm_mulhi_epu16(w0, shifts), _mm_set1_epi16(0x1F));
+      w1 = _mm_and_si128(_mm_mulhi_epu16(w1, shifts), _mm_set1_epi16(0x1F));
+      __m128i x = _mm_packus_epi16(w0, w1);
+
+      // Map `A` - `Z` and `2` - `7`.
+      __m128i y = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(25)), _mm_set1_epi8('2' - 26 - 'A'));
+      x = _mm_add_epi8(x, _mm_add_epi8(y, _mm_set1_epi8('A')));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(wptr), x);
+      rptr += 10;
+      wptr += 16;
+    }
+#endif
+    (void) wptr;
+    (void) rptr;
+    (void) rend;
+  }
+
+size_t
+do_base32_decode_blocks(V_string& data, const char* str, size_t len)
+  {
+    // Decode 16 digits into 10 bytes at a time, until a character that is
+    // not a digit is encountered. The number of characters consumed is
+    // returned.
+    size_t nread = 0;
+#ifdef __SSSE3__
+    while(len - nread >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + nread));
+      __m128i a = _mm_sub_epi8(_mm_or_si128(t, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+      __m128i d = _mm_sub_epi8(t, _mm_set1_epi8('2'));
+      __m128i is_a = do_less_equal_epu8_128(a, 25);
+      __m128i is_d = do_less_equal_epu8_128(d, 5);
+      if(!do_all_set_128(_mm_or_si128(is_a, is_d)))
+        break;
+
+      // Combine digits into groups of 40 bits, which are stored in 64-bit
+      // integers, and store them in big-endian order.
+      t = do_select_by_mask_128(is_a, a, _mm_add_epi8(d, _mm_set1_epi8(26)));
+      t = _mm_maddubs_epi16(t, _mm_set1_epi16(0x0120));
+      t = _mm_madd_epi16(t, _mm_set1_epi32(0x00010400));
+      t = _mm_add_epi64(_mm_mul_epu32(t, _mm_set1_epi64x(1 << 20)), _mm_srli_epi64(t, 32));
+      t = _mm_shuffle_epi8(t, _mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1));
+      char out[16];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), t);
+      data.append(out, 10);
+      nread += 16;
+    }
+#endif
+    (void) data;
+    (void) str;
+    (void) len;
+    return nread;
+  }
+
+#ifdef __SSSE3__
+inline
+__m128i
+do_base64_encode_128(__m128i t) noexcept
+  {
+    // Split each group of 3 bytes into 4 indices. This is the algorithm by
+    // Wojciech Mula.
+    t = _mm_shuffle_epi8(t, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(t, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    __m128i t1 = _mm_mullo_epi16(_mm_and_si128(t, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    t = _mm_or_si128(t0, t1);
+
+    // Map indices to digits by adding offsets of their ranges.
+    __m128i r = _mm_subs_epu8(t, _mm_set1_epi8(51));
+    r = _mm_or_si128(r, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), t), _mm_set1_epi8(13)));
+    r = _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                       '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                       '/' - 63, 'A', 0, 0), r);
+    return _mm_add_epi8(t, r);
+  }
+#endif
+
+#ifdef __AVX2__
+inline
+__m256i
+do_base64_encode_256(__m256i t) noexcept
+  {
+    t = _mm256_shuffle_epi8(t, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                               10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(t, _mm256_set1_epi32(0x0FC0FC00)),
+                                    _mm256_set1_epi32(0x04000040));
+    __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(t, _mm256_set1_epi32(0x003F03F0)),
+                                    _mm256_set1_epi32(0x01000010));
+    t = _mm256_or_si256(t0, t1);
+
+    __m256i r = _mm256_subs_epu8(t, _mm256_set1_epi8(51));
+    r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), t),
+                                            _mm256_set1_epi8(13)));
+    r = _mm256_shuffle_epi8(_mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                             'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), r);
+    return _mm256_add_epi8(t, r);
+  }
+#endif
+
+void
+do_base64_encode_blocks(char*& wptr, const char*& rptr, const char* rend) noexcept
+  {
+    // Encode 24 or 12 bytes into 32 or 16 digits at a time. 16 bytes are
+    // loaded each time, so there must be some more bytes after them.
+#ifdef __AVX2__
+    while(rend - rptr >= 28) {
+      __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rptr));
+      __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rptr + 12));
+      __m256i t = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(wptr), do_base64_encode_256(t));
+      rptr += 24;
+      wptr += 32;
+    }
+#endif
+#ifdef __SSSE3__
+    while(rend - rptr >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rptr));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(wptr), do_base64_encode_128(t));
+      rptr += 12;
+      wptr += 16;
+    }
+#endif
+    (void) wptr;
+    (void) rptr;
+    (void) rend;
+  }
+
+#ifdef __SSSE3__
+inline
+bool
+do_base64_decode_128(__m128i& t) noexcept
+  {
+    // Classify digits by their high and low nibbles, which yields zero for
+    // valid digits, and translate them into indices. This is the algorithm
+    // by Wojciech Mula.
+    const __m128i mask_2F = _mm_set1_epi8(0x2F);
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(t, 4), mask_2F);
+    __m128i lo_nibbles = _mm_and_si128(t, mask_2F);
+    __m128i hi = _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+                                  hi_nibbles);
+    __m128i lo = _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A),
+                                  lo_nibbles);
+    if(!do_all_set_128(_mm_cmpeq_epi8(_mm_and_si128(hi, lo), _mm_setzero_si128())))
+      return false;
+
+    __m128i roll = _mm_add_epi8(_mm_cmpeq_epi8(t, mask_2F), hi_nibbles);
+    roll = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                            roll);
+    t = _mm_add_epi8(t, roll);
+
+    // Combine indices into groups of 24 bits, and store them in big-endian
+    // order in the lowest 12 bytes.
+    t = _mm_maddubs_epi16(t, _mm_set1_epi32(0x01400140));
+    t = _mm_madd_epi16(t, _mm_set1_epi32(0x00011000));
+    t = _mm_shuffle_epi8(t, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+  }
+#endif
+
+#ifdef __AVX2__
+inline
+bool
+do_base64_decode_256(__m256i& t) noexcept
+  {
+    const __m256i mask_2F = _mm256_set1_epi8(0x2F);
+    __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(t, 4), mask_2F);
+    __m256i lo_nibbles = _mm256_and_si256(t, mask_2F);
+    __m256i hi = _mm256_shuffle_epi8(_mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+                                     hi_nibbles);
+    __m256i lo = _mm256_shuffle_epi8(_mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                                      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A),
+                                     lo_nibbles);
+    if(!_mm256_testz_si256(hi, lo))
+      return false;
+
+    __m256i roll = _mm256_add_epi8(_mm256_cmpeq_epi8(t, mask_2F), hi_nibbles);
+    roll = _mm256_shuffle_epi8(_mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                               roll);
+    t = _mm256_add_epi8(t, roll);
+
+    // Results in both lanes are moved together to the lowest 24 bytes.
+    t = _mm256_maddubs_epi16(t, _mm256_set1_epi32(0x01400140));
+    t = _mm256_madd_epi16(t, _mm256_set1_epi32(0x00011000));
+    t = _mm256_shuffle_epi8(t, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    t = _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    return true;
+  }
+#endif
+
+size_t
+do_base64_decode_blocks(V_string& data, const char* str, size_t len)
+  {
+    // Decode 32 or 16 digits into 24 or 12 bytes at a time, until a
+    // character that is not a digit is encountered. The number of characters
+    // consumed is returned.
+    size_t nread = 0;
+#ifdef __AVX2__
+    while(len - nread >= 32) {
+      __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + nread));
+      if(!do_base64_decode_256(t))
+        break;
+
+      char out[32];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), t);
+      data.append(out, 24);
+      nread += 32;
+    }
+#endif
+#ifdef __SSSE3__
+    while(len - nread >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + nread));
+      if(!do_base64_decode_128(t))
+        break;
+
+      char out[16];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), t);
+      data.append(out, 12);
+      nread += 16;
+    }
+#endif
+    (void) data;
+    (void) str;
+    (void) len;
+    return nread;
+  }
+
 class PCRE2_Error
   {
   private:
@@ -310,27 +841,11 @@ class PCRE2_Matcher
     uint32_t m_name_count = UINT32_MAX;  // unknown yet
 
   public:
-    PCRE2_Matcher(const V_string& patt, const optV_array& opts)
+    PCRE2_Matcher(const V_string& patt, uint32_t opts)
       :
-        m_patt(patt), m_opts(PCRE2_NEVER_UTF | PCRE2_NEVER_UCP),
+        m_patt(patt), m_opts(opts),
         m_code(::pcre2_code_free), m_match(::pcre2_match_data_free)
       {
-        // Check options.
-        if(opts)
-          for(const auto& opt : *opts) {
-            const auto& str = opt.as_string();
-            if(str == "caseless")
-              this->m_opts |= PCRE2_CASELESS;
-            else if(str == "dotall")
-              this->m_opts |= PCRE2_DOTALL;
-            else if(str == "extended")
-              this->m_opts |= PCRE2_EXTENDED;
-            else if(str == "multiline")
-              this->m_opts |= PCRE2_MULTILINE;
-            else
-              ASTERIA_THROW(("Invalid option for regular expression: $1"), str);
-          }
-
         // Compile the regular expression.
         int err;
         size_t off;
@@ -341,6 +856,16 @@ class PCRE2_Matcher
               "Invalid regular expression: $1",
               "[`pcre2_compile()` failed at offset `$2`: $3]"),
               this->m_patt, off, PCRE2_Error(err));
+
+        // Compile it into machine code if JIT is available. If it is not,
+        // the interpreter is used.
+        ::pcre2_jit_compile(this->m_code, PCRE2_JIT_COMPLETE);
+      }
+
+    PCRE2_Matcher(const V_string& patt, const optV_array& opts)
+      :
+        PCRE2_Matcher(patt, parse_options(opts))
+      {
       }
 
     PCRE2_Matcher(const PCRE2_Matcher& other, int)
@@ -348,11 +873,35 @@ class PCRE2_Matcher
         m_patt(other.m_patt), m_opts(other.m_opts),
         m_code(::pcre2_code_free), m_match(::pcre2_match_data_free)
       {
-        // Copy the regular expression.
+        // Copy the regular expression. JIT code is not copied.
         if(!this->m_code.reset(::pcre2_code_copy(other.m_code)))
           ASTERIA_THROW((
               "Could not copy regular expression",
               "[`pcre2_code_copy()` failed]"));
+
+        ::pcre2_jit_compile(this->m_code, PCRE2_JIT_COMPLETE);
+      }
+
+    static
+    uint32_t
+    parse_options(const optV_array& opts)
+      {
+        uint32_t bits = PCRE2_NEVER_UTF | PCRE2_NEVER_UCP;
+        if(opts)
+          for(const auto& opt : *opts) {
+            const auto& str = opt.as_string();
+            if(str == "caseless")
+              bits |= PCRE2_CASELESS;
+            else if(str == "dotall")
+              bits |= PCRE2_DOTALL;
+            else if(str == "extended")
+              bits |= PCRE2_EXTENDED;
+            else if(str == "multiline")
+              bits |= PCRE2_MULTILINE;
+            else
+              ASTERIA_THROW(("Invalid option for regular expression: $1"), str);
+          }
+        return bits;
       }
 
   private:
@@ -380,6 +929,10 @@ class PCRE2_Matcher
         this->do_initialize_match_data();
         int err = ::pcre2_match(this->m_code, sub_ptr, sub_len, 0, 0, this->m_match, nullptr);
 
+        if(err == PCRE2_ERROR_JIT_STACKLIMIT)
+          err = ::pcre2_match(this->m_code, sub_ptr, sub_len, 0, PCRE2_NO_JIT, this->m_match,
+                              nullptr);
+
         if(err == PCRE2_ERROR_NOMATCH)
           return nullopt;
 
@@ -506,18 +1059,27 @@ class PCRE2_Matcher
 
         // Try substitution.
         this->do_initialize_match_data();
+        uint32_t sub_opts = this->m_opts | PCRE2_SUBSTITUTE_EXTENDED | PCRE2_SUBSTITUTE_GLOBAL;
         int err = ::pcre2_substitute(this->m_code, sub_ptr, sub_len, 0,
-                        this->m_opts | PCRE2_SUBSTITUTE_EXTENDED | PCRE2_SUBSTITUTE_GLOBAL
-                                     | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
+                        sub_opts | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
                         this->m_match, nullptr, reinterpret_cast<const uint8_t*>(rep.data()),
                         rep.size(), reinterpret_cast<uint8_t*>(out_str.mut_data()), &out_len);
 
+        if(err == PCRE2_ERROR_JIT_STACKLIMIT) {
+          // Fall back to the interpreter, which has no such limit.
+          sub_opts |= PCRE2_NO_JIT;
+          out_len = out_str.size();
+          err = ::pcre2_substitute(this->m_code, sub_ptr, sub_len, 0,
+                        sub_opts | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
+                        this->m_match, nullptr, reinterpret_cast<const uint8_t*>(rep.data()),
+                        rep.size(), reinterpret_cast<uint8_t*>(out_str.mut_data()), &out_len);
+        }
+
         if(err == PCRE2_ERROR_NOMEMORY) {
           // The output length should have been written to `out_len`.
           // Resize the buffer and try again.
           out_str.assign(out_len, '/');
-          err = ::pcre2_substitute(this->m_code, sub_ptr, sub_len, 0,
-                        this->m_opts | PCRE2_SUBSTITUTE_EXTENDED | PCRE2_SUBSTITUTE_GLOBAL,
+          err = ::pcre2_substitute(this->m_code, sub_ptr, sub_len, 0, sub_opts,
                         this->m_match, nullptr, reinterpret_cast<const uint8_t*>(rep.data()),
                         rep.size(), reinterpret_cast<uint8_t*>(out_str.mut_data()), &out_len);
         }
@@ -539,6 +1101,22 @@ class PCRE2_Matcher
       }
   };
 
+refcnt_ptr<PCRE2_Matcher>
+do_get_PCRE2_matcher(Global_Context& global, const V_string& patt, const optV_array& opts)
+  {
+    // Scripts tend to call these functions in loops with the same pattern,
+    // so compiled patterns are cached by the global context.
+    uint32_t bits = PCRE2_Matcher::parse_options(opts);
+    auto cache = global.regex_cache();
+    auto code = cache->get_cached_regex_opt(patt, bits);
+    if(code)
+      return static_pointer_cast<PCRE2_Matcher>(move(code));
+
+    auto m = ::rocket::make_refcnt<PCRE2_Matcher>(patt, bits);
+    cache->set_cached_regex(patt, bits, m);
+    return m;
+  }
+
 void
 do_construct_PCRE(V_object& result, V_string pattern, optV_array options)
   {
@@ -1071,30 +1649,43 @@ std_string_hex_encode(V_string data, optV_string delim)
     const char* pdelim = delim ? delim->data() : "";
     size_t ndelim = delim ? delim->size() : 0;
 
+    // Allocate the result at once.
     V_string text;
-    text.reserve(data.size() * (2 + ndelim));
+    if(data.empty())
+      return text;
+
+    text.assign(data.size() * (2 + ndelim) - ndelim, '/');
+    char* wptr = text.mut_data();
+    const char* rptr = data.data();
+    const char* rend = data.data() + data.size();
+
+    // Encode source data in blocks if there are no delimiters.
+    if(ndelim == 0)
+      do_hex_encode_blocks(wptr, rptr, rend);
 
     // These shall be operated in big-endian order.
     uint32_t reg = 0;
 
     // Encode source data.
-    size_t nread = 0;
-    while(nread != data.size()) {
+    while(rptr != rend) {
       // Insert a delimiter before every byte other than the first one.
-      if(!text.empty())
-        text.append(pdelim, ndelim);
+      if(rptr != data.data()) {
+        ::memcpy(wptr, pdelim, ndelim);
+        wptr += ndelim;
+      }
 
       // Read a byte.
-      reg = data[nread++] & 0xFF;
+      reg = *(rptr++) & 0xFF;
       reg <<= 24;
 
       // Encode it.
       for(size_t i = 0;  i < 2;  ++i) {
         uint32_t b = (reg >> 27) & 0xFE;
         reg <<= 4;
-        text += s_base16_table[b];
+        *(wptr++) = s_base16_table[b];
       }
     }
+    ROCKET_ASSERT(wptr == text.data() + text.size());
     return text;
   }
 
@@ -1102,6 +1693,7 @@ V_string
 std_string_hex_decode(V_string text)
   {
     V_string data;
+    data.reserve(text.size() / 2);
 
     // These shall be operated in big-endian order.
     uint32_t reg = 1;
@@ -1109,6 +1701,13 @@ std_string_hex_decode(V_string text)
     // Decode source data.
     size_t nread = 0;
     while(nread != text.size()) {
+      // Decode complete bytes in blocks, where possible.
+      if(reg == 1) {
+        nread += do_hex_decode_blocks(data, text.data() + nread, text.size() - nread);
+        if(nread == text.size())
+          break;
+      }
+
       // Read and identify a character.
       char c = text[nread++];
       const char* pos = do_xstrchr(s_spaces, c);
@@ -1144,18 +1743,24 @@ std_string_hex_decode(V_string text)
 V_string
 std_string_base32_encode(V_string data)
   {
+    // Allocate the result at once.
     V_string text;
-    text.reserve((data.size() + 4) / 5 * 8);
+    text.assign((data.size() + 4) / 5 * 8, s_base32_table[64]);
+    char* wptr = text.mut_data();
+    const char* rptr = data.data();
+    const char* rend = data.data() + data.size();
+
+    // Encode source data in blocks.
+    do_base32_encode_blocks(wptr, rptr, rend);
 
     // These shall be operated in big-endian order.
     uint64_t reg = 0;
 
     // Encode source data.
-    size_t nread = 0;
-    while(data.size() - nread >= 5) {
+    while(rend - rptr >= 5) {
       // Read 5 consecutive bytes.
       for(size_t i = 0;  i < 5;  ++i) {
-        uint32_t b = data[nread++] & 0xFF;
+        uint32_t b = *(rptr++) & 0xFF;
         reg <<= 8;
         reg |= b;
       }
@@ -1165,32 +1770,28 @@ std_string_base32_encode(V_string data)
       for(size_t i = 0;  i < 8;  ++i) {
         uint32_t b = (reg >> 58) & 0xFE;
         reg <<= 5;
-        text += s_base32_table[b];
+        *(wptr++) = s_base32_table[b];
       }
     }
-    if(nread != data.size()) {
+    if(rptr != rend) {
       // Get the start of padding characters.
-      size_t m = data.size() - nread;
+      size_t m = (size_t) (rend - rptr);
       size_t p = (m * 8 + 4) / 5;
 
       // Read all remaining bytes that cannot fill up a unit.
       for(size_t i = 0;  i < m;  ++i) {
-        uint32_t b = data[nread++] & 0xFF;
+        uint32_t b = *(rptr++) & 0xFF;
         reg <<= 8;
         reg |= b;
       }
       reg <<= 64 - m * 8;
 
-      // Encode them.
+      // Encode them. Padding characters have been filled.
       for(size_t i = 0;  i < p;  ++i) {
         uint32_t b = (reg >> 58) & 0xFE;
         reg <<= 5;
-        text += s_base32_table[b];
+        *(wptr++) = s_base32_table[b];
       }
-
-      // Fill padding characters.
-      for(size_t i = p;  i != 8;  ++i)
-        text += s_base32_table[64];
     }
     return text;
   }
@@ -1199,6 +1800,7 @@ V_string
 std_string_base32_decode(V_string text)
   {
     V_string data;
+    data.reserve(text.size() / 8 * 5);
 
     // These shall be operated in big-endian order.
     uint64_t reg = 1;
@@ -1207,6 +1809,13 @@ std_string_base32_decode(V_string text)
     // Decode source data.
     size_t nread = 0;
     while(nread != text.size()) {
+      // Decode complete groups in blocks, where possible.
+      if(reg == 1) {
+        nread += do_base32_decode_blocks(data, text.data() + nread, text.size() - nread);
+        if(nread == text.size())
+          break;
+      }
+
       // Read and identify a character.
       char c = text[nread++];
       const char* pos = do_xstrchr(s_spaces, c);
@@ -1265,18 +1874,24 @@ std_string_base32_decode(V_string text)
 V_string
 std_string_base64_encode(V_string data)
   {
+    // Allocate the result at once.
     V_string text;
-    text.reserve((data.size() + 2) / 3 * 4);
+    text.assign((data.size() + 2) / 3 * 4, s_base64_table[64]);
+    char* wptr = text.mut_data();
+    const char* rptr = data.data();
+    const char* rend = data.data() + data.size();
+
+    // Encode source data in blocks.
+    do_base64_encode_blocks(wptr, rptr, rend);
 
     // These shall be operated in big-endian order.
     uint32_t reg = 0;
 
     // Encode source data.
-    size_t nread = 0;
-    while(data.size() - nread >= 3) {
+    while(rend - rptr >= 3) {
       // Read 3 consecutive bytes.
       for(size_t i = 0;  i < 3;  ++i) {
-        uint32_t b = data[nread++] & 0xFF;
+        uint32_t b = *(rptr++) & 0xFF;
         reg <<= 8;
         reg |= b;
       }
@@ -1286,32 +1901,28 @@ std_string_base64_encode(V_string data)
       for(size_t i = 0;  i < 4;  ++i) {
         uint32_t b = (reg >> 26) & 0xFF;
         reg <<= 6;
-        text += s_base64_table[b];
+        *(wptr++) = s_base64_table[b];
       }
     }
-    if(nread != data.size()) {
+    if(rptr != rend) {
       // Get the start of padding characters.
-      size_t m = data.size() - nread;
+      size_t m = (size_t) (rend - rptr);
       size_t p = (m * 8 + 5) / 6;
 
       // Read all remaining bytes that cannot fill up a unit.
       for(size_t i = 0;  i < m;  ++i) {
-        uint32_t b = data[nread++] & 0xFF;
+        uint32_t b = *(rptr++) & 0xFF;
         reg <<= 8;
         reg |= b;
       }
       reg <<= 32 - m * 8;
 
-      // Encode them.
+      // Encode them. Padding characters have been filled.
       for(size_t i = 0;  i < p;  ++i) {
         uint32_t b = (reg >> 26) & 0xFF;
         reg <<= 6;
-        text += s_base64_table[b];
+        *(wptr++) = s_base64_table[b];
       }
-
-      // Fill padding characters.
-      for(size_t i = p;  i != 4;  ++i)
-        text += s_base64_table[64];
     }
     return text;
   }
@@ -1320,6 +1931,7 @@ V_string
 std_string_base64_decode(V_string text)
   {
     V_string data;
+    data.reserve(text.size() / 4 * 3);
 
     // These shall be operated in big-endian order.
     uint32_t reg = 1;
@@ -1328,6 +1940,13 @@ std_string_base64_decode(V_string text)
     // Decode source data.
     size_t nread = 0;
     while(nread != text.size()) {
+      // Decode complete groups in blocks, where possible.
+      if(reg == 1) {
+        nread += do_base64_decode_blocks(data, text.data() + nread, text.size() - nread);
+        if(nread == text.size())
+          break;
+      }
+
       // Read and identify a character.
       char c = text[nread++];
       const char* pos = do_xstrchr(s_spaces, c);
@@ -1540,15 +2159,7 @@ std_string_url_query_decode(V_string text)
 V_boolean
 std_string_utf8_validate(V_string text)
   {
-    size_t offset = 0;
-    while(offset < text.size()) {
-      // Try decoding a code point.
-      char32_t cp;
-      if(!utf8_decode(cp, text, offset))
-        // This sequence is invalid.
-        return false;
-    }
-    return true;
+    return utf8_validate(text.data(), text.size());
   }
 
 V_string
@@ -1572,20 +2183,33 @@ std_string_utf8_encode(V_integer code_point, optV_boolean permissive)
 V_string
 std_string_utf8_encode(V_array code_points, optV_boolean permissive)
   {
-    V_string text;
-    text.reserve(code_points.size() * 3);
+    // Calculate the length of the result, so it can be allocated at once.
+    size_t len = 0;
     for(const auto& elem : code_points) {
-      // Try encoding the code point.
       V_integer value = elem.as_integer();
       auto cp = ::rocket::clamp_cast<char32_t>(value, -1, INT32_MAX);
-      if(!utf8_encode(text, cp)) {
+      if(((cp >= 0xD800U) && (cp < 0xE000U)) || (cp >= 0x110000U)) {
         // This comparison with `true` is by intention, because it may be unset.
         if(permissive != true)
           ASTERIA_THROW(("Invalid UTF code point (value `$1`)"), value);
 
-        utf8_encode(text, 0xFFFD);
+        cp = 0xFFFD;
       }
+      len += 1U + (cp >= 0x80U) + (cp >= 0x800U) + (cp >= 0x10000U);
+    }
+
+    // Encode code points, which have all been checked.
+    V_string text;
+    text.assign(len, '\0');
+    char* pos = text.mut_data();
+    for(const auto& elem : code_points) {
+      auto cp = ::rocket::clamp_cast<char32_t>(elem.as_integer(), -1, INT32_MAX);
+      if(cp < 0x80U)
+        *(pos++) = (char) cp;
+      else if(!utf8_encode(pos, cp))
+        utf8_encode(pos, 0xFFFD);
     }
+    ROCKET_ASSERT(pos == text.data() + len);
     return text;
   }
 
@@ -1593,19 +2217,39 @@ V_array
 std_string_utf8_decode(V_string text, optV_boolean permissive)
   {
     V_array code_points;
-    code_points.reserve(text.size());
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+
+    if(utf8_validate(text.data(), text.size())) {
+      // Each code point has exactly one byte that is not a continuation byte,
+      // so the result can be allocated at once.
+      code_points.reserve(do_count_utf8_code_points(pos, end));
+
+      while(pos != end) {
+        char32_t cp = (uint8_t) *pos;
+        if(cp < 0x80U)
+          pos ++;
+        else
+          utf8_decode(cp, pos, (size_t) (end - pos));
+        code_points.emplace_back(V_integer(cp));
+      }
+      return code_points;
+    }
 
-    size_t offset = 0;
-    while(offset < text.size()) {
+    // This comparison with `true` is by intention, because it may be unset.
+    if(permissive != true)
+      ASTERIA_THROW(("Invalid UTF-8 string"));
+
+    // Copy invalid bytes as is, one by one.
+    code_points.reserve(text.size());
+    while(pos != end) {
       // Try decoding a code point.
       char32_t cp;
-      if(!utf8_decode(cp, text, offset)) {
-        // This comparison with `true` is by intention, because it may be unset.
-        if(permissive != true)
-          ASTERIA_THROW(("Invalid UTF-8 string"));
-
-        cp = text[offset++] & 0xFF;
-      }
+      const char* next = pos;
+      if(utf8_decode(cp, next, (size_t) (end - pos)))
+        pos = next;
+      else
+        cp = (uint8_t) *(pos++);
       code_points.emplace_back(V_integer(cp));
     }
     return code_points;
@@ -1673,31 +2317,31 @@ std_string_PCRE_replace(V_opaque& m, V_string text, V_integer from, optV_integer
   }
 
 opt<pair<V_integer, V_integer>>
-std_string_pcre_find(V_string text, V_integer from, optV_integer length, V_string pattern, optV_array options)
+std_string_pcre_find(Global_Context& global, V_string text, V_integer from, optV_integer length, V_string pattern, optV_array options)
   {
-    PCRE2_Matcher m(pattern, options);
-    return m.find(text, from, length);
+    auto m = do_get_PCRE2_matcher(global, pattern, options);
+    return m->find(text, from, length);
   }
 
 optV_array
-std_string_pcre_match(V_string text, V_integer from, optV_integer length, V_string pattern, optV_array options)
+std_string_pcre_match(Global_Context& global, V_string text, V_integer from, optV_integer length, V_string pattern, optV_array options)
   {
-    PCRE2_Matcher m(pattern, options);
-    return m.match(text, from, length);
+    auto m = do_get_PCRE2_matcher(global, pattern, options);
+    return m->match(text, from, length);
   }
 
 optV_object
-std_string_pcre_named_match(V_string text, V_integer from, optV_integer length, V_string pattern, optV_array options)
+std_string_pcre_named_match(Global_Context& global, V_string text, V_integer from, optV_integer length, V_string pattern, optV_array options)
   {
-    PCRE2_Matcher m(pattern, options);
-    return m.named_match(text, from, length);
+    auto m = do_get_PCRE2_matcher(global, pattern, options);
+    return m->named_match(text, from, length);
   }
 
 V_string
-std_string_pcre_replace(V_string text, V_integer from, optV_integer length, V_string pattern, V_string replacement, optV_array options)
+std_string_pcre_replace(Global_Context& global, V_string text, V_integer from, optV_integer length, V_string pattern, V_string replacement, optV_array options)
   {
-    PCRE2_Matcher m(pattern, options);
-    return m.replace(text, from, length, replacement);
+    auto m = do_get_PCRE2_matcher(global, pattern, options);
+    return m->replace(text, from, length, replacement);
   }
 
 V_string
@@ -2513,7 +3157,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
     result.insert_or_assign(&"pcre_find",
       ASTERIA_BINDING(
         "std.string.pcre_find", "text, [from, [length]], pattern, [options]",
-        Argument_Reader&& reader)
+        Global_Context& global, Argument_Reader&& reader)
       {
         V_string text, patt;
         V_integer from;
@@ -2526,7 +3170,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_find(text, 0, nullopt, patt, opts);
+          return (Value) std_string_pcre_find(global, text, 0, nullopt, patt, opts);
 
         reader.load_state(0);
         reader.required(from);
@@ -2534,14 +3178,14 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_find(text, from, nullopt, patt, opts);
+          return (Value) std_string_pcre_find(global, text, from, nullopt, patt, opts);
 
         reader.load_state(0);
         reader.optional(len);
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_find(text, from, len, patt, opts);
+          return (Value) std_string_pcre_find(global, text, from, len, patt, opts);
 
         reader.throw_no_matching_function_call();
       });
@@ -2549,7 +3193,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
     result.insert_or_assign(&"pcre_match",
       ASTERIA_BINDING(
         "std.string.pcre_match", "text, [from, [length]], pattern, [options]",
-        Argument_Reader&& reader)
+        Global_Context& global, Argument_Reader&& reader)
       {
         V_string text, patt;
         V_integer from;
@@ -2562,7 +3206,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_match(text, 0, nullopt, patt, opts);
+          return (Value) std_string_pcre_match(global, text, 0, nullopt, patt, opts);
 
         reader.load_state(0);
         reader.required(from);
@@ -2570,14 +3214,14 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_match(text, from, nullopt, patt, opts);
+          return (Value) std_string_pcre_match(global, text, from, nullopt, patt, opts);
 
         reader.load_state(0);
         reader.optional(len);
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_match(text, from, len, patt, opts);
+          return (Value) std_string_pcre_match(global, text, from, len, patt, opts);
 
         reader.throw_no_matching_function_call();
       });
@@ -2585,7 +3229,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
     result.insert_or_assign(&"pcre_named_match",
       ASTERIA_BINDING(
         "std.string.pcre_named_match", "text, [from, [length]], pattern, [options]",
-        Argument_Reader&& reader)
+        Global_Context& global, Argument_Reader&& reader)
       {
         V_string text, patt;
         V_integer from;
@@ -2598,7 +3242,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_named_match(text, 0, nullopt, patt, opts);
+          return (Value) std_string_pcre_named_match(global, text, 0, nullopt, patt, opts);
 
         reader.load_state(0);
         reader.required(from);
@@ -2606,14 +3250,14 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_named_match(text, from, nullopt, patt, opts);
+          return (Value) std_string_pcre_named_match(global, text, from, nullopt, patt, opts);
 
         reader.load_state(0);
         reader.optional(len);
         reader.required(patt);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_named_match(text, from, len, patt, opts);
+          return (Value) std_string_pcre_named_match(global, text, from, len, patt, opts);
 
         reader.throw_no_matching_function_call();
       });
@@ -2621,7 +3265,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
     result.insert_or_assign(&"pcre_replace",
       ASTERIA_BINDING(
         "std.string.pcre_replace", "text, [from, [length]], pattern, replacement, [options]",
-        Argument_Reader&& reader)
+        Global_Context& global, Argument_Reader&& reader)
       {
         V_string text, patt, rep;
         V_integer from;
@@ -2635,7 +3279,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(rep);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_replace(text, 0, nullopt, patt, rep, opts);
+          return (Value) std_string_pcre_replace(global, text, 0, nullopt, patt, rep, opts);
 
         reader.load_state(0);
         reader.required(from);
@@ -2644,7 +3288,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(rep);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_replace(text, from, nullopt, patt, rep, opts);
+          return (Value) std_string_pcre_replace(global, text, from, nullopt, patt, rep, opts);
 
         reader.load_state(0);
         reader.optional(len);
@@ -2652,7 +3296,7 @@ create_bindings_string(V_object& result, API_Version /*version*/)
         reader.required(rep);
         reader.optional(opts);
         if(reader.end_overload())
-          return (Value) std_string_pcre_replace(text, from, len, patt, rep, opts);
+          return (Value) std_string_pcre_replace(global, text, from, len, patt, rep, opts);
 
         reader.throw_no_matching_function_call();
       });
@@ -152,6 +152,20 @@ finalize()
     // TODO: Add JIT support.
   }
 
+details_avm_rod::Executor*
+AVM_Rod::
+exchange_executor(const Header* head, Executor* exec) noexcept
+  {
+    // The header is in storage that is owned by the rod, so it is safe to
+    // modify it here.
+    auto qhead = const_cast<Header*>(head);
+
+    if(qhead->meta_ver == 0)
+      return ::std::exchange(qhead->pv_exec, exec);
+    else
+      return ::std::exchange(qhead->pv_meta->exec, exec);
+  }
+
 AIR_Status
 AVM_Rod::
 execute(Executive_Context& ctx) const
@@ -84,6 +84,13 @@ class AVM_Rod
     void
     finalize();
 
+    // Replaces the executor of a node in place, and returns the old one. This
+    // is used by nodes that specialize themselves according to runtime type
+    // feedback, so it may be called by the executor of the same node.
+    static
+    Executor*
+    exchange_executor(const Header* head, Executor* exec) noexcept;
+
     // These are interfaces called by the runtime.
     AIR_Status
     execute(Executive_Context& ctx) const;
@@ -32,6 +32,22 @@ do_reallocate(uint32_t nbkt)
     for(auto q = (Bucket*) minfo.data;  q != new_eptr;  ++q)
       q->next = nullptr;
 
+    // Allocate the slot table. As the load factor is kept <= 0.5, there are
+    // never more slotted elements than half the number of buckets.
+    ::rocket::xmeminfo sinfo;
+    sinfo.element_size = sizeof(Bucket*);
+    sinfo.count = minfo.count / 2 + 1;
+    try {
+      ::rocket::xmemalloc(sinfo);
+    }
+    catch(...) {
+      // Free the bucket array, which is not owned by anything yet.
+      minfo.count ++;
+      ::rocket::xmemfree(minfo);
+      throw;
+    }
+    auto new_sptr = (Bucket**) sinfo.data;
+
     if(this->m_bptr) {
       // Move-construct old elements into the new table.
       auto eptr = this->m_bptr + this->m_nbkt;
@@ -45,6 +61,9 @@ do_reallocate(uint32_t nbkt)
         ROCKET_ASSERT(qrel);
         bcopy(qrel->key, eptr->next->key);
         bcopy(qrel->ref, eptr->next->ref);
+        qrel->slot = eptr->next->slot;
+        if(qrel->slot != no_slot)
+          new_sptr[qrel->slot] = qrel;
         qrel->attach(*new_eptr);
         eptr->next->detach();
       }
@@ -54,10 +73,16 @@ do_reallocate(uint32_t nbkt)
       rinfo.data = this->m_bptr;
       rinfo.count = this->m_nbkt;
       ::rocket::xmemfree(rinfo);
+
+      rinfo.element_size = sizeof(Bucket*);
+      rinfo.data = this->m_sptr;
+      rinfo.count = this->m_nbkt / 2 + 1;
+      ::rocket::xmemfree(rinfo);
     }
 
     this->m_bptr = (Bucket*) minfo.data;
     this->m_nbkt = (uint32_t) minfo.count;
+    this->m_sptr = new_sptr;
   }
 
 ROCKET_FLATTEN
@@ -80,8 +105,15 @@ do_deallocate() noexcept
     rinfo.count = this->m_nbkt;
     ::rocket::xmemfree(rinfo);
 
+    rinfo.element_size = sizeof(Bucket*);
+    rinfo.data = this->m_sptr;
+    rinfo.count = this->m_nbkt / 2 + 1;
+    ::rocket::xmemfree(rinfo);
+
     this->m_bptr = nullptr;
     this->m_nbkt = 0;
+    this->m_sptr = nullptr;
+    this->m_nslot = 0;
     ROCKET_ASSERT(this->m_size == 0);
   }
 
@@ -93,6 +125,9 @@ do_erase_range(uint32_t tpos, uint32_t tn) noexcept
     for(auto qbkt = this->m_bptr + tpos;  qbkt != this->m_bptr + tpos + tn;  ++qbkt)
       if(*qbkt) {
         // Destroy this bucket.
+        if(qbkt->slot < this->m_nslot)
+          this->do_erase_slot(qbkt->slot);
+
         this->m_size --;
         qbkt->detach();
         ::rocket::destroy(&(qbkt->key));
@@ -116,14 +151,31 @@ do_erase_range(uint32_t tpos, uint32_t tn) noexcept
         ROCKET_ASSERT(qrel);
         bcopy(qrel->key, r.key);
         bcopy(qrel->ref, r.ref);
+        qrel->slot = r.slot;
+        if(qrel->slot < this->m_nslot)
+          this->m_sptr[qrel->slot] = qrel;
         qrel->attach(*eptr);
         return false;
       });
   }
 
+void
+Reference_Dictionary::
+do_erase_slot(uint32_t slot) noexcept
+  {
+    // Shift all subsequent elements forward. This is slow, but only global
+    // references are ever erased.
+    ROCKET_ASSERT(slot < this->m_nslot);
+    for(uint32_t k = slot + 1;  k < this->m_nslot;  ++k) {
+      this->m_sptr[k - 1] = this->m_sptr[k];
+      this->m_sptr[k - 1]->slot = k - 1;
+    }
+    this->m_nslot --;
+  }
+
 Reference&
 Reference_Dictionary::
-insert(phsh_stringR key, bool* newly_opt)
+insert(phsh_stringR key, bool* newly_opt, bool slotted)
   {
     if(this->m_size >= this->m_nbkt / 2)
       this->do_reallocate(this->m_size * 3 | 17);
@@ -145,6 +197,14 @@ insert(phsh_stringR key, bool* newly_opt)
     ::rocket::construct(&(qbkt->ref));
     qbkt->attach(*eptr);
     this->m_size ++;
+
+    // Assign a slot if requested.
+    qbkt->slot = no_slot;
+    if(slotted) {
+      qbkt->slot = this->m_nslot;
+      this->m_sptr[this->m_nslot] = qbkt;
+      this->m_nslot ++;
+    }
     return qbkt->ref;
   }
 
@@ -17,6 +17,14 @@ class Reference_Dictionary
     uint32_t m_nbkt = 0;
     uint32_t m_size = 0;
 
+    // This is a flat array of elements in insertion order, indexed by slot.
+    Bucket** m_sptr = nullptr;
+    uint32_t m_nslot = 0;
+
+  public:
+    // This is returned by `find_slot()` for elements that have no slot.
+    static constexpr uint32_t no_slot = UINT32_MAX;
+
   public:
     constexpr Reference_Dictionary() noexcept = default;
 
@@ -38,6 +46,8 @@ class Reference_Dictionary
         ::std::swap(this->m_bptr, other.m_bptr);
         ::std::swap(this->m_nbkt, other.m_nbkt);
         ::std::swap(this->m_size, other.m_size);
+        ::std::swap(this->m_sptr, other.m_sptr);
+        ::std::swap(this->m_nslot, other.m_nslot);
         return *this;
       }
 
@@ -51,8 +61,11 @@ class Reference_Dictionary
     void
     do_erase_range(uint32_t tpos, uint32_t tn) noexcept;
 
-    Reference*
-    do_xfind_opt(phsh_stringR key) const noexcept
+    void
+    do_erase_slot(uint32_t slot) noexcept;
+
+    Bucket*
+    do_xfind_bucket_opt(phsh_stringR key) const noexcept
       {
         if(this->m_nbkt == 0)
           return nullptr;
@@ -64,7 +77,14 @@ class Reference_Dictionary
 
         // The load factor is kept <= 0.5 so a bucket is always returned. If
         // probing has stopped on an empty bucket, then there is no match.
-        return *qbkt ? &(qbkt->ref) : nullptr;
+        return *qbkt ? qbkt : nullptr;
+      }
+
+    Reference*
+    do_xfind_opt(phsh_stringR key) const noexcept
+      {
+        auto qbkt = this->do_xfind_bucket_opt(key);
+        return qbkt ? &(qbkt->ref) : nullptr;
       }
 
   public:
@@ -85,6 +105,8 @@ class Reference_Dictionary
     void
     clear() noexcept
       {
+        // All slots are discarded at once.
+        this->m_nslot = 0;
         this->do_erase_range(0, this->m_nbkt);
       }
 
@@ -100,8 +122,34 @@ class Reference_Dictionary
         return this->do_xfind_opt(key);
       }
 
+    // Looks for an element by its slot. If the element in `slot` does not
+    // have the key `key`, a normal lookup is performed. `slot` may be any
+    // value, including `no_slot`.
+    const Reference*
+    find_opt(uint32_t slot, phsh_stringR key) const noexcept
+      {
+        if(ROCKET_EXPECT(slot < this->m_nslot)) {
+          auto qbkt = this->m_sptr[slot];
+          if(ROCKET_EXPECT(qbkt->key == key))
+            return &(qbkt->ref);
+        }
+        return this->do_xfind_opt(key);
+      }
+
+    // Gets the slot of an element, or `no_slot` if it is not found or has
+    // not been assigned a slot.
+    uint32_t
+    find_slot(phsh_stringR key) const noexcept
+      {
+        auto qbkt = this->do_xfind_bucket_opt(key);
+        return qbkt ? qbkt->slot : no_slot;
+      }
+
+    // Inserts an element. If `slotted` is set and a new element is created,
+    // it is assigned the next slot, which equals the number of slotted
+    // elements inserted before it.
     Reference&
-    insert(phsh_stringR key, bool* newly_opt);
+    insert(phsh_stringR key, bool* newly_opt, bool slotted);
 
     bool
     erase(phsh_stringR key, Reference* refp_opt) noexcept;
@@ -0,0 +1,266 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "variable_arena.hpp"
+#include "../runtime/variable.hpp"
+#include "../../rocket/mutex.hpp"
+#include "../../rocket/atomic.hpp"
+#include "../utils.hpp"
+namespace asteria {
+namespace {
+
+struct alignas(::std::max_align_t) Block_Header
+  {
+    void* slab_opt;
+  };
+
+constexpr size_t s_block_size = (sizeof(Block_Header) + sizeof(Variable) + alignof(Block_Header) - 1)
+                                / alignof(Block_Header) * alignof(Block_Header);
+
+constexpr size_t s_slab_size = 65536;
+
+}  // namespace
+
+struct alignas(::std::max_align_t) Variable_Arena::Slab
+  {
+    State* state;
+    Slab* prev;
+    Slab* next;
+    void* free;  // list of freed blocks in this slab
+    size_t nused;
+  };
+
+struct Variable_Arena::State
+  {
+    // Slabs that have freed blocks precede those that have none, so a freed
+    // block can always be found in the first slab, if any. These are only
+    // accessed by the thread that allocates from the arena.
+    Slab* head = nullptr;
+    Slab* tail = nullptr;
+    Slab* bump_slab = nullptr;  // unused storage is carved from this slab
+    char* bump = nullptr;
+    char* bump_end = nullptr;
+    size_t nslabs = 0;
+    size_t nused = 0;
+
+    // Blocks are freed onto this list, which is drained when blocks are
+    // allocated. After the arena has been destroyed, it is closed by storing
+    // a pointer to this state, and blocks are freed with the mutex locked.
+    ::rocket::atomic_acq_rel<void*> freed;
+    ::rocket::mutex mutex;
+
+    void
+    unlink(Slab* slab) noexcept
+      {
+        (slab->prev ? slab->prev->next : this->head) = slab->next;
+        (slab->next ? slab->next->prev : this->tail) = slab->prev;
+      }
+
+    void
+    push_front(Slab* slab) noexcept
+      {
+        slab->prev = nullptr;
+        slab->next = this->head;
+        (this->head ? this->head->prev : this->tail) = slab;
+        this->head = slab;
+      }
+
+    void
+    push_back(Slab* slab) noexcept
+      {
+        slab->prev = this->tail;
+        slab->next = nullptr;
+        (this->tail ? this->tail->next : this->head) = slab;
+        this->tail = slab;
+      }
+
+    void
+    release(Slab* slab) noexcept
+      {
+        this->unlink(slab);
+        this->nslabs --;
+        ::operator delete(slab);
+      }
+
+    void
+    put_block(void* ptr) noexcept
+      {
+        auto slab = (Slab*) ((Block_Header*) ptr - 1)->slab_opt;
+        slab->nused --;
+        this->nused --;
+
+        if((slab->nused == 0) && (slab != this->bump_slab)) {
+          // Release an empty slab with its freed blocks.
+          this->release(slab);
+          return;
+        }
+
+        // Put the block onto the free list of its slab. If this is the first
+        // freed block, move the slab to the beginning.
+        *(void**) ptr = slab->free;
+        slab->free = ptr;
+        if(!*(void**) ptr && (slab != this->head)) {
+          this->unlink(slab);
+          this->push_front(slab);
+        }
+      }
+
+    void
+    drain(void* next) noexcept
+      {
+        while(auto ptr = next) {
+          next = *(void**) ptr;
+          this->put_block(ptr);
+        }
+      }
+
+    void
+    drain_freed() noexcept
+      {
+        if(this->freed.load())
+          this->drain(this->freed.xchg(nullptr));
+      }
+  };
+
+Variable_Arena::
+~Variable_Arena()
+  {
+    auto state = this->m_state;
+    if(!state)
+      return;
+
+    // Close the list of freed blocks. Blocks that are freed hereafter will
+    // wait for the mutex.
+    ::rocket::mutex::unique_lock lock(state->mutex);
+    state->drain(state->freed.xchg(state));
+    state->bump_slab = nullptr;
+
+    // Release slabs that are not in use. Others are orphaned, and will be
+    // released by `deallocate()`, along with the state.
+    auto next = state->head;
+    while(auto slab = next) {
+      next = slab->next;
+      if(slab->nused == 0)
+        state->release(slab);
+    }
+
+    if(state->nslabs != 0)
+      return;
+
+    lock.unlock();
+    delete state;
+  }
+
+size_t
+Variable_Arena::
+count_slabs() const noexcept
+  {
+    auto state = this->m_state;
+    if(!state)
+      return 0;
+
+    state->drain_freed();
+    return state->nslabs;
+  }
+
+size_t
+Variable_Arena::
+count_variables() const noexcept
+  {
+    auto state = this->m_state;
+    if(!state)
+      return 0;
+
+    state->drain_freed();
+    return state->nused;
+  }
+
+void*
+Variable_Arena::
+allocate()
+  {
+    if(!this->m_state)
+      this->m_state = new State;
+
+    auto state = this->m_state;
+    state->drain_freed();
+
+    if(auto slab = state->head)
+      if(auto ptr = slab->free) {
+        // Reuse the most recently freed block in the first slab. If it has
+        // no more freed blocks, move it to the end.
+        slab->free = *(void**) ptr;
+        if(!slab->free && (slab != state->tail)) {
+          state->unlink(slab);
+          state->push_back(slab);
+        }
+        slab->nused ++;
+        state->nused ++;
+        return ptr;
+      }
+
+    if(state->bump == state->bump_end) {
+      // Allocate a new slab, and carve blocks from it in order. The previous
+      // one may be released when it becomes empty.
+      auto slab = (Slab*) ::operator new(s_slab_size);
+      slab->state = state;
+      slab->free = nullptr;
+      slab->nused = 0;
+      state->push_back(slab);
+      state->nslabs ++;
+      state->bump_slab = slab;
+      state->bump = (char*) (slab + 1);
+      state->bump_end = state->bump + (s_slab_size - sizeof(Slab)) / s_block_size * s_block_size;
+    }
+
+    auto head = (Block_Header*) state->bump;
+    state->bump += s_block_size;
+    head->slab_opt = state->bump_slab;
+    state->bump_slab->nused ++;
+    state->nused ++;
+    return head + 1;
+  }
+
+void*
+Variable_Arena::
+allocate_unpooled(size_t size)
+  {
+    auto head = (Block_Header*) ::operator new(sizeof(Block_Header) + size);
+    head->slab_opt = nullptr;
+    return head + 1;
+  }
+
+void
+Variable_Arena::
+deallocate(void* ptr) noexcept
+  {
+    if(!ptr)
+      return;
+
+    auto head = (Block_Header*) ptr - 1;
+    auto slab = (Slab*) head->slab_opt;
+    if(!slab)
+      return ::operator delete(head);
+
+    // This may be called on any thread, so the block is pushed onto the list
+    // of freed blocks without locking, unless the list has been closed.
+    auto state = slab->state;
+    void* next = state->freed.load();
+    while(next != state) {
+      *(void**) ptr = next;
+      if(state->freed.cmpxchg_weak(next, ptr))
+        return;
+    }
+
+    // The arena has been destroyed. The state is released with its last slab.
+    ::rocket::mutex::unique_lock lock(state->mutex);
+    state->put_block(ptr);
+    if(state->nslabs != 0)
+      return;
+
+    lock.unlock();
+    delete state;
+  }
+
+}  // namespace asteria
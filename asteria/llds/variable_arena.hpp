@@ -0,0 +1,56 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LLDS_VARIABLE_ARENA_
+#define ASTERIA_LLDS_VARIABLE_ARENA_
+
+#include "../fwd.hpp"
+namespace asteria {
+
+// This allocates storage for variables from slabs. Each block of storage is
+// preceded by a header that points to its slab, or is null if the block has
+// been allocated from the heap. Freed blocks are put onto a list in their
+// slab, from which they are reused. A slab is released as soon as it becomes
+// empty, except the one that new blocks are carved from. Slabs that still
+// contain variables when the arena is destroyed are released when their last
+// variables are destroyed. Storage is allocated by the thread that owns the
+// arena, but variables may be destroyed by any thread, so freed blocks are
+// pushed onto a lock-free list, which the owner drains when it allocates.
+class Variable_Arena
+  {
+  private:
+    struct Slab;
+    struct State;
+    State* m_state = nullptr;  // allocated with the first slab
+
+  public:
+    constexpr Variable_Arena() noexcept = default;
+
+  public:
+    Variable_Arena(const Variable_Arena&) = delete;
+    Variable_Arena& operator=(const Variable_Arena&) & = delete;
+    ~Variable_Arena();
+
+    size_t
+    count_slabs() const noexcept;
+
+    size_t
+    count_variables() const noexcept;
+
+    // Allocates storage for a variable from this arena.
+    void*
+    allocate();
+
+    // Allocates storage for a variable from the heap.
+    static
+    void*
+    allocate_unpooled(size_t size);
+
+    // Frees storage that has been allocated with either function above.
+    static
+    void
+    deallocate(void* ptr) noexcept;
+  };
+
+}  // namespace asteria
+#endif
@@ -4,165 +4,219 @@
 #include "../xprecompiled.hpp"
 #include "variable_hashmap.hpp"
 #include "../utils.hpp"
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
 namespace asteria {
+namespace {
+
+inline
+uint32_t
+do_probe_origin(uint32_t nslot, const void* key) noexcept
+  {
+    // Pointers are aligned, so take higher bits of the product.
+    uint64_t hval = (uint64_t) (uintptr_t) key * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t) (hval >> 32) & (nslot - 1);
+  }
+
+inline
+uint32_t
+do_probe(const void* const* keys, uint32_t nslot, const void* key) noexcept
+  {
+    // Find either `key` or an empty slot using linear probing. Keys are
+    // compared in blocks, unless a block would wrap around the end of the
+    // table. The table shall not be full.
+    uint32_t k = do_probe_origin(nslot, key);
+    for(;;) {
+#ifdef __AVX2__
+      while(k + 4 <= nslot) {
+        __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + k));
+        __m256i m = _mm256_cmpeq_epi64(t, _mm256_set1_epi64x((int64_t) (uintptr_t) key));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi64(t, _mm256_setzero_si256()));
+        uint32_t bits = (uint32_t) _mm256_movemask_pd(_mm256_castsi256_pd(m));
+        if(bits != 0)
+          return k + ROCKET_TZCNT32(bits);
+        k = (k + 4) & (nslot - 1);
+      }
+#elif defined __SSE2__
+      while(k + 2 <= nslot) {
+        // SSE2 has no 64-bit comparison, so compare both halves.
+        __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + k));
+        __m128i m = _mm_cmpeq_epi32(t, _mm_set1_epi64x((int64_t) (uintptr_t) key));
+        __m128i z = _mm_cmpeq_epi32(t, _mm_setzero_si128());
+        m = _mm_and_si128(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        z = _mm_and_si128(z, _mm_shuffle_epi32(z, _MM_SHUFFLE(2, 3, 0, 1)));
+        uint32_t bits = (uint32_t) _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(m, z)));
+        if(bits != 0)
+          return k + ROCKET_TZCNT32(bits);
+        k = (k + 2) & (nslot - 1);
+      }
+#endif
+      if((keys[k] == key) || !keys[k])
+        return k;
+      k = (k + 1) & (nslot - 1);
+    }
+  }
+
+}  // namespace
 
-ROCKET_FLATTEN
 void
 Variable_HashMap::
-do_reallocate(uint32_t nbkt)
+do_reallocate(uint32_t nslot)
   {
-    if(nbkt >= 0x7FFE0000U / sizeof(Bucket))
+    if(nslot >= 0x40000000U)
       throw ::std::bad_alloc();
 
-    ROCKET_ASSERT(nbkt >= this->m_size * 2);
+    ROCKET_ASSERT(nslot >= this->m_size * 2);
+    ROCKET_ASSERT((nslot & (nslot - 1)) == 0);
     ::rocket::xmeminfo minfo;
-    minfo.element_size = sizeof(Bucket);
-    minfo.count = nbkt + 1;
+    minfo.element_size = sizeof(void*);
+    minfo.count = nslot * 2U;
     ::rocket::xmemalloc(minfo);
 
-    // Initialize the circular list head. This node may be read, but it is never
-    // written to, and needs no cleanup.
-    minfo.count --;
-    auto new_eptr = (Bucket*) minfo.data + minfo.count;
-    bfill(*new_eptr, 0);
-    new_eptr->prev = new_eptr;
-    new_eptr->next = new_eptr;
-
-    // Initialize the other nodes.
-    for(auto q = (Bucket*) minfo.data;  q != new_eptr;  ++q)
-      q->next = nullptr;
-
-    if(this->m_bptr) {
-      // Move-construct old elements into the new table.
-      auto eptr = this->m_bptr + this->m_nbkt;
-      while(eptr->next != eptr) {
-        // Look for a new bucket for this element. Uniqueness is implied.
-        size_t orel = ::rocket::probe_origin(minfo.count, (uintptr_t) eptr->next->key);
-        auto qrel = ::rocket::linear_probe((Bucket*) minfo.data, orel, orel, minfo.count,
-                        [&](const Bucket&) { return false;  });
-
-        // Relocate the value into the new bucket.
-        ROCKET_ASSERT(qrel);
-        qrel->key = eptr->next->key;
-        bcopy(qrel->var_opt, eptr->next->var_opt);
-        qrel->attach(*new_eptr);
-        eptr->next->detach();
-      }
+    // Only keys have to be initialized.
+    auto new_keys = (const void**) minfo.data;
+    auto new_vars = (Variable**) (new_keys + nslot);
+    ::std::memset(new_keys, 0, nslot * sizeof(void*));
+
+    if(this->m_keys) {
+      // Move old elements into the new table. Uniqueness is implied.
+      for(uint32_t k = 0;  k != this->m_nslot;  ++k)
+        if(this->m_keys[k]) {
+          uint32_t t = do_probe(new_keys, nslot, this->m_keys[k]);
+          new_keys[t] = this->m_keys[k];
+          new_vars[t] = this->m_vars[k];
+        }
 
       ::rocket::xmeminfo rinfo;
-      rinfo.element_size = sizeof(Bucket);
-      rinfo.data = this->m_bptr;
-      rinfo.count = this->m_nbkt;
+      rinfo.element_size = sizeof(void*);
+      rinfo.data = this->m_keys;
+      rinfo.count = this->m_nslot * 2U;
       ::rocket::xmemfree(rinfo);
     }
 
-    this->m_bptr = (Bucket*) minfo.data;
-    this->m_nbkt = (uint32_t) minfo.count;
+    this->m_keys = new_keys;
+    this->m_vars = new_vars;
+    this->m_nslot = nslot;
+    this->m_cursor = 0;
   }
 
-ROCKET_FLATTEN
 void
 Variable_HashMap::
 do_deallocate() noexcept
   {
-    auto eptr = this->m_bptr + this->m_nbkt;
-    while(eptr->next != eptr) {
-      // Destroy this bucket.
-      this->m_size --;
-      ::rocket::destroy(&(eptr->next->var_opt));
-      eptr->next->detach();
-    }
-
     ::rocket::xmeminfo rinfo;
-    rinfo.element_size = sizeof(Bucket);
-    rinfo.data = this->m_bptr;
-    rinfo.count = this->m_nbkt;
+    rinfo.element_size = sizeof(void*);
+    rinfo.data = this->m_keys;
+    rinfo.count = this->m_nslot * 2U;
     ::rocket::xmemfree(rinfo);
 
-    this->m_bptr = nullptr;
-    this->m_nbkt = 0;
-    ROCKET_ASSERT(this->m_size == 0);
+    this->m_keys = nullptr;
+    this->m_vars = nullptr;
+    this->m_size = 0;
+    this->m_nslot = 0;
+    this->m_cursor = 0;
   }
 
 void
 Variable_HashMap::
-do_erase_range(uint32_t tpos, uint32_t tn) noexcept
+do_clear() noexcept
   {
-    auto eptr = this->m_bptr + this->m_nbkt;
-    for(auto qbkt = this->m_bptr + tpos;  qbkt != this->m_bptr + tpos + tn;  ++qbkt)
-      if(*qbkt) {
-        // Destroy this bucket.
-        this->m_size --;
-        qbkt->detach();
-        ::rocket::destroy(&(qbkt->var_opt));
-      }
+    // Free a large table, so it will not be scanned again when it is used
+    // for fewer elements. It will grow again as necessary.
+    if(this->m_nslot > 1024) {
+      this->do_deallocate();
+      return;
+    }
+
+    ::std::memset(this->m_keys, 0, this->m_nslot * sizeof(void*));
+    this->m_size = 0;
+    this->m_cursor = 0;
+  }
+
+void
+Variable_HashMap::
+do_erase_slot(uint32_t k) noexcept
+  {
+    ROCKET_ASSERT(this->m_keys[k]);
+    this->m_size --;
+
+    // Shift subsequent elements backward, unless they would be moved before
+    // their origins. This avoids tombstones.
+    uint32_t mask = this->m_nslot - 1;
+    uint32_t r = k;
+    for(;;) {
+      r = (r + 1) & mask;
+      if(!this->m_keys[r])
+        break;
 
-    // Relocate elements that are not placed in their immediate locations.
-    ::rocket::linear_probe(
-      this->m_bptr, tpos, tpos + tn, this->m_nbkt,
-      [&](Bucket& r) {
-        // Clear this bucket temporarily.
-        ROCKET_ASSERT(r);
-        r.detach();
-
-        // Look for a new bucket for this element. Uniqueness is implied.
-        size_t orel = ::rocket::probe_origin(this->m_nbkt, (uintptr_t) r.key);
-        auto qrel = ::rocket::linear_probe(this->m_bptr, orel, orel, this->m_nbkt,
-                        [&](const Bucket&) { return false;  });
-
-        // Relocate the value into the new bucket.
-        ROCKET_ASSERT(qrel);
-        qrel->key = r.key;
-        bcopy(qrel->var_opt, r.var_opt);
-        qrel->attach(*eptr);
-        return false;
-      });
+      uint32_t orig = do_probe_origin(this->m_nslot, this->m_keys[r]);
+      if(((r - orig) & mask) < ((r - k) & mask))
+        continue;
+
+      this->m_keys[k] = this->m_keys[r];
+      this->m_vars[k] = this->m_vars[r];
+      k = r;
+    }
+
+    this->m_keys[k] = nullptr;
   }
 
 bool
 Variable_HashMap::
-insert(const void* key, const refcnt_ptr<Variable>& var_opt)
+find(const void* key, Variable** varp_opt) const noexcept
   {
-    if(this->m_size >= this->m_nbkt / 2)
-      this->do_reallocate(this->m_size * 3 | 5);
+    if(this->m_size == 0)
+      return false;
+
+    uint32_t k = do_probe(this->m_keys, this->m_nslot, key);
+    if(!this->m_keys[k])
+      return false;
+
+    if(varp_opt)
+      *varp_opt = this->m_vars[k];
+    return true;
+  }
 
-    // Find a bucket using linear probing.
-    size_t orig = ::rocket::probe_origin(this->m_nbkt, (uintptr_t) key);
-    auto qbkt = ::rocket::linear_probe(this->m_bptr, orig, orig, this->m_nbkt,
-                    [&](const Bucket& r) { return r.key == key;  });
+bool
+Variable_HashMap::
+insert(const void* key, Variable* var_opt)
+  {
+    ROCKET_ASSERT(key);
+    if(this->m_size >= this->m_nslot / 2)
+      this->do_reallocate(::rocket::max(this->m_nslot * 2U, 8U));
 
-    if(*qbkt)
+    uint32_t k = do_probe(this->m_keys, this->m_nslot, key);
+    if(this->m_keys[k])
       return false;
 
-    // Construct a new element.
-    auto eptr = this->m_bptr + this->m_nbkt;
-    qbkt->key = key;
-    ::rocket::construct(&(qbkt->var_opt), var_opt);
-    qbkt->attach(*eptr);
+    this->m_keys[k] = key;
+    this->m_vars[k] = var_opt;
     this->m_size ++;
     return true;
   }
 
 bool
 Variable_HashMap::
-erase(const void* key, refcnt_ptr<Variable>* varp_opt) noexcept
+erase(const void* key, Variable** varp_opt) noexcept
   {
     if(this->m_size == 0)
       return false;
 
-    // Find a bucket using linear probing.
-    size_t orig = ::rocket::probe_origin(this->m_nbkt, (uintptr_t) key);
-    auto qbkt = ::rocket::linear_probe(this->m_bptr, orig, orig, this->m_nbkt,
-                    [&](const Bucket& r) { return r.key == key;  });
-
-    if(!*qbkt)
+    uint32_t k = do_probe(this->m_keys, this->m_nslot, key);
+    if(!this->m_keys[k])
       return false;
 
     if(varp_opt)
-      *varp_opt = move(qbkt->var_opt);
+      *varp_opt = this->m_vars[k];
 
-    // Destroy this element.
-    this->do_erase_range((uint32_t) (qbkt - this->m_bptr), 1);
+    this->do_erase_slot(k);
+
+    if((this->m_size == 0) && (this->m_nslot > 1024))
+      this->do_deallocate();
     return true;
   }
 
@@ -173,29 +227,38 @@ merge_into(Variable_HashMap& other) const
     if((this == &other) || (this->m_size == 0))
       return;
 
-    auto eptr = this->m_bptr + this->m_nbkt;
-    for(auto qbkt = eptr->next;  qbkt != eptr;  qbkt = qbkt->next)
-      if(qbkt->var_opt)
-        other.insert(qbkt->key, qbkt->var_opt);
+    for(uint32_t k = 0;  k != this->m_nslot;  ++k)
+      if(this->m_keys[k] && this->m_vars[k])
+        other.insert(this->m_keys[k], this->m_vars[k]);
   }
 
 bool
 Variable_HashMap::
-extract_variable(refcnt_ptr<Variable>& var) noexcept
+extract_variable(Variable*& var) noexcept
   {
-    if(this->m_size == 0)
-      return false;
+    // Scan slots cyclically, starting from where the last call stopped. As
+    // new elements may be inserted anywhere, this has to wrap around.
+    uint32_t k = this->m_cursor;
+    while(this->m_size != 0) {
+      if(!this->m_keys[k]) {
+        k = (k + 1) & (this->m_nslot - 1);
+        continue;
+      }
 
-    auto eptr = this->m_bptr + this->m_nbkt;
-    while(eptr->next->var_opt == nullptr)
-      if(eptr->next == eptr)
-        return false;
-      else
-        this->do_erase_range((uint32_t) (eptr->next - this->m_bptr), 1);
+      var = this->m_vars[k];
+      this->do_erase_slot(k);
 
-    var.swap(eptr->next->var_opt);
-    this->do_erase_range((uint32_t) (eptr->next - this->m_bptr), 1);
-    return true;
+      if(var) {
+        this->m_cursor = k;
+        return true;
+      }
+    }
+
+    if(this->m_nslot > 1024)
+      this->do_deallocate();
+
+    this->m_cursor = 0;
+    return false;
   }
 
 }  // namespace asteria
@@ -6,16 +6,21 @@
 
 #include "../fwd.hpp"
 #include "../runtime/variable.hpp"
-#include "../details/variable_hashmap.ipp"
 namespace asteria {
 
+// This is a flat hash map with open addressing. Keys and values are stored in
+// two arrays, so keys can be compared in blocks. A null key denotes an empty
+// slot. Neither keys nor variables are owned by the map, so no reference
+// counting happens here; users that store variables beyond a garbage
+// collection cycle have to manage their references by hand.
 class Variable_HashMap
   {
   private:
-    using Bucket = details_variable_hashmap::Bucket;
-    Bucket* m_bptr = nullptr;
+    const void** m_keys = nullptr;
+    Variable** m_vars = nullptr;
     uint32_t m_size = 0;
-    uint32_t m_nbkt = 0;
+    uint32_t m_nslot = 0;  // zero or a power of two
+    uint32_t m_cursor = 0;  // where `extract_variable()` starts
 
   public:
     constexpr Variable_HashMap() noexcept = default;
@@ -35,26 +40,31 @@ class Variable_HashMap
     Variable_HashMap&
     swap(Variable_HashMap& other) noexcept
       {
-        ::std::swap(this->m_bptr, other.m_bptr);
+        ::std::swap(this->m_keys, other.m_keys);
+        ::std::swap(this->m_vars, other.m_vars);
         ::std::swap(this->m_size, other.m_size);
-        ::std::swap(this->m_nbkt, other.m_nbkt);
+        ::std::swap(this->m_nslot, other.m_nslot);
+        ::std::swap(this->m_cursor, other.m_cursor);
         return *this;
       }
 
   private:
     void
-    do_reallocate(uint32_t nbkt);
+    do_reallocate(uint32_t nslot);
 
     void
     do_deallocate() noexcept;
 
     void
-    do_erase_range(uint32_t tpos, uint32_t tn) noexcept;
+    do_clear() noexcept;
+
+    void
+    do_erase_slot(uint32_t k) noexcept;
 
   public:
     ~Variable_HashMap()
       {
-        if(this->m_bptr)
+        if(this->m_keys)
           this->do_deallocate();
       }
 
@@ -69,20 +79,36 @@ class Variable_HashMap
     void
     clear() noexcept
       {
-        this->do_erase_range(0, this->m_nbkt);
+        if(this->m_size != 0)
+          this->do_clear();
       }
 
+    // These functions return whether `key` has been found. The variable that
+    // is associated with it may be null.
+    bool
+    find(const void* key, Variable** varp_opt = nullptr) const noexcept;
+
     bool
-    insert(const void* key, const refcnt_ptr<Variable>& var_opt);
+    insert(const void* key, Variable* var_opt);
 
     bool
-    erase(const void* key, refcnt_ptr<Variable>* varp_opt = nullptr) noexcept;
+    erase(const void* key, Variable** varp_opt = nullptr) noexcept;
 
+    // These functions ignore keys that are associated with null variables.
     void
     merge_into(Variable_HashMap& other) const;
 
     bool
-    extract_variable(refcnt_ptr<Variable>& var) noexcept;
+    extract_variable(Variable*& var) noexcept;
+
+    template<typename xFunc>
+    void
+    for_each(xFunc&& func) const
+      {
+        for(uint32_t k = 0;  k != this->m_nslot;  ++k)
+          if(this->m_keys[k] && this->m_vars[k])
+            func(this->m_vars[k]);
+      }
   };
 
 inline
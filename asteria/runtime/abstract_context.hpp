@@ -14,9 +14,17 @@ class Abstract_Context
   {
   private:
     // This stores all named references (variables, parameters, etc.) of
-    // this context.
+    // this context. Names that are not built-in are assigned slots in the
+    // order in which they are declared, and as an analytic context sees
+    // declarations in the same order as the executive context that it
+    // describes, a slot can be determined when code is generated.
     mutable Reference_Dictionary m_named_refs;
 
+    static
+    bool
+    do_is_builtin_name(phsh_stringR name) noexcept
+      { return name.rdstr().starts_with("__");  }
+
   protected:
     Abstract_Context() noexcept = default;
 
@@ -50,7 +58,8 @@ class Abstract_Context
     Reference&
     do_mut_named_reference(Reference* hint_opt, phsh_stringR name) const
       {
-        return hint_opt ? *hint_opt : this->m_named_refs.insert(name, nullptr);
+        return hint_opt ? *hint_opt
+                 : this->m_named_refs.insert(name, nullptr, !do_is_builtin_name(name));
       }
 
     void
@@ -72,7 +81,7 @@ class Abstract_Context
     get_named_reference_opt(phsh_stringR name) const
       {
         auto qref = this->m_named_refs.find_opt(name);
-        if(!qref && name.rdstr().starts_with("__")) {
+        if(!qref && do_is_builtin_name(name)) {
           // Create a lazy reference. Built-in references such as `__func`
           // are only created when they are mentioned.
           qref = this->do_create_lazy_reference_opt(nullptr, name);
@@ -80,12 +89,32 @@ class Abstract_Context
         return qref;
       }
 
+    // This is the same as above, but takes the slot of `name` as a hint, which
+    // is usually an index into a flat array. If the slot does not denote the
+    // same name, a hash lookup is performed instead.
+    const Reference*
+    get_named_reference_opt(uint32_t slot, phsh_stringR name) const
+      {
+        auto qref = this->m_named_refs.find_opt(slot, name);
+        if(!qref && do_is_builtin_name(name))
+          qref = this->do_create_lazy_reference_opt(nullptr, name);
+        return qref;
+      }
+
+    // Gets the slot of a named reference. If the name is not found or is
+    // built-in, `Reference_Dictionary::no_slot` is returned.
+    uint32_t
+    get_named_slot(phsh_stringR name) const noexcept
+      {
+        return this->m_named_refs.find_slot(name);
+      }
+
     Reference&
     insert_named_reference(phsh_stringR name)
       {
         bool newly = false;
-        auto& ref = this->m_named_refs.insert(name, &newly);
-        if(newly && name.rdstr().starts_with("__")) {
+        auto& ref = this->m_named_refs.insert(name, &newly, !do_is_builtin_name(name));
+        if(newly && do_is_builtin_name(name)) {
           // If a built-in reference has been inserted, it may have a default
           // value, so initialize it. DO NOT CALL THIS FUNCTION INSIDE
           // `do_create_lazy_reference_opt()`, as it will result in infinite
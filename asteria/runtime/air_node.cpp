@@ -15,6 +15,7 @@
 #include "ptc_arguments.hpp"
 #include "module_loader.hpp"
 #include "air_optimizer.hpp"
+#include "air_serializer.hpp"
 #include "../compiler/token_stream.hpp"
 #include "../compiler/statement_sequence.hpp"
 #include "../compiler/statement.hpp"
@@ -49,6 +50,21 @@ do_return_rebound_opt(bool dirty, xNode&& bound)
     return res;
   }
 
+const Abstract_Context&
+do_get_context_at_depth(const Abstract_Context& ctx, uint32_t depth, phsh_stringR name)
+  {
+    // Code that has been loaded from a file may denote any depth, so it is
+    // checked against the contexts that actually enclose it.
+    const Abstract_Context* qctx = &ctx;
+    for(uint32_t k = 0;  k != depth;  ++k) {
+      qctx = qctx->get_parent_opt();
+      if(!qctx)
+        throw Runtime_Error(xtc_format,
+                 "Context depth `$1` of `$2` out of range", depth, name);
+    }
+    return *qctx;
+  }
+
 void
 do_collect_variables_for_each(Variable_HashMap& staged, Variable_HashMap& temp,
                               const cow_vector<AIR_Node>& code)
@@ -74,6 +90,139 @@ do_push_modifier_and_check(Reference& ref, xModifier&& xmod)
     ref.dereference_readonly();
   }
 
+const Reference&
+do_get_local_reference(const Executive_Context& ctx, uint32_t depth, uint32_t slot, phsh_stringR name)
+  {
+    // Locate the target context.
+    const Executive_Context* qctx = &ctx;
+    for(uint32_t k = 0;  k != depth;  ++k) {
+      qctx = qctx->get_parent_opt();
+      if(!qctx)
+        throw Runtime_Error(xtc_format,
+                 "Undeclared identifier `$1`", name);
+    }
+
+    // Look for the name in the target context. The slot was determined when
+    // code was generated, and is usually accurate.
+    auto qref = qctx->get_named_reference_opt(slot, name);
+    if(!qref)
+      throw Runtime_Error(xtc_format,
+               "Undeclared identifier `$1`", name);
+
+    if(qref->is_invalid())
+      throw Runtime_Error(xtc_format,
+               "Initialization of `$1` was bypassed", name);
+
+    return *qref;
+  }
+
+Reference&
+do_push_local_reference(Executive_Context& ctx, uint32_t depth, uint32_t slot, phsh_stringR name)
+  {
+    // Push a copy of the reference onto the stack.
+    const auto& ref = do_get_local_reference(ctx, depth, slot, name);
+    return ctx.stack().push() = ref;
+  }
+
+bool
+do_is_fusable_binary_operator(Xop xop) noexcept
+  {
+    // These are binary operators of `S_local_operator_local`.
+    return ::rocket::is_any_of(xop,
+             { xop_cmp_eq, xop_cmp_ne, xop_cmp_un, xop_cmp_lt, xop_cmp_gt, xop_cmp_lte,
+               xop_cmp_gte, xop_cmp_3way, xop_add, xop_sub, xop_mul, xop_div, xop_mod,
+               xop_andb, xop_orb, xop_xorb, xop_addm, xop_subm, xop_mulm, xop_adds,
+               xop_subs, xop_muls });
+  }
+
+void
+do_check_deserialized_operator(bool valid, Xop xop)
+  {
+    // Operators are not checked again when nodes are solidified.
+    if(!valid)
+      ASTERIA_THROW(("Invalid operator `$1` in compiled script"), static_cast<uint32_t>(xop));
+  }
+
+AIR_Status
+do_apply_increment(Reference& top, bool assign)
+  {
+    // `assign` is `true` for the postfix variant and `false` for
+    // the prefix variant.
+    auto& rhs = top.dereference_mutable();
+
+    if(rhs.type() == type_integer) {
+      V_integer& val = rhs.mut_integer();
+
+      // Increment the value with overflow checking.
+      int64_t result;
+      if(ROCKET_ADD_OVERFLOW(val, 1, &result))
+        throw Runtime_Error(xtc_format,
+                 "Integer increment overflow (operand was `$1`)", val);
+
+      if(assign)
+        top.set_temporary(val);
+
+      val = result;
+      return air_status_next;
+    }
+
+    if(rhs.type() == type_real) {
+      V_real& val = rhs.mut_real();
+
+      // Overflow will result in an infinity, so this is safe.
+      double result = val + 1;
+
+      if(assign)
+        top.set_temporary(val);
+
+      val = result;
+      return air_status_next;
+    }
+
+    throw Runtime_Error(xtc_format,
+             "Increment not applicable (operand was `$1`)", rhs);
+  }
+
+AIR_Status
+do_apply_decrement(Reference& top, bool assign)
+  {
+    // `assign` is `true` for the postfix variant and `false` for
+    // the prefix variant.
+    auto& rhs = top.dereference_mutable();
+
+    if(rhs.type() == type_integer) {
+      V_integer& val = rhs.mut_integer();
+
+      // Decrement the value with overflow checking.
+      int64_t result;
+      if(ROCKET_SUB_OVERFLOW(val, 1, &result))
+        throw Runtime_Error(xtc_format,
+                 "Integer decrement overflow (operand was `$1`)", val);
+
+      if(assign)
+        top.set_temporary(val);
+
+      val = result;
+      return air_status_next;
+    }
+
+    if(rhs.type() == type_real) {
+      V_real& val = rhs.mut_real();
+
+      // Overflow will result in an infinity, so this is safe.
+      double result = val - 1;
+
+      if(assign)
+        top.set_temporary(val);
+
+      val = result;
+      return air_status_next;
+    }
+
+    throw Runtime_Error(xtc_format,
+             "Decrement not applicable (operand was `$1`)", rhs);
+  }
+
 using Uparam  = AVM_Rod::Uparam;
 using Header  = AVM_Rod::Header;
 
@@ -773,943 +922,1883 @@ do_apply_binary_operator_with_integer(uint8_t uxop, Value& lhs, V_integer irhs)
     }
   }
 
-}  // namespace
-
-opt<Value>
-AIR_Node::
-get_constant_opt() const noexcept
+ROCKET_FLATTEN ROCKET_NEVER_INLINE
+AIR_Status
+do_apply_binary_operator_with_value(uint8_t uxop, Value& lhs, const Value& rhs)
   {
-    switch(this->m_stor.index())
+    switch(uxop)
       {
-      case index_push_bound_reference:
-        try {
-          const auto& altr = this->m_stor.as<S_push_bound_reference>();
-          if(altr.ref.is_temporary())
-            return altr.ref.dereference_readonly();
+      case xop_cmp_eq:
+        {
+          // Check whether the two operands are equal. Unordered values are
+          // considered to be unequal.
+          lhs = lhs.compare_partial(rhs) == compare_equal;
+          return air_status_next;
         }
-        catch(...) { }
-        return nullopt;
-
-      case index_push_constant:
-        return this->m_stor.as<S_push_constant>().val;
-
-      default:
-        return nullopt;
-    }
-  }
-
-bool
-AIR_Node::
-is_terminator() const noexcept
-  {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
-      case index_declare_variable:
-      case index_initialize_variable:
-      case index_switch_statement:
-      case index_do_while_statement:
-      case index_while_statement:
-      case index_for_each_statement:
-      case index_for_statement:
-      case index_try_statement:
-      case index_assert_statement:
-      case index_check_argument:
-      case index_push_global_reference:
-      case index_push_local_reference:
-      case index_push_bound_reference:
-      case index_define_function:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_array:
-      case index_unpack_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_defer_expression:
-      case index_import_call:
-      case index_declare_reference:
-      case index_initialize_reference:
-      case index_catch_expression:
-      case index_push_constant:
-      case index_alt_clear_stack:
-      case index_coalesce_expression:
-      case index_member_access:
-      case index_apply_operator_bi32:
-      case index_return_statement_bi32:
-        return false;
 
-      case index_throw_statement:
-      case index_return_statement:
-        return true;
-
-      case index_simple_status:
-        return this->m_stor.as<S_simple_status>().status != air_status_next;
+      case xop_cmp_ne:
+        {
+          // Check whether the two operands are not equal. Unordered values are
+          // considered to be unequal.
+          lhs = lhs.compare_partial(rhs) != compare_equal;
+          return air_status_next;
+        }
 
-      case index_function_call:
-        return this->m_stor.as<S_function_call>().ptc != ptc_aware_none;
+      case xop_cmp_un:
+        {
+          // Check whether the two operands are unordered.
+          lhs = lhs.compare_partial(rhs) == compare_unordered;
+          return air_status_next;
+        }
 
-      case index_variadic_call:
-        return this->m_stor.as<S_variadic_call>().ptc != ptc_aware_none;
+      case xop_cmp_lt:
+        {
+          // Check whether the LHS operand is less than the RHS operand. If
+          // they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) == compare_less;
+          return air_status_next;
+        }
 
-      case index_alt_function_call:
-        return this->m_stor.as<S_alt_function_call>().ptc != ptc_aware_none;
+      case xop_cmp_gt:
+        {
+          // Check whether the LHS operand is greater than the RHS operand. If
+          // they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) == compare_greater;
+          return air_status_next;
+        }
 
-      case index_execute_block:
+      case xop_cmp_lte:
         {
-          const auto& altr = this->m_stor.as<S_execute_block>();
-          return !altr.code_body.empty() && altr.code_body.back().is_terminator();
+          // Check whether the LHS operand is less than or equal to the RHS
+          // operand. If they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) != compare_greater;
+          return air_status_next;
         }
 
-      case index_if_statement:
+      case xop_cmp_gte:
         {
-          const auto& altr = this->m_stor.as<S_if_statement>();
-          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
-                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+          // Check whether the LHS operand is greater than or equal to the RHS
+          // operand. If they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) != compare_less;
+          return air_status_next;
         }
 
-      case index_branch_expression:
+      case xop_cmp_3way:
         {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
-          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
-                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+          // Defines a partial ordering on all values. For unordered operands,
+          // a string is returned, so `x <=> y` and `(x <=> y) <=> 0` produces
+          // the same result.
+          int64_t cmp = lhs.compare_partial(rhs);
+          lhs = cmp - compare_equal;
+          if(ROCKET_UNEXPECT(cmp == compare_unordered))
+            lhs = &"[unordered]";
+          return air_status_next;
         }
 
-      default:
-        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
-    }
-  }
+      case xop_add:
+        {
+          // Perform logical OR on two boolean values, or get the sum of two
+          // arithmetic values, or concatenate two strings.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-opt<AIR_Node>
-AIR_Node::
-rebind_opt(Abstract_Context& ctx) const
-  {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
-      case index_declare_variable:
-      case index_initialize_variable:
-      case index_throw_statement:
-      case index_assert_statement:
-      case index_simple_status:
-      case index_check_argument:
-      case index_push_global_reference:
-      case index_push_bound_reference:
-      case index_function_call:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_array:
-      case index_unpack_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_variadic_call:
-      case index_import_call:
-      case index_declare_reference:
-      case index_initialize_reference:
-      case index_return_statement:
-      case index_push_constant:
-      case index_alt_clear_stack:
-      case index_alt_function_call:
-      case index_member_access:
-      case index_apply_operator_bi32:
-      case index_return_statement_bi32:
-        return nullopt;
+            val += other;
+            return air_status_next;
+          }
 
-      case index_execute_block:
-        {
-          const auto& altr = this->m_stor.as<S_execute_block>();
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& other = rhs.as_string();
 
-          // Rebind the body in a nested scope.
-          bool dirty = false;
-          auto bound = altr;
+            val.append(other);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          return do_return_rebound_opt(dirty, move(bound));
+            val |= other;
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "Addition not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_if_statement:
+      case xop_sub:
         {
-          const auto& altr = this->m_stor.as<S_if_statement>();
+          // Perform logical XOR on two boolean values, or get the difference
+          // of two arithmetic values.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          // Rebind both branches in a nested scope.
-          bool dirty = false;
-          auto bound = altr;
+            // Overflow will result in an infinity, so this is safe.
+            val -= other;
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_true, ctx_body);
-          do_rebind_nodes(dirty, bound.code_false, ctx_body);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          return do_return_rebound_opt(dirty, move(bound));
+            // Perform logical XOR of the operands.
+            val ^= other;
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "Subtraction not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_switch_statement:
+      case xop_mul:
         {
-          const auto& altr = this->m_stor.as<S_switch_statement>();
+           // Perform logical AND on two boolean values, or get the product of
+           // two arithmetic values, or duplicate a string or array by a given
+           // times.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          // Rebind all labels and clauses.
-          bool dirty = false;
-          auto bound = altr;
+            val *= other;
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          for(size_t k = 0;  k < bound.clauses.size();  ++k) {
-            // Labels are to be evaluated in the same scope as the condition
-            // expression, and are not parts of the body.
-            for(size_t i = 0;  i < bound.clauses.at(k).code_labels.size();  ++i)
-              if(auto qnode = bound.clauses.at(k).code_labels.at(i).rebind_opt(ctx))
-                do_set_rebound(dirty, bound.clauses.mut(k).code_labels.mut(i), move(*qnode));
+          if(lhs.is_integer() && rhs.is_string()) {
+            V_integer count = lhs.as_integer();
+            lhs = rhs.as_string();
+            V_string& val = lhs.mut_string();
 
-            for(size_t i = 0;  i < bound.clauses.at(k).code_body.size();  ++i)
-              if(auto qnode = bound.clauses.at(k).code_body.at(i).rebind_opt(ctx_body))
-                do_set_rebound(dirty, bound.clauses.mut(k).code_body.mut(i), move(*qnode));
+            do_duplicate_sequence(val, count);
+            return air_status_next;
           }
 
-          return do_return_rebound_opt(dirty, move(bound));
-        }
-
-      case index_do_while_statement:
-        {
-          const auto& altr = this->m_stor.as<S_do_while_statement>();
+          if(lhs.is_integer() && rhs.is_array()) {
+            V_integer count = lhs.as_integer();
+            lhs = rhs.as_array();
+            V_array& val = lhs.mut_array();
 
-          // Rebind the body and the condition expression.
-          // The condition expression is not a part of the body.
-          bool dirty = false;
-          auto bound = altr;
+            do_duplicate_sequence(val, count);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          do_rebind_nodes(dirty, bound.code_cond, ctx);
+            val &= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Multiplication not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_while_statement:
+      case xop_div:
         {
-          const auto& altr = this->m_stor.as<S_while_statement>();
-
-          // Rebind the condition expression and the body.
-          // The condition expression is not a part of the body.
-          bool dirty = false;
-          auto bound = altr;
-
-          do_rebind_nodes(dirty, bound.code_cond, ctx);
+          // Get the quotient of two arithmetic values. If both operands are
+          // integers, the result is also an integer, truncated towards zero.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+            val /= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Division not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_for_each_statement:
+      case xop_mod:
         {
-          const auto& altr = this->m_stor.as<S_for_each_statement>();
-
-          // Rebind the range initializer and the body.
-          // The range key and mapped references are declared in a dedicated scope
-          // where the initializer is to be evaluated. The body is to be executed
-          // in an inner scope, created and destroyed for each iteration.
-          bool dirty = false;
-          auto bound = altr;
-
-          Analytic_Context ctx_for(xtc_plain, ctx);
-          if(!altr.name_key.empty())
-            ctx_for.insert_named_reference(altr.name_key);
-          ctx_for.insert_named_reference(altr.name_mapped);
-          do_rebind_nodes(dirty, bound.code_init, ctx_for);
+          // Get the remainder of two arithmetic values. The quotient is
+          // truncated towards zero. If both operands are integers, the result
+          // is also an integer.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          Analytic_Context ctx_body(xtc_plain, ctx_for);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+            val = ::std::fmod(val, other);
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Modulo not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_for_statement:
+      case xop_andb:
         {
-          const auto& altr = this->m_stor.as<S_for_statement>();
+          // Perform the bitwise AND operation on all bits of the operands. If
+          // the two operands have different lengths, the result is truncated
+          // to the same length as the shorter one.
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& mask = rhs.as_string();
 
-          // Rebind the initializer, condition expression and step expression. All
-          // these are declared in a dedicated scope where the initializer is to be
-          // evaluated. The body is to be executed in an inner scope, created and
-          // destroyed for each iteration.
-          bool dirty = false;
-          auto bound = altr;
+            if(val.size() > mask.size())
+              val.erase(mask.size());
+            auto maskp = mask.begin();
+            for(auto it = val.mut_begin();  it != val.end();  ++it, ++maskp)
+              *it = static_cast<char>(*it & *maskp);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_for(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_init, ctx_for);
-          do_rebind_nodes(dirty, bound.code_cond, ctx_for);
-          do_rebind_nodes(dirty, bound.code_step, ctx_for);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          Analytic_Context ctx_body(xtc_plain, ctx_for);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+            val &= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Bitwise AND not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_try_statement:
+      case xop_orb:
         {
-          const auto& altr = this->m_stor.as<S_try_statement>();
+          // Perform the bitwise OR operation on all bits of the operands. If
+          // the two operands have different lengths, the result is padded to
+          // the same length as the longer one, with zeroes.
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& mask = rhs.as_string();
 
-          // Rebind the `try` and `catch` clauses.
-          bool dirty = false;
-          auto bound = altr;
+            if(val.size() < mask.size())
+              val.append(mask.size() - val.size(), 0);
+            auto valp = val.mut_begin();
+            for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
+              *valp = static_cast<char>(*valp | *it);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_try(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_try, ctx_try);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          Analytic_Context ctx_catch(xtc_plain, ctx);
-          ctx_catch.insert_named_reference(altr.name_except);
-          do_rebind_nodes(dirty, bound.code_catch, ctx_catch);
+            val |= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Bitwise OR not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_push_local_reference:
+      case xop_xorb:
         {
-          const auto& altr = this->m_stor.as<S_push_local_reference>();
+          // Perform the bitwise XOR operation on all bits of the operands. If
+          // the two operands have different lengths, the result is padded to
+          // the same length as the longer one, with zeroes.
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& mask = rhs.as_string();
 
-          // Get the context.
-          const Abstract_Context* qctx = &ctx;
-          for(uint32_t k = 0;  k != altr.depth;  ++k)
-            qctx = qctx->get_parent_opt();
+            if(val.size() < mask.size())
+              val.append(mask.size() - val.size(), 0);
+            auto valp = val.mut_begin();
+            for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
+              *valp = static_cast<char>(*valp ^ *it);
+            return air_status_next;
+          }
 
-          if(qctx->is_analytic())
-            return nullopt;
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          // Look for the name.
-          auto qref = qctx->get_named_reference_opt(altr.name);
-          if(!qref)
-            return nullopt;
-          else if(qref->is_invalid())
-            throw Runtime_Error(xtc_format,
-                     "Initialization of variable or reference `$1` bypassed", altr.name);
+            val ^= other;
+            return air_status_next;
+          }
 
-          // Bind this reference.
-          S_push_bound_reference xnode = { *qref };
-          return move(xnode);
+          throw Runtime_Error(xtc_format,
+                   "Bitwise XOR not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_define_function:
+      case xop_addm:
         {
-          const auto& altr = this->m_stor.as<S_define_function>();
-
-          // Rebind the function body.
-          // This is the only scenario where names in the outer scope are visible
-          // to the body of a function.
-          bool dirty = false;
-          auto bound = altr;
-
-          Analytic_Context ctx_func(xtc_function, &ctx, altr.params);
-          do_rebind_nodes(dirty, bound.code_body, ctx_func);
-
-          return do_return_rebound_opt(dirty, move(bound));
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Modular addition not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_branch_expression:
+      case xop_subm:
         {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
-
-          // Rebind both branches.
-          bool dirty = false;
-          auto bound = altr;
-
-          do_rebind_nodes(dirty, bound.code_true, ctx);
-          do_rebind_nodes(dirty, bound.code_false, ctx);
-
-          return do_return_rebound_opt(dirty, move(bound));
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Modular subtraction not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_defer_expression:
+      case xop_mulm:
         {
-          const auto& altr = this->m_stor.as<S_defer_expression>();
-
-          // Rebind the expression.
-          bool dirty = false;
-          auto bound = altr;
-
-          do_rebind_nodes(dirty, bound.code_body, ctx);
-
-          return do_return_rebound_opt(dirty, move(bound));
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Modular multiplication not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_catch_expression:
+      case xop_adds:
         {
-          const auto& altr = this->m_stor.as<S_catch_expression>();
-
-          // Rebind the expression.
-          bool dirty = false;
-          auto bound = altr;
-
-          do_rebind_nodes(dirty, bound.code_body, ctx);
-
-          return do_return_rebound_opt(dirty, move(bound));
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Saturating addition not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_coalesce_expression:
+      case xop_subs:
         {
-          const auto& altr = this->m_stor.as<S_coalesce_expression>();
-
-          // Rebind the null branch.
-          bool dirty = false;
-          auto bound = altr;
-
-          do_rebind_nodes(dirty, bound.code_null, ctx);
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Saturating subtraction not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
+        }
 
-          return do_return_rebound_opt(dirty, move(bound));
+      case xop_muls:
+        {
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Saturating multiplication not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
       default:
-        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+        ROCKET_UNREACHABLE();
     }
   }
 
-void
-AIR_Node::
-collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+// Binary operator nodes record types of their operands in `uparam.u2` (a
+// counter) and `uparam.u3` (the type). After a number of consecutive
+// executions with operands of the same arithmetic type, the node replaces its
+// executor with a specialized one, and stores the general one in its `sparam`.
+// If a specialized executor encounters other types, the general one is put
+// back, and the node will not be specialized again.
+constexpr uint8_t feedback_threshold = 16;
+constexpr uint8_t feedback_disabled = 0xFF;
+
+bool
+do_is_specializable_binary(uint8_t uxop, Type type) noexcept
   {
-    switch(static_cast<Index>(this->m_stor.index()))
+    switch(uxop)
       {
-      case index_clear_stack:
-      case index_declare_variable:
-      case index_initialize_variable:
-      case index_throw_statement:
-      case index_assert_statement:
-      case index_simple_status:
-      case index_check_argument:
-      case index_push_global_reference:
-      case index_push_local_reference:
-      case index_function_call:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_array:
-      case index_unpack_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_variadic_call:
-      case index_import_call:
-      case index_declare_reference:
-      case index_initialize_reference:
-      case index_return_statement:
-      case index_alt_clear_stack:
-      case index_alt_function_call:
-      case index_member_access:
-      case index_apply_operator_bi32:
-      case index_return_statement_bi32:
-        return;
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+        return (type == type_integer) || (type == type_real);
 
-      case index_execute_block:
-        {
-          const auto& altr = this->m_stor.as<S_execute_block>();
+      case xop_div:
+        return type == type_real;
 
-          // Collect variables from the body.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+      default:
+        return false;
+    }
+  }
 
-      case index_if_statement:
-        {
-          const auto& altr = this->m_stor.as<S_if_statement>();
+template<typename xValue>
+inline
+void
+do_set_binary_result(Reference& top, bool assign, xValue&& xval)
+  {
+    if(assign)
+      top.dereference_mutable() = forward<xValue>(xval);
+    else
+      top.set_temporary(forward<xValue>(xval));
+  }
 
-          // Collect variables from both branches.
-          do_collect_variables_for_each(staged, temp, altr.code_true);
-          do_collect_variables_for_each(staged, temp, altr.code_false);
-          return;
-        }
+ROCKET_NEVER_INLINE
+AIR_Status
+do_despecialize_binary(Executive_Context& ctx, const Header* head)
+  {
+    // Restore the general executor and call it.
+    auto& up = const_cast<Header*>(head)->uparam;
+    up.u3 = feedback_disabled;
+    auto exec = *reinterpret_cast<AVM_Rod::Executor* const*>(head->sparam);
+    AVM_Rod::exchange_executor(head, exec);
+    return exec(ctx, head);
+  }
 
-      case index_switch_statement:
-        {
-          const auto& altr = this->m_stor.as<S_switch_statement>();
+ROCKET_FLATTEN
+AIR_Status
+do_apply_binary_operator_integer(Executive_Context& ctx, const Header* head)
+  {
+    const bool assign = head->uparam.b0;
+    const uint8_t uxop = head->uparam.u1;
+    const auto& rhs = ctx.stack().top().dereference_readonly();
+    const auto& lhs = ctx.stack().top(1).dereference_readonly();
 
-          // Collect variables from all labels and clauses.
-          for(const auto& clause : altr.clauses) {
-            do_collect_variables_for_each(staged, temp, clause.code_labels);
-            do_collect_variables_for_each(staged, temp, clause.code_body);
-          }
-          return;
-        }
+    if(ROCKET_UNEXPECT(!lhs.is_integer() || !rhs.is_integer()))
+      return do_despecialize_binary(ctx, head);
 
-      case index_do_while_statement:
-        {
-          const auto& altr = this->m_stor.as<S_do_while_statement>();
+    V_integer val = lhs.as_integer();
+    V_integer other = rhs.as_integer();
+    ctx.stack().pop();
+    auto& top = ctx.stack().mut_top();
 
-          // Collect variables from the body and the condition expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          return;
-        }
+    switch(uxop)
+      {
+      case xop_cmp_eq:
+        do_set_binary_result(top, assign, val == other);
+        return air_status_next;
 
-      case index_while_statement:
-        {
-          const auto& altr = this->m_stor.as<S_while_statement>();
+      case xop_cmp_ne:
+        do_set_binary_result(top, assign, val != other);
+        return air_status_next;
 
-          // Collect variables from the condition expression and the body.
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+      case xop_cmp_lt:
+        do_set_binary_result(top, assign, val < other);
+        return air_status_next;
 
-      case index_for_each_statement:
-        {
-          const auto& altr = this->m_stor.as<S_for_each_statement>();
+      case xop_cmp_gt:
+        do_set_binary_result(top, assign, val > other);
+        return air_status_next;
 
-          // Collect variables from the range initializer and the body.
-          do_collect_variables_for_each(staged, temp, altr.code_init);
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+      case xop_cmp_lte:
+        do_set_binary_result(top, assign, val <= other);
+        return air_status_next;
 
-      case index_for_statement:
+      case xop_cmp_gte:
+        do_set_binary_result(top, assign, val >= other);
+        return air_status_next;
+
+      case xop_add:
         {
-          const auto& altr = this->m_stor.as<S_for_statement>();
+          int64_t result;
+          if(ROCKET_ADD_OVERFLOW(val, other, &result))
+            throw Runtime_Error(xtc_format,
+                     "Integer addition overflow (operands were `$1` and `$2`)",
+                     val, other);
 
-          // Collect variables from the initializer, condition expression and
-          // step expression.
-          do_collect_variables_for_each(staged, temp, altr.code_init);
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          do_collect_variables_for_each(staged, temp, altr.code_step);
-          return;
+          do_set_binary_result(top, assign, result);
+          return air_status_next;
         }
 
-      case index_try_statement:
+      case xop_sub:
         {
-          const auto& altr = this->m_stor.as<S_try_statement>();
+          int64_t result;
+          if(ROCKET_SUB_OVERFLOW(val, other, &result))
+            throw Runtime_Error(xtc_format,
+                     "Integer subtraction overflow (operands were `$1` and `$2`)",
+                     val, other);
 
-          // Collect variables from the `try` and `catch` clauses.
-          do_collect_variables_for_each(staged, temp, altr.code_try);
-          do_collect_variables_for_each(staged, temp, altr.code_catch);
-          return;
+          do_set_binary_result(top, assign, result);
+          return air_status_next;
         }
 
-      case index_push_bound_reference:
+      case xop_mul:
         {
-          const auto& altr = this->m_stor.as<S_push_bound_reference>();
+          int64_t result;
+          if(ROCKET_MUL_OVERFLOW(val, other, &result))
+            throw Runtime_Error(xtc_format,
+                     "Integer multiplication overflow (operands were `$1` and `$2`)",
+                     val, other);
 
-          // Collect variables from the bound reference.
-          altr.ref.collect_variables(staged, temp);
-          return;
+          do_set_binary_result(top, assign, result);
+          return air_status_next;
         }
 
-      case index_define_function:
-        {
-          const auto& altr = this->m_stor.as<S_define_function>();
+      default:
+        ROCKET_UNREACHABLE();
+    }
+  }
 
-          // Collect variables from the function body.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+ROCKET_FLATTEN
+AIR_Status
+do_apply_binary_operator_real(Executive_Context& ctx, const Header* head)
+  {
+    const bool assign = head->uparam.b0;
+    const uint8_t uxop = head->uparam.u1;
+    const auto& rhs = ctx.stack().top().dereference_readonly();
+    const auto& lhs = ctx.stack().top(1).dereference_readonly();
 
-      case index_branch_expression:
-        {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
+    // Integers are also convertible to reals, but they are not accepted here,
+    // as integer division is different.
+    if(ROCKET_UNEXPECT((lhs.type() != type_real) || (rhs.type() != type_real)))
+      return do_despecialize_binary(ctx, head);
 
-          // Collect variables from both branches.
-          do_collect_variables_for_each(staged, temp, altr.code_true);
-          do_collect_variables_for_each(staged, temp, altr.code_false);
-          return;
-        }
+    V_real val = lhs.as_real();
+    V_real other = rhs.as_real();
 
-      case index_defer_expression:
-        {
-          const auto& altr = this->m_stor.as<S_defer_expression>();
+    // Relational comparison of unordered values shall throw an exception.
+    // Leave them to the general executor. Feedback must be disabled before
+    // it is called, otherwise it would specialize this node again.
+    if(ROCKET_UNEXPECT(::std::isunordered(val, other)))
+      if(::rocket::is_any_of(uxop, { xop_cmp_lt, xop_cmp_gt, xop_cmp_lte, xop_cmp_gte }))
+        return do_despecialize_binary(ctx, head);
 
-          // Collect variables from the expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+    ctx.stack().pop();
+    auto& top = ctx.stack().mut_top();
 
-      case index_catch_expression:
-        {
-          const auto& altr = this->m_stor.as<S_catch_expression>();
+    switch(uxop)
+      {
+      case xop_cmp_eq:
+        do_set_binary_result(top, assign, val == other);
+        return air_status_next;
 
-          // Collect variables from the expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+      case xop_cmp_ne:
+        do_set_binary_result(top, assign, val != other);
+        return air_status_next;
 
-      case index_push_constant:
-        {
-          const auto& altr = this->m_stor.as<S_push_constant>();
+      case xop_cmp_lt:
+        do_set_binary_result(top, assign, val < other);
+        return air_status_next;
 
-          // Collect variables from the expression.
-          altr.val.collect_variables(staged, temp);
-          return;
-        }
+      case xop_cmp_gt:
+        do_set_binary_result(top, assign, val > other);
+        return air_status_next;
 
-      case index_coalesce_expression:
-        {
-          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+      case xop_cmp_lte:
+        do_set_binary_result(top, assign, val <= other);
+        return air_status_next;
 
-          // Collect variables from the null branch.
-          do_collect_variables_for_each(staged, temp, altr.code_null);
-          return;
-        }
+      case xop_cmp_gte:
+        do_set_binary_result(top, assign, val >= other);
+        return air_status_next;
+
+      case xop_add:
+        do_set_binary_result(top, assign, val + other);
+        return air_status_next;
+
+      case xop_sub:
+        do_set_binary_result(top, assign, val - other);
+        return air_status_next;
+
+      case xop_mul:
+        do_set_binary_result(top, assign, val * other);
+        return air_status_next;
+
+      case xop_div:
+        do_set_binary_result(top, assign, val / other);
+        return air_status_next;
 
       default:
-        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+        ROCKET_UNREACHABLE();
     }
   }
 
 void
-AIR_Node::
-solidify(AVM_Rod& rod) const
+do_record_binary_feedback(const Header* head, const Value& lhs, const Value& rhs)
   {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
-        {
-          const auto& altr = this->m_stor.as<S_clear_stack>();
+    auto& up = const_cast<Header*>(head)->uparam;
+    Type type = lhs.type();
 
-          (void) altr;
+    // Start over if operands do not have the same type as before.
+    if((type != rhs.type()) || !do_is_specializable_binary(up.u1, type)) {
+      up.u2 = 0;
+      return;
+    }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* /*head*/) -> AIR_Status
-            {
-              ctx.stack().clear();
-              return air_status_next;
-            }
+    if(type != up.u3) {
+      up.u3 = type;
+      up.u2 = 0;
+    }
 
-            // Uparam
-            , Uparam()
+    if(++ up.u2 < feedback_threshold)
+      return;
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+    // Specialize this node. `sparam` shall always hold the general executor,
+    // so it must not be overwritten with a specialized one.
+    auto exec = (type == type_integer) ? do_apply_binary_operator_integer
+                                       : do_apply_binary_operator_real;
+    auto prev = AVM_Rod::exchange_executor(head, exec);
+    ROCKET_ASSERT((prev != do_apply_binary_operator_integer) && (prev != do_apply_binary_operator_real));
+    if((prev != do_apply_binary_operator_integer) && (prev != do_apply_binary_operator_real))
+      *reinterpret_cast<AVM_Rod::Executor**>(const_cast<Header*>(head)->sparam) = prev;
+  }
 
-            // Collector
-            , nullptr
+}  // namespace
 
-            // Symbols
-            , nullptr
-          );
-          return;
-        }
+opt<Value>
+AIR_Node::
+get_constant_opt() const noexcept
+  {
+    switch(this->m_stor.index())
+      {
+      case index_push_bound_reference:
+        try {
+          const auto& altr = this->m_stor.as<S_push_bound_reference>();
+          if(altr.ref.is_temporary())
+            return altr.ref.dereference_readonly();
+        }
+        catch(...) { }
+        return nullopt;
 
-      case index_execute_block:
-        {
-          const auto& altr = this->m_stor.as<S_execute_block>();
+      case index_push_constant:
+        return this->m_stor.as<S_push_constant>().val;
 
-          struct Sparam
-            {
-              AVM_Rod rod_body;
-            };
+      default:
+        return nullopt;
+    }
+  }
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_body, altr.code_body);
+bool
+AIR_Node::
+is_terminator() const noexcept
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_switch_statement:
+      case index_do_while_statement:
+      case index_while_statement:
+      case index_for_each_statement:
+      case index_for_statement:
+      case index_try_statement:
+      case index_assert_statement:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_local_reference:
+      case index_push_bound_reference:
+      case index_define_function:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_defer_expression:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_catch_expression:
+      case index_push_constant:
+      case index_alt_clear_stack:
+      case index_coalesce_expression:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+      case index_local_operator_bi32:
+      case index_local_member_access:
+      case index_local_operator:
+      case index_local_operator_local:
+        return false;
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case index_throw_statement:
+      case index_return_statement:
+        return true;
 
-              // Execute the block on a new context. The block may contain control
-              // statements, so the status shall be forwarded verbatim.
-              return do_execute_block(sp.rod_body, ctx);
-            }
+      case index_simple_status:
+        return this->m_stor.as<S_simple_status>().status != air_status_next;
 
-            // Uparam
-            , Uparam()
+      case index_function_call:
+        return this->m_stor.as<S_function_call>().ptc != ptc_aware_none;
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_variadic_call:
+        return this->m_stor.as<S_variadic_call>().ptc != ptc_aware_none;
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_body.collect_variables(staged, temp);
-            }
+      case index_alt_function_call:
+        return this->m_stor.as<S_alt_function_call>().ptc != ptc_aware_none;
 
-            // Symbols
-            , nullptr
-          );
-          return;
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+          return !altr.code_body.empty() && altr.code_body.back().is_terminator();
         }
 
-      case index_declare_variable:
+      case index_if_statement:
         {
-          const auto& altr = this->m_stor.as<S_declare_variable>();
-
-          struct Sparam
-            {
-              phsh_string name;
-            };
-
-          Sparam sp2;
-          sp2.name = altr.name;
-
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              const auto& sloc = head->pv_meta->sloc;
-
-              // Allocate a variable and inject it into the current context.
-              const auto gcoll = ctx.global().garbage_collector();
-              const auto var = gcoll->create_variable();
-              ctx.insert_named_reference(sp.name).set_variable(var);
-
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_declare(sloc, sp.name);
+          const auto& altr = this->m_stor.as<S_if_statement>();
+          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
+                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+        }
 
-              // Push a copy of the reference onto the stack, which we will get
-              // back after the initializer finishes execution.
-              ctx.stack().push().set_variable(var);
-              return air_status_next;
-            }
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
+          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
+                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+        }
 
-            // Uparam
-            , Uparam()
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+opt<AIR_Node>
+AIR_Node::
+rebind_opt(Abstract_Context& ctx) const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_throw_statement:
+      case index_assert_statement:
+      case index_simple_status:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_bound_reference:
+      case index_function_call:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_return_statement:
+      case index_push_constant:
+      case index_alt_clear_stack:
+      case index_alt_function_call:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+        return nullopt;
 
-            // Collector
-            , nullptr
+      case index_local_operator_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_local_operator_bi32>();
+          do_get_context_at_depth(ctx, altr.depth, altr.name);
+          return nullopt;
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
+      case index_local_member_access:
+        {
+          const auto& altr = this->m_stor.as<S_local_member_access>();
+          do_get_context_at_depth(ctx, altr.depth, altr.name);
+          return nullopt;
         }
 
-      case index_initialize_variable:
+      case index_local_operator:
         {
-          const auto& altr = this->m_stor.as<S_initialize_variable>();
+          const auto& altr = this->m_stor.as<S_local_operator>();
+          do_get_context_at_depth(ctx, altr.depth, altr.name);
+          return nullopt;
+        }
 
-          Uparam up2;
-          up2.b0 = altr.immutable;
+      case index_local_operator_local:
+        {
+          const auto& altr = this->m_stor.as<S_local_operator_local>();
+          do_get_context_at_depth(ctx, altr.depth, altr.name);
+          do_get_context_at_depth(ctx, altr.rdepth, altr.rname);
+          return nullopt;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool immutable = head->uparam.b0;
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
 
-              // Read the value of the initializer. The initializer must not have
-              // been empty for this function.
-              const auto& val = ctx.stack().top().dereference_readonly();
-              ctx.stack().pop();
+          // Rebind the body in a nested scope.
+          bool dirty = false;
+          auto bound = altr;
 
-              // Get the variable back.
-              auto var = ctx.stack().top().unphase_variable_opt();
-              ctx.stack().pop();
-              ROCKET_ASSERT(var && !var->is_initialized());
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
 
-              // Initialize it with this value.
-              var->initialize(val);
-              var->set_immutable(immutable);
-              return air_status_next;
-            }
+          return do_return_rebound_opt(dirty, move(bound));
+        }
 
-            // Uparam
-            , up2
+      case index_if_statement:
+        {
+          const auto& altr = this->m_stor.as<S_if_statement>();
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+          // Rebind both branches in a nested scope.
+          bool dirty = false;
+          auto bound = altr;
 
-            // Collector
-            , nullptr
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_true, ctx_body);
+          do_rebind_nodes(dirty, bound.code_false, ctx_body);
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
+          return do_return_rebound_opt(dirty, move(bound));
         }
 
-      case index_if_statement:
+      case index_switch_statement:
         {
-          const auto& altr = this->m_stor.as<S_if_statement>();
+          const auto& altr = this->m_stor.as<S_switch_statement>();
 
-          Uparam up2;
-          up2.b0 = altr.negative;
+          // Rebind all labels and clauses.
+          bool dirty = false;
+          auto bound = altr;
 
-          struct Sparam
-            {
-              AVM_Rod rod_true;
-              AVM_Rod rod_false;
-            };
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          for(size_t k = 0;  k < bound.clauses.size();  ++k) {
+            // Labels are to be evaluated in the same scope as the condition
+            // expression, and are not parts of the body.
+            for(size_t i = 0;  i < bound.clauses.at(k).code_labels.size();  ++i)
+              if(auto qnode = bound.clauses.at(k).code_labels.at(i).rebind_opt(ctx))
+                do_set_rebound(dirty, bound.clauses.mut(k).code_labels.mut(i), move(*qnode));
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_true, altr.code_true);
-          do_solidify_nodes(sp2.rod_false, altr.code_false);
+            for(size_t i = 0;  i < bound.clauses.at(k).code_body.size();  ++i)
+              if(auto qnode = bound.clauses.at(k).code_body.at(i).rebind_opt(ctx_body))
+                do_set_rebound(dirty, bound.clauses.mut(k).code_body.mut(i), move(*qnode));
+          }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool negative = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+          return do_return_rebound_opt(dirty, move(bound));
+        }
 
-              // Read the condition and execute the corresponding branch as a block.
-              return (ctx.stack().top().dereference_readonly().test() != negative)
-                        ? do_execute_block(sp.rod_true, ctx)
-                        : do_execute_block(sp.rod_false, ctx);
-            }
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
 
-            // Uparam
-            , up2
+          // Rebind the body and the condition expression.
+          // The condition expression is not a part of the body.
+          bool dirty = false;
+          auto bound = altr;
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_true.collect_variables(staged, temp);
-              sp.rod_false.collect_variables(staged, temp);
-            }
+          do_rebind_nodes(dirty, bound.code_cond, ctx);
 
-            // Symbols
-            , nullptr
-          );
-          return;
+          return do_return_rebound_opt(dirty, move(bound));
         }
 
-      case index_switch_statement:
+      case index_while_statement:
         {
-          const auto& altr = this->m_stor.as<S_switch_statement>();
+          const auto& altr = this->m_stor.as<S_while_statement>();
 
-          struct Sparam_switch_clause
-            {
-              Switch_Clause_Type type;
-              Compare cmp2_lower;
-              Compare cmp2_upper;
-              AVM_Rod rod_labels;
-              AVM_Rod rod_body;
-              cow_vector<phsh_string> names_added;
-            };
+          // Rebind the condition expression and the body.
+          // The condition expression is not a part of the body.
+          bool dirty = false;
+          auto bound = altr;
 
-          using Sparam = cow_vector<Sparam_switch_clause>;
-          Sparam sp2;
-          sp2.reserve(altr.clauses.size());
+          do_rebind_nodes(dirty, bound.code_cond, ctx);
 
-          for(const auto& clause : altr.clauses) {
-            auto& r = sp2.emplace_back();
-            r.type = clause.type;
-            r.cmp2_lower = clause.lower_closed ? compare_equal : compare_greater;
-            r.cmp2_upper = clause.upper_closed ? compare_equal : compare_less;
-            do_solidify_nodes(r.rod_labels, clause.code_labels);
-            do_solidify_nodes(r.rod_body, clause.code_body);
-            r.names_added = clause.names_added;
-          }
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+          return do_return_rebound_opt(dirty, move(bound));
+        }
 
-              // Read the value of the condition and find the target clause for it.
-              // This is different from the `switch` statement in C, where `case`
-              // labels must have constant operands.
-              auto cond = ctx.stack().top().dereference_readonly();
-              size_t target_index = SIZE_MAX;
+      case index_for_each_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
 
-              for(size_t k = 0;  k < sp.size();  ++k)
-                if(sp.at(k).type == switch_clause_default) {
-                  target_index = k;
-                }
-                else if(sp.at(k).type == switch_clause_case) {
-                  // Expect an exact match of one value.
-                  AIR_Status status = sp.at(k).rod_labels.execute(ctx);
-                  ROCKET_ASSERT(status == air_status_next);
+          // Rebind the range initializer and the body.
+          // The range key and mapped references are declared in a dedicated scope
+          // where the initializer is to be evaluated. The body is to be executed
+          // in an inner scope, created and destroyed for each iteration.
+          bool dirty = false;
+          auto bound = altr;
 
-                  if(cond.compare_partial(ctx.stack().top().dereference_readonly()) != compare_equal)
-                    continue;
+          Analytic_Context ctx_for(xtc_plain, ctx);
+          if(!altr.name_key.empty())
+            ctx_for.insert_named_reference(altr.name_key);
+          ctx_for.insert_named_reference(altr.name_mapped);
+          do_rebind_nodes(dirty, bound.code_init, ctx_for);
 
-                  target_index = k;
-                  break;
-                }
-                else if(sp.at(k).type == switch_clause_each) {
-                  // Expect an interval of two values.
-                  AIR_Status status = sp.at(k).rod_labels.execute(ctx);
-                  ROCKET_ASSERT(status == air_status_next);
+          Analytic_Context ctx_body(xtc_plain, ctx_for);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
 
-                  if(::rocket::is_none_of(cond.compare_partial(ctx.stack().top(1).dereference_readonly()),
-                                          { compare_greater, sp.at(k).cmp2_lower }))
-                    continue;
+          return do_return_rebound_opt(dirty, move(bound));
+        }
 
-                  if(::rocket::is_none_of(cond.compare_partial(ctx.stack().top(0).dereference_readonly()),
-                                          { compare_less, sp.at(k).cmp2_upper }))
-                    continue;
+      case index_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_statement>();
 
-                  target_index = k;
-                  break;
-                }
+          // Rebind the initializer, condition expression and step expression. All
+          // these are declared in a dedicated scope where the initializer is to be
+          // evaluated. The body is to be executed in an inner scope, created and
+          // destroyed for each iteration.
+          bool dirty = false;
+          auto bound = altr;
 
-              // Skip this statement if no matching clause has been found.
-              if(target_index >= sp.size())
-                return air_status_next;
+          Analytic_Context ctx_for(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_init, ctx_for);
+          do_rebind_nodes(dirty, bound.code_cond, ctx_for);
+          do_rebind_nodes(dirty, bound.code_step, ctx_for);
 
-              // Jump to the target clause.
-              Executive_Context ctx_body(xtc_plain, ctx);
-              AIR_Status status = air_status_next;
-              try {
-                for(size_t i = 0;  i < sp.size();  ++i)
-                  if(i < target_index) {
-                    // Inject bypassed names into the scope.
-                    for(const auto& name : sp.at(i).names_added)
-                      ctx_body.insert_named_reference(name);
-                  }
-                  else {
-                    // Execute the body of this clause.
-                    AIR_Status next_status = sp.at(i).rod_body.execute(ctx_body);
-                    if(next_status != air_status_next) {
-                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_switch }))
-                        status = next_status;
-                      break;
-                    }
-                  }
-              }
-              catch(Runtime_Error& except) {
-                ctx_body.on_scope_exit_exceptional(except);
-                throw;
-              }
-              ctx_body.on_scope_exit_normal(status);
-              return status;
-            }
+          Analytic_Context ctx_body(xtc_plain, ctx_for);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
 
-            // Uparam
-            , Uparam()
+          return do_return_rebound_opt(dirty, move(bound));
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_try_statement:
+        {
+          const auto& altr = this->m_stor.as<S_try_statement>();
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              for(const auto& r : *reinterpret_cast<const Sparam*>(head->sparam)) {
-                r.rod_labels.collect_variables(staged, temp);
-                r.rod_body.collect_variables(staged, temp);
-              }
-            }
+          // Rebind the `try` and `catch` clauses.
+          bool dirty = false;
+          auto bound = altr;
 
-            // Symbols
-            , nullptr
-          );
-          return;
+          Analytic_Context ctx_try(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_try, ctx_try);
+
+          Analytic_Context ctx_catch(xtc_plain, ctx);
+          ctx_catch.insert_named_reference(altr.name_except);
+          do_rebind_nodes(dirty, bound.code_catch, ctx_catch);
+
+          return do_return_rebound_opt(dirty, move(bound));
         }
 
-      case index_do_while_statement:
+      case index_push_local_reference:
         {
-          const auto& altr = this->m_stor.as<S_do_while_statement>();
+          const auto& altr = this->m_stor.as<S_push_local_reference>();
 
-          Uparam up2;
-          up2.b0 = altr.negative;
+          // Get the context.
+          const Abstract_Context* qctx = &do_get_context_at_depth(ctx, altr.depth, altr.name);
+          if(qctx->is_analytic())
+            return nullopt;
 
-          struct Sparam
-            {
-              AVM_Rod rods_body;
-              AVM_Rod rods_cond;
-            };
+          // Look for the name.
+          auto qref = qctx->get_named_reference_opt(altr.slot, altr.name);
+          if(!qref)
+            return nullopt;
+          else if(qref->is_invalid())
+            throw Runtime_Error(xtc_format,
+                     "Initialization of variable or reference `$1` bypassed", altr.name);
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rods_body, altr.code_body);
-          do_solidify_nodes(sp2.rods_cond, altr.code_cond);
+          // Bind this reference.
+          S_push_bound_reference xnode = { *qref };
+          return move(xnode);
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
+
+          // Rebind the function body.
+          // This is the only scenario where names in the outer scope are visible
+          // to the body of a function.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_func(xtc_function, &ctx, altr.params);
+          do_rebind_nodes(dirty, bound.code_body, ctx_func);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
+
+          // Rebind both branches.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_true, ctx);
+          do_rebind_nodes(dirty, bound.code_false, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
+
+          // Rebind the expression.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_body, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_catch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_catch_expression>();
+
+          // Rebind the expression.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_body, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_coalesce_expression:
+        {
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+
+          // Rebind the null branch.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_null, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
+
+void
+AIR_Node::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_throw_statement:
+      case index_assert_statement:
+      case index_simple_status:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_local_reference:
+      case index_function_call:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_return_statement:
+      case index_alt_clear_stack:
+      case index_alt_function_call:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+      case index_local_operator_bi32:
+      case index_local_member_access:
+      case index_local_operator:
+      case index_local_operator_local:
+        return;
+
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+
+          // Collect variables from the body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_if_statement:
+        {
+          const auto& altr = this->m_stor.as<S_if_statement>();
+
+          // Collect variables from both branches.
+          do_collect_variables_for_each(staged, temp, altr.code_true);
+          do_collect_variables_for_each(staged, temp, altr.code_false);
+          return;
+        }
+
+      case index_switch_statement:
+        {
+          const auto& altr = this->m_stor.as<S_switch_statement>();
+
+          // Collect variables from all labels and clauses.
+          for(const auto& clause : altr.clauses) {
+            do_collect_variables_for_each(staged, temp, clause.code_labels);
+            do_collect_variables_for_each(staged, temp, clause.code_body);
+          }
+          return;
+        }
+
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
+
+          // Collect variables from the body and the condition expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          return;
+        }
+
+      case index_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_while_statement>();
+
+          // Collect variables from the condition expression and the body.
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_for_each_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
+
+          // Collect variables from the range initializer and the body.
+          do_collect_variables_for_each(staged, temp, altr.code_init);
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_statement>();
+
+          // Collect variables from the initializer, condition expression and
+          // step expression.
+          do_collect_variables_for_each(staged, temp, altr.code_init);
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          do_collect_variables_for_each(staged, temp, altr.code_step);
+          return;
+        }
+
+      case index_try_statement:
+        {
+          const auto& altr = this->m_stor.as<S_try_statement>();
+
+          // Collect variables from the `try` and `catch` clauses.
+          do_collect_variables_for_each(staged, temp, altr.code_try);
+          do_collect_variables_for_each(staged, temp, altr.code_catch);
+          return;
+        }
+
+      case index_push_bound_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_bound_reference>();
+
+          // Collect variables from the bound reference.
+          altr.ref.collect_variables(staged, temp);
+          return;
+        }
+
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
+
+          // Collect variables from the function body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
+
+          // Collect variables from both branches.
+          do_collect_variables_for_each(staged, temp, altr.code_true);
+          do_collect_variables_for_each(staged, temp, altr.code_false);
+          return;
+        }
+
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
+
+          // Collect variables from the expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_catch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_catch_expression>();
+
+          // Collect variables from the expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_push_constant:
+        {
+          const auto& altr = this->m_stor.as<S_push_constant>();
+
+          // Collect variables from the expression.
+          altr.val.collect_variables(staged, temp);
+          return;
+        }
+
+      case index_coalesce_expression:
+        {
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+
+          // Collect variables from the null branch.
+          do_collect_variables_for_each(staged, temp, altr.code_null);
+          return;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
+
+bool
+AIR_Node::
+fuse_nodes(cow_vector<AIR_Node>& code)
+  {
+    // Process nested blocks first. Nodes are copied only if anything in them
+    // has been merged.
+    bool dirty = false;
+
+    for(size_t k = 0;  k < code.size();  ++k)
+      switch(static_cast<Index>(code.at(k).m_stor.index()))
+        {
+        case index_clear_stack:
+        case index_declare_variable:
+        case index_initialize_variable:
+        case index_throw_statement:
+        case index_assert_statement:
+        case index_simple_status:
+        case index_check_argument:
+        case index_push_global_reference:
+        case index_push_local_reference:
+        case index_push_bound_reference:
+        case index_define_function:
+        case index_defer_expression:
+        case index_function_call:
+        case index_push_unnamed_array:
+        case index_push_unnamed_object:
+        case index_apply_operator:
+        case index_unpack_array:
+        case index_unpack_object:
+        case index_define_null_variable:
+        case index_single_step_trap:
+        case index_variadic_call:
+        case index_import_call:
+        case index_declare_reference:
+        case index_initialize_reference:
+        case index_return_statement:
+        case index_push_constant:
+        case index_alt_clear_stack:
+        case index_alt_function_call:
+        case index_member_access:
+        case index_apply_operator_bi32:
+        case index_return_statement_bi32:
+        case index_local_operator_bi32:
+        case index_local_member_access:
+        case index_local_operator:
+        case index_local_operator_local:
+          break;
+
+        case index_execute_block:
+          {
+            auto altr = code.at(k).m_stor.as<S_execute_block>();
+            if(fuse_nodes(altr.code_body)) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_if_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_if_statement>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_true);
+            nested |= fuse_nodes(altr.code_false);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_switch_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_switch_statement>();
+            bool nested = false;
+            for(size_t i = 0;  i < altr.clauses.size();  ++i) {
+              auto clause = altr.clauses.at(i);
+              bool nested_clause = false;
+              nested_clause |= fuse_nodes(clause.code_labels);
+              nested_clause |= fuse_nodes(clause.code_body);
+              if(nested_clause) {
+                altr.clauses.mut(i) = move(clause);
+                nested = true;
+              }
+            }
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_do_while_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_do_while_statement>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_body);
+            nested |= fuse_nodes(altr.code_cond);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_while_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_while_statement>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_cond);
+            nested |= fuse_nodes(altr.code_body);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_for_each_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_for_each_statement>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_init);
+            nested |= fuse_nodes(altr.code_body);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_for_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_for_statement>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_init);
+            nested |= fuse_nodes(altr.code_cond);
+            nested |= fuse_nodes(altr.code_step);
+            nested |= fuse_nodes(altr.code_body);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_try_statement:
+          {
+            auto altr = code.at(k).m_stor.as<S_try_statement>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_try);
+            nested |= fuse_nodes(altr.code_catch);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_branch_expression:
+          {
+            auto altr = code.at(k).m_stor.as<S_branch_expression>();
+            bool nested = false;
+            nested |= fuse_nodes(altr.code_true);
+            nested |= fuse_nodes(altr.code_false);
+            if(nested) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_catch_expression:
+          {
+            auto altr = code.at(k).m_stor.as<S_catch_expression>();
+            if(fuse_nodes(altr.code_body)) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        case index_coalesce_expression:
+          {
+            auto altr = code.at(k).m_stor.as<S_coalesce_expression>();
+            if(fuse_nodes(altr.code_null)) {
+              code.mut(k) = move(altr);
+              dirty = true;
+            }
+            break;
+          }
+
+        default:
+          ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), code.at(k).m_stor.index());
+      }
+
+    // Look for local references that are immediately consumed by the next
+    // nodes, and merge each sequence into a single node. Nodes are copied
+    // only if a sequence has been found.
+    cow_vector<AIR_Node> fused;
+    bool merged = false;
+
+    for(size_t k = 0;  k < code.size();  ++k) {
+      const auto& node = code.at(k);
+      opt<AIR_Node> qnode;
+      size_t nnodes = 0;
+
+      if((node.m_stor.index() == index_push_local_reference) && (k + 1 < code.size())) {
+        const auto& local = node.m_stor.as<S_push_local_reference>();
+        const auto& next = code.at(k + 1);
+
+        switch(next.m_stor.index())
+          {
+          case index_push_local_reference:
+            {
+              // Look for a binary operator that is applied to both local
+              // references, such as `i < n` or `x += y`.
+              if((k + 2 >= code.size()) || (code.at(k + 2).m_stor.index() != index_apply_operator))
+                break;
+
+              const auto& rlocal = next.m_stor.as<S_push_local_reference>();
+              const auto& altr = code.at(k + 2).m_stor.as<S_apply_operator>();
+              if(!do_is_fusable_binary_operator(altr.xop))
+                break;
+
+              S_local_operator_local xnode = { altr.sloc, local.depth, local.slot, local.name,
+                                               rlocal.depth, rlocal.slot, rlocal.name,
+                                               altr.xop, altr.assign };
+              qnode.emplace(move(xnode));
+              nnodes = 3;
+              break;
+            }
+
+          case index_apply_operator_bi32:
+            {
+              const auto& altr = next.m_stor.as<S_apply_operator_bi32>();
+              if((altr.xop == xop_assign) || (altr.xop == xop_index))
+                break;
+
+              S_local_operator_bi32 xnode = { altr.sloc, local.depth, local.slot, local.name,
+                                              altr.xop, altr.assign, altr.irhs };
+              qnode.emplace(move(xnode));
+              nnodes = 2;
+              break;
+            }
+
+          case index_member_access:
+            {
+              const auto& altr = next.m_stor.as<S_member_access>();
+
+              S_local_member_access xnode = { altr.sloc, local.depth, local.slot, local.name,
+                                              altr.key };
+              qnode.emplace(move(xnode));
+              nnodes = 2;
+              break;
+            }
+
+          case index_apply_operator:
+            {
+              const auto& altr = next.m_stor.as<S_apply_operator>();
+              if((altr.xop != xop_inc) && (altr.xop != xop_dec))
+                break;
+
+              S_local_operator xnode = { altr.sloc, local.depth, local.slot, local.name,
+                                         altr.xop, altr.assign };
+              qnode.emplace(move(xnode));
+              nnodes = 2;
+              break;
+            }
+
+          default:
+            break;
+          }
+      }
+
+      if(!qnode) {
+        if(merged)
+          fused.emplace_back(node);
+        continue;
+      }
+
+      // Copy nodes before the first sequence.
+      if(!merged)
+        fused.append(code.begin(), code.begin() + static_cast<ptrdiff_t>(k));
+
+      merged = true;
+      fused.emplace_back(move(*qnode));
+      k += nnodes - 1;
+    }
+
+    if(merged)
+      code.swap(fused);
+
+    return dirty || merged;
+  }
+
+bool
+AIR_Node::
+is_bi32_operator(Xop xop) noexcept
+  {
+    return ::rocket::is_any_of(xop,
+             { xop_assign, xop_index, xop_cmp_eq, xop_cmp_ne, xop_cmp_un, xop_cmp_lt,
+               xop_cmp_gt, xop_cmp_lte, xop_cmp_gte, xop_cmp_3way, xop_add, xop_sub,
+               xop_mul, xop_div, xop_mod, xop_andb, xop_orb, xop_xorb, xop_addm, xop_subm,
+               xop_mulm, xop_adds, xop_subs, xop_muls, xop_sll, xop_srl, xop_sla, xop_sra });
+  }
+
+void
+AIR_Node::
+solidify(AVM_Rod& rod) const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+        {
+          const auto& altr = this->m_stor.as<S_clear_stack>();
+
+          (void) altr;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* /*head*/) -> AIR_Status
+            {
+              ctx.stack().clear();
+              return air_status_next;
+            }
+
+            // Uparam
+            , Uparam()
+
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+
+          struct Sparam
+            {
+              AVM_Rod rod_body;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_body, altr.code_body);
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              // Execute the block on a new context. The block may contain control
+              // statements, so the status shall be forwarded verbatim.
+              return do_execute_block(sp.rod_body, ctx);
+            }
+
+            // Uparam
+            , Uparam()
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_body.collect_variables(staged, temp);
+            }
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_declare_variable:
+        {
+          const auto& altr = this->m_stor.as<S_declare_variable>();
+
+          struct Sparam
+            {
+              phsh_string name;
+            };
+
+          Sparam sp2;
+          sp2.name = altr.name;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const auto& sloc = head->pv_meta->sloc;
+
+              // Allocate a variable and inject it into the current context.
+              const auto gcoll = ctx.global().garbage_collector();
+              const auto var = gcoll->create_variable();
+              ctx.insert_named_reference(sp.name).set_variable(var);
+
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_declare(sloc, sp.name);
+
+              // Push a copy of the reference onto the stack, which we will get
+              // back after the initializer finishes execution.
+              ctx.stack().push().set_variable(var);
+              return air_status_next;
+            }
+
+            // Uparam
+            , Uparam()
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_initialize_variable:
+        {
+          const auto& altr = this->m_stor.as<S_initialize_variable>();
+
+          Uparam up2;
+          up2.b0 = altr.immutable;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool immutable = head->uparam.b0;
+
+              // Read the value of the initializer. The initializer must not have
+              // been empty for this function.
+              const auto& val = ctx.stack().top().dereference_readonly();
+              ctx.stack().pop();
+
+              // Get the variable back.
+              auto var = ctx.stack().top().unphase_variable_opt();
+              ctx.stack().pop();
+              ROCKET_ASSERT(var && !var->is_initialized());
+
+              // Initialize it with this value.
+              var->initialize(val);
+              var->set_immutable(immutable);
+              return air_status_next;
+            }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_if_statement:
+        {
+          const auto& altr = this->m_stor.as<S_if_statement>();
+
+          Uparam up2;
+          up2.b0 = altr.negative;
+
+          struct Sparam
+            {
+              AVM_Rod rod_true;
+              AVM_Rod rod_false;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_true, altr.code_true);
+          do_solidify_nodes(sp2.rod_false, altr.code_false);
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool negative = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              // Read the condition and execute the corresponding branch as a block.
+              return (ctx.stack().top().dereference_readonly().test() != negative)
+                        ? do_execute_block(sp.rod_true, ctx)
+                        : do_execute_block(sp.rod_false, ctx);
+            }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_true.collect_variables(staged, temp);
+              sp.rod_false.collect_variables(staged, temp);
+            }
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_switch_statement:
+        {
+          const auto& altr = this->m_stor.as<S_switch_statement>();
+
+          struct Sparam_switch_clause
+            {
+              Switch_Clause_Type type;
+              Compare cmp2_lower;
+              Compare cmp2_upper;
+              AVM_Rod rod_labels;
+              AVM_Rod rod_body;
+              cow_vector<phsh_string> names_added;
+            };
+
+          using Sparam = cow_vector<Sparam_switch_clause>;
+          Sparam sp2;
+          sp2.reserve(altr.clauses.size());
+
+          for(const auto& clause : altr.clauses) {
+            auto& r = sp2.emplace_back();
+            r.type = clause.type;
+            r.cmp2_lower = clause.lower_closed ? compare_equal : compare_greater;
+            r.cmp2_upper = clause.upper_closed ? compare_equal : compare_less;
+            do_solidify_nodes(r.rod_labels, clause.code_labels);
+            do_solidify_nodes(r.rod_body, clause.code_body);
+            r.names_added = clause.names_added;
+          }
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              // Read the value of the condition and find the target clause for it.
+              // This is different from the `switch` statement in C, where `case`
+              // labels must have constant operands.
+              auto cond = ctx.stack().top().dereference_readonly();
+              size_t target_index = SIZE_MAX;
+
+              for(size_t k = 0;  k < sp.size();  ++k)
+                if(sp.at(k).type == switch_clause_default) {
+                  target_index = k;
+                }
+                else if(sp.at(k).type == switch_clause_case) {
+                  // Expect an exact match of one value.
+                  AIR_Status status = sp.at(k).rod_labels.execute(ctx);
+                  ROCKET_ASSERT(status == air_status_next);
+
+                  if(cond.compare_partial(ctx.stack().top().dereference_readonly()) != compare_equal)
+                    continue;
+
+                  target_index = k;
+                  break;
+                }
+                else if(sp.at(k).type == switch_clause_each) {
+                  // Expect an interval of two values.
+                  AIR_Status status = sp.at(k).rod_labels.execute(ctx);
+                  ROCKET_ASSERT(status == air_status_next);
+
+                  if(::rocket::is_none_of(cond.compare_partial(ctx.stack().top(1).dereference_readonly()),
+                                          { compare_greater, sp.at(k).cmp2_lower }))
+                    continue;
+
+                  if(::rocket::is_none_of(cond.compare_partial(ctx.stack().top(0).dereference_readonly()),
+                                          { compare_less, sp.at(k).cmp2_upper }))
+                    continue;
+
+                  target_index = k;
+                  break;
+                }
+
+              // Skip this statement if no matching clause has been found.
+              if(target_index >= sp.size())
+                return air_status_next;
+
+              // Jump to the target clause.
+              Executive_Context ctx_body(xtc_plain, ctx);
+              AIR_Status status = air_status_next;
+              try {
+                for(size_t i = 0;  i < sp.size();  ++i)
+                  if(i < target_index) {
+                    // Inject bypassed names into the scope.
+                    for(const auto& name : sp.at(i).names_added)
+                      ctx_body.insert_named_reference(name);
+                  }
+                  else {
+                    // Execute the body of this clause.
+                    AIR_Status next_status = sp.at(i).rod_body.execute(ctx_body);
+                    if(next_status != air_status_next) {
+                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_switch }))
+                        status = next_status;
+                      break;
+                    }
+                  }
+              }
+              catch(Runtime_Error& except) {
+                ctx_body.on_scope_exit_exceptional(except);
+                throw;
+              }
+              ctx_body.on_scope_exit_normal(status);
+              return status;
+            }
+
+            // Uparam
+            , Uparam()
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              for(const auto& r : *reinterpret_cast<const Sparam*>(head->sparam)) {
+                r.rod_labels.collect_variables(staged, temp);
+                r.rod_body.collect_variables(staged, temp);
+              }
+            }
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
+
+          Uparam up2;
+          up2.b0 = altr.negative;
+
+          struct Sparam
+            {
+              AVM_Rod rods_body;
+              AVM_Rod rods_cond;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rods_body, altr.code_body);
+          do_solidify_nodes(sp2.rods_cond, altr.code_cond);
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
               const bool negative = head->uparam.b0;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
@@ -2351,10 +3440,12 @@ solidify(AVM_Rod& rod) const
           struct Sparam
             {
               phsh_string name;
+              uint32_t slot;
             };
 
           Sparam sp2;
           sp2.name = altr.name;
+          sp2.slot = altr.slot;
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
@@ -2362,23 +3453,7 @@ solidify(AVM_Rod& rod) const
               const uint32_t depth = head->uparam.u2345;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Locate the target context.
-              const Executive_Context* qctx = &ctx;
-              for(uint32_t k = 0;  k != depth;  ++k)
-                qctx = qctx->get_parent_opt();
-
-              // Look for the name in the target context.
-              auto qref = qctx->get_named_reference_opt(sp.name);
-              if(!qref)
-                throw Runtime_Error(xtc_format,
-                         "Undeclared identifier `$1`", sp.name);
-
-              if(qref->is_invalid())
-                throw Runtime_Error(xtc_format,
-                         "Initialization of `$1` was bypassed", sp.name);
-
-              // Push a copy of the reference onto the stack.
-              ctx.stack().push() = *qref;
+              do_push_local_reference(ctx, depth, sp.slot, sp.name);
               return air_status_next;
             }
 
@@ -2704,82 +3779,10 @@ solidify(AVM_Rod& rod) const
                   switch(uxop)
                       {
                     case xop_inc:
-                      {
-                        // `assign` is `true` for the postfix variant and `false` for
-                        // the prefix variant.
-                        auto& rhs = top.dereference_mutable();
-
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
-
-                          // Increment the value with overflow checking.
-                          int64_t result;
-                          if(ROCKET_ADD_OVERFLOW(val, 1, &result))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer increment overflow (operand was `$1`)", val);
-
-                          if(assign)
-                            top.set_temporary(val);
-
-                          val = result;
-                          return air_status_next;
-                        }
-
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
-
-                          // Overflow will result in an infinity, so this is safe.
-                          double result = val + 1;
-
-                          if(assign)
-                            top.set_temporary(val);
-
-                          val = result;
-                          return air_status_next;
-                        }
-
-                        throw Runtime_Error(xtc_format,
-                                 "Increment not applicable (operand was `$1`)", rhs);
-                      }
+                      return do_apply_increment(top, assign);
 
                     case xop_dec:
-                      {
-                        // `assign` is `true` for the postfix variant and `false` for
-                        // the prefix variant.
-                        auto& rhs = top.dereference_mutable();
-
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
-
-                          // Decrement the value with overflow checking.
-                          int64_t result;
-                          if(ROCKET_SUB_OVERFLOW(val, 1, &result))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer decrement overflow (operand was `$1`)", val);
-
-                          if(assign)
-                            top.set_temporary(val);
-
-                          val = result;
-                          return air_status_next;
-                        }
-
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
-
-                          // Overflow will result in an infinity, so this is safe.
-                          double result = val - 1;
-
-                          if(assign)
-                            top.set_temporary(val);
-
-                          val = result;
-                          return air_status_next;
-                        }
-
-                        throw Runtime_Error(xtc_format,
-                                 "Decrement not applicable (operand was `$1`)", rhs);
-                      }
+                      return do_apply_decrement(top, assign);
 
                     case xop_unset:
                       {
@@ -3003,849 +4006,1093 @@ solidify(AVM_Rod& rod) const
                         return air_status_next;
                       }
 
-                    case xop_countof:
+                    case xop_countof:
+                      {
+                        // Get the number of elements in the operand.
+                        if(rhs.type() == type_null) {
+                          rhs = V_integer(0);
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_string) {
+                          rhs = V_integer(rhs.as_string().size());
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_array) {
+                          rhs = V_integer(rhs.as_array().size());
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_object) {
+                          rhs = V_integer(rhs.as_object().size());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`countof` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_typeof:
+                      {
+                        // Ge the type of the operand as a string.
+                        rhs = ::rocket::sref(describe_type(rhs.type()));
+                        return air_status_next;
+                      }
+
+                    case xop_sqrt:
+                      {
+                        // Get the arithmetic square root of the operand, as a real number.
+                        if(rhs.is_real()) {
+                          rhs = ::std::sqrt(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__sqrt` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_isnan:
+                      {
+                        // Checks whether the operand is a NaN. The operand must be of an
+                        // arithmetic type. An integer is never a NaN.
+                        if(rhs.type() == type_integer) {
+                          rhs = false;
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          rhs = ::std::isnan(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__isnan` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_isinf:
+                      {
+                        // Checks whether the operand is an infinity. The operand must be of
+                        // an arithmetic type. An integer is never an infinity.
+                        if(rhs.type() == type_integer) {
+                          rhs = false;
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          rhs = ::std::isinf(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__isinf` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_abs:
+                      {
+                        // Get the absolute value of the operand.
+                        if(rhs.type() == type_integer) {
+                          V_integer& val = rhs.mut_integer();
+
+                          V_integer neg_val;
+                          if(ROCKET_SUB_OVERFLOW(0, val, &neg_val))
+                            throw Runtime_Error(xtc_format,
+                                     "Integer negation overflow (operand was `$1`)", val);
+
+                          val ^= (val ^ neg_val) & (val >> 63);
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          V_real& val = rhs.mut_real();
+
+                          double result = ::std::fabs(val);
+
+                          val = result;
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__abs` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_sign:
+                      {
+                        // Get the sign bit of the operand as a boolean value.
+                        if(rhs.type() == type_integer) {
+                          rhs = rhs.as_integer() < 0;
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          rhs = ::std::signbit(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__sign` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_round:
+                      {
+                        // Round the operand to the nearest integer of the same type.
+                        if(rhs.type() == type_integer) {
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          rhs.mut_real() = ::std::round(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__round` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_floor:
+                      {
+                        // Round the operand to the nearest integer of the same type,
+                        // towards negative infinity.
+                        if(rhs.type() == type_integer) {
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          rhs.mut_real() = ::std::floor(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__floor` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_ceil:
+                      {
+                        // Round the operand to the nearest integer of the same type,
+                        // towards positive infinity.
+                        if(rhs.type() == type_integer) {
+                          return air_status_next;
+                        }
+
+                        if(rhs.type() == type_real) {
+                          rhs.mut_real() = ::std::ceil(rhs.as_real());
+                          return air_status_next;
+                        }
+
+                        throw Runtime_Error(xtc_format,
+                                 "`__ceil` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_trunc:
                       {
-                        // Get the number of elements in the operand.
-                        if(rhs.type() == type_null) {
-                          rhs = V_integer(0);
+                        // Truncate the operand to the nearest integer towards zero.
+                        if(rhs.type() == type_integer) {
                           return air_status_next;
                         }
 
-                        if(rhs.type() == type_string) {
-                          rhs = V_integer(rhs.as_string().size());
+                        if(rhs.type() == type_real) {
+                          rhs.mut_real() = ::std::trunc(rhs.as_real());
                           return air_status_next;
                         }
 
-                        if(rhs.type() == type_array) {
-                          rhs = V_integer(rhs.as_array().size());
+                        throw Runtime_Error(xtc_format,
+                                 "`__trunc` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_iround:
+                      {
+                        // Round the operand to the nearest integer.
+                        if(rhs.type() == type_integer) {
                           return air_status_next;
                         }
 
-                        if(rhs.type() == type_object) {
-                          rhs = V_integer(rhs.as_object().size());
+                        if(rhs.type() == type_real) {
+                          rhs = safe_double_to_int64(::std::round(rhs.as_real()));
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "`countof` not applicable (operand was `$1`)", rhs);
+                                 "`__iround` not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_typeof:
+                    case xop_ifloor:
                       {
-                        // Ge the type of the operand as a string.
-                        rhs = ::rocket::sref(describe_type(rhs.type()));
-                        return air_status_next;
-                      }
+                        // Round the operand to the nearest integer towards negative infinity.
+                        if(rhs.type() == type_integer) {
+                          return air_status_next;
+                        }
 
-                    case xop_sqrt:
-                      {
-                        // Get the arithmetic square root of the operand, as a real number.
-                        if(rhs.is_real()) {
-                          rhs = ::std::sqrt(rhs.as_real());
+                        if(rhs.type() == type_real) {
+                          rhs = safe_double_to_int64(::std::floor(rhs.as_real()));
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "`__sqrt` not applicable (operand was `$1`)", rhs);
+                                 "`__ifloor` not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_isnan:
+                    case xop_iceil:
                       {
-                        // Checks whether the operand is a NaN. The operand must be of an
-                        // arithmetic type. An integer is never a NaN.
+                        // Round the operand to the nearest integer towards positive infinity.
                         if(rhs.type() == type_integer) {
-                          rhs = false;
                           return air_status_next;
                         }
 
                         if(rhs.type() == type_real) {
-                          rhs = ::std::isnan(rhs.as_real());
+                          rhs = safe_double_to_int64(::std::ceil(rhs.as_real()));
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "`__isnan` not applicable (operand was `$1`)", rhs);
+                                 "`__iceil` not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_isinf:
+                    case xop_itrunc:
                       {
-                        // Checks whether the operand is an infinity. The operand must be of
-                        // an arithmetic type. An integer is never an infinity.
+                        // Truncate the operand to the nearest integer towards zero.
                         if(rhs.type() == type_integer) {
-                          rhs = false;
                           return air_status_next;
                         }
 
                         if(rhs.type() == type_real) {
-                          rhs = ::std::isinf(rhs.as_real());
+                          rhs = safe_double_to_int64(::std::trunc(rhs.as_real()));
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "`__isinf` not applicable (operand was `$1`)", rhs);
+                                 "`__itrunc` not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_abs:
+                    case xop_lzcnt:
                       {
-                        // Get the absolute value of the operand.
+                        // Get the number of leading zeroes in the operand.
                         if(rhs.type() == type_integer) {
                           V_integer& val = rhs.mut_integer();
 
-                          V_integer neg_val;
-                          if(ROCKET_SUB_OVERFLOW(0, val, &neg_val))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer negation overflow (operand was `$1`)", val);
+                          val = (int64_t) ROCKET_LZCNT64((uint64_t) val);
+                          return air_status_next;
+                        }
 
-                          val ^= (val ^ neg_val) & (val >> 63);
+                        throw Runtime_Error(xtc_format,
+                                 "`__lzcnt` not applicable (operand was `$1`)", rhs);
+                      }
+
+                    case xop_tzcnt:
+                      {
+                        // Get the number of trailing zeroes in the operand.
+                        if(rhs.type() == type_integer) {
+                          V_integer& val = rhs.mut_integer();
+
+                          val = (int64_t) ROCKET_TZCNT64((uint64_t) val);
                           return air_status_next;
                         }
 
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
+                        throw Runtime_Error(xtc_format,
+                                 "`__tzcnt` not applicable (operand was `$1`)", rhs);
+                      }
 
-                          double result = ::std::fabs(val);
+                    case xop_popcnt:
+                      {
+                        // Get the number of ones in the operand.
+                        if(rhs.type() == type_integer) {
+                          V_integer& val = rhs.mut_integer();
 
-                          val = result;
+                          val = (int64_t) ROCKET_POPCNT64((uint64_t) val);
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "`__abs` not applicable (operand was `$1`)", rhs);
+                                 "`__popcnt` not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_sign:
-                      {
-                        // Get the sign bit of the operand as a boolean value.
-                        if(rhs.type() == type_integer) {
-                          rhs = rhs.as_integer() < 0;
-                          return air_status_next;
-                        }
+                    default:
+                      ROCKET_UNREACHABLE();
+                  }
+                }
+
+                // Uparam
+                , up2
+
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            case xop_cmp_eq:
+            case xop_cmp_ne:
+            case xop_cmp_un:
+            case xop_cmp_lt:
+            case xop_cmp_gt:
+            case xop_cmp_lte:
+            case xop_cmp_gte:
+            case xop_cmp_3way:
+            case xop_add:
+            case xop_sub:
+            case xop_mul:
+            case xop_div:
+            case xop_mod:
+            case xop_andb:
+            case xop_orb:
+            case xop_xorb:
+            case xop_addm:
+            case xop_subm:
+            case xop_mulm:
+            case xop_adds:
+            case xop_subs:
+            case xop_muls:
+              // binary
+              up2.u2 = 0;
+              up2.u3 = 0;
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint8_t uxop = head->uparam.u1;
+                  const auto& rhs = ctx.stack().top().dereference_readonly();
+                  ctx.stack().pop();
+                  auto& top = ctx.stack().mut_top();
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  // Record types of operands. This node may be specialized.
+                  if(head->uparam.u3 != feedback_disabled)
+                    do_record_binary_feedback(head, lhs, rhs);
+
+                  // The fast path should be a proper tail call.
+                  if(rhs.type() == type_integer)
+                    return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
+
+                  return do_apply_binary_operator_with_value(uxop, lhs, rhs);
+                }
+
+                // Uparam
+                , up2
+
+                // Sparam
+                , sizeof(AVM_Rod::Executor*), nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            case xop_sll:
+            case xop_srl:
+            case xop_sla:
+            case xop_sra:
+              // shift
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint8_t uxop = head->uparam.u1;
+                  const auto& rhs = ctx.stack().top().dereference_readonly();
+                  ctx.stack().pop();
+                  auto& top = ctx.stack().mut_top();
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  if(rhs.type() != type_integer)
+                    throw Runtime_Error(xtc_format,
+                             "Invalid shift count (operands were `$1` and `$2`)",
+                             lhs, rhs);
+
+                  return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
+                }
+
+                // Uparam
+                , up2
+
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            case xop_fma:
+              // fused multiply-add; ternary
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const auto& rhs = ctx.stack().top().dereference_readonly();
+                  ctx.stack().pop();
+                  const auto& mid = ctx.stack().top().dereference_readonly();
+                  ctx.stack().pop();
+                  auto& top = ctx.stack().mut_top();
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  // Perform floating-point fused multiply-add.
+                  if(lhs.is_real() && mid.is_real() && rhs.is_real()) {
+                    V_real& val = lhs.mut_real();
+                    V_real y_mul = mid.as_real();
+                    V_real z_add = rhs.as_real();
+
+                    val = ::std::fma(val, y_mul, z_add);
+                    return air_status_next;
+                  }
+
+                  throw Runtime_Error(xtc_format,
+                           "`__fma` not applicable (operands were `$1`, `$2` and `$3`)",
+                           lhs, mid, rhs);
+                }
+
+                // Uparam
+                , up2
+
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            default:
+              ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), altr.xop);
+          }
+        }
 
-                        if(rhs.type() == type_real) {
-                          rhs = ::std::signbit(rhs.as_real());
-                          return air_status_next;
-                        }
+      case index_unpack_array:
+        {
+          const auto& altr = this->m_stor.as<S_unpack_array>();
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__sign` not applicable (operand was `$1`)", rhs);
-                      }
+          Uparam up2;
+          up2.b0 = altr.immutable;
+          up2.u2345 = altr.nelems;
 
-                    case xop_round:
-                      {
-                        // Round the operand to the nearest integer of the same type.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool immutable = head->uparam.b0;
+              const uint32_t nelems = head->uparam.u2345;
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::round(rhs.as_real());
-                          return air_status_next;
-                        }
+              // Read the value of the initializer.
+              const auto& init = ctx.stack().top().dereference_readonly();
+              ctx.stack().pop();
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__round` not applicable (operand was `$1`)", rhs);
-                      }
+              // Make sure it is really an array.
+              if(!init.is_null() && !init.is_array())
+                throw Runtime_Error(xtc_format,
+                         "Initializer was not an array (value was `$1`)", init);
 
-                    case xop_floor:
-                      {
-                        // Round the operand to the nearest integer of the same type,
-                        // towards negative infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+              for(uint32_t i = nelems - 1;  i != UINT32_MAX;  --i) {
+                // Pop variables from from right to left.
+                auto var = ctx.stack().top().unphase_variable_opt();
+                ctx.stack().pop();
+                ROCKET_ASSERT(var && !var->is_initialized());
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::floor(rhs.as_real());
-                          return air_status_next;
-                        }
+                if(ROCKET_EXPECT(init.is_array()))
+                  if(auto ielem = init.as_array().ptr(i))
+                    var->initialize(*ielem);
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__floor` not applicable (operand was `$1`)", rhs);
-                      }
+                if(ROCKET_UNEXPECT(!var->is_initialized()))
+                  var->initialize(nullopt);
 
-                    case xop_ceil:
-                      {
-                        // Round the operand to the nearest integer of the same type,
-                        // towards positive infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+                var->set_immutable(immutable);
+              }
+              return air_status_next;
+            }
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::ceil(rhs.as_real());
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__ceil` not applicable (operand was `$1`)", rhs);
-                      }
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-                    case xop_trunc:
-                      {
-                        // Truncate the operand to the nearest integer towards zero.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+            // Collector
+            , nullptr
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::trunc(rhs.as_real());
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__trunc` not applicable (operand was `$1`)", rhs);
-                      }
+      case index_unpack_object:
+        {
+          const auto& altr = this->m_stor.as<S_unpack_object>();
 
-                    case xop_iround:
-                      {
-                        // Round the operand to the nearest integer.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+          Uparam up2;
+          up2.b0 = altr.immutable;
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::round(rhs.as_real()));
-                          return air_status_next;
-                        }
+          struct Sparam
+            {
+              cow_vector<phsh_string> keys;
+            };
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__iround` not applicable (operand was `$1`)", rhs);
-                      }
+          Sparam sp2;
+          sp2.keys = altr.keys;
 
-                    case xop_ifloor:
-                      {
-                        // Round the operand to the nearest integer towards negative infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool immutable = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::floor(rhs.as_real()));
-                          return air_status_next;
-                        }
+              // Read the value of the initializer.
+              const auto& init = ctx.stack().top().dereference_readonly();
+              ctx.stack().pop();
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__ifloor` not applicable (operand was `$1`)", rhs);
-                      }
+              // Make sure it is really an object.
+              if(!init.is_null() && !init.is_object())
+                throw Runtime_Error(xtc_format,
+                         "Initializer was not an object (value was `$1`)", init);
 
-                    case xop_iceil:
-                      {
-                        // Round the operand to the nearest integer towards positive infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+              for(auto it = sp.keys.rbegin();  it != sp.keys.rend();  ++it) {
+                // Pop variables from from right to left.
+                auto var = ctx.stack().top().unphase_variable_opt();
+                ctx.stack().pop();
+                ROCKET_ASSERT(var && !var->is_initialized());
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::ceil(rhs.as_real()));
-                          return air_status_next;
-                        }
+                if(ROCKET_EXPECT(init.is_object()))
+                  if(auto ielem = init.as_object().ptr(*it))
+                    var->initialize(*ielem);
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__iceil` not applicable (operand was `$1`)", rhs);
-                      }
+                if(ROCKET_UNEXPECT(!var->is_initialized()))
+                  var->initialize(nullopt);
 
-                    case xop_itrunc:
-                      {
-                        // Truncate the operand to the nearest integer towards zero.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+                var->set_immutable(immutable);
+              }
+              return air_status_next;
+            }
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::trunc(rhs.as_real()));
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__itrunc` not applicable (operand was `$1`)", rhs);
-                      }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                    case xop_lzcnt:
-                      {
-                        // Get the number of leading zeroes in the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+            // Collector
+            , nullptr
 
-                          val = (int64_t) ROCKET_LZCNT64((uint64_t) val);
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__lzcnt` not applicable (operand was `$1`)", rhs);
-                      }
+      case index_define_null_variable:
+        {
+          const auto& altr = this->m_stor.as<S_define_null_variable>();
 
-                    case xop_tzcnt:
-                      {
-                        // Get the number of trailing zeroes in the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+          Uparam up2;
+          up2.b0 = altr.immutable;
 
-                          val = (int64_t) ROCKET_TZCNT64((uint64_t) val);
-                          return air_status_next;
-                        }
+          struct Sparam
+            {
+              phsh_string name;
+            };
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__tzcnt` not applicable (operand was `$1`)", rhs);
-                      }
+          Sparam sp2;
+          sp2.name = altr.name;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool immutable = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const auto& sloc = head->pv_meta->sloc;
 
-                    case xop_popcnt:
-                      {
-                        // Get the number of ones in the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+              // Allocate a variable and inject it into the current context.
+              const auto gcoll = ctx.global().garbage_collector();
+              const auto var = gcoll->create_variable();
+              ctx.insert_named_reference(sp.name).set_variable(var);
 
-                          val = (int64_t) ROCKET_POPCNT64((uint64_t) val);
-                          return air_status_next;
-                        }
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_declare(sloc, sp.name);
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__popcnt` not applicable (operand was `$1`)", rhs);
-                      }
+              // Initialize it to null.
+              var->initialize(nullopt);
+              var->set_immutable(immutable);
+              return air_status_next;
+            }
 
-                    default:
-                      ROCKET_UNREACHABLE();
-                  }
-                }
+            // Uparam
+            , up2
 
-                // Uparam
-                , up2
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+            // Collector
+            , nullptr
 
-                // Collector
-                , nullptr
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+      case index_single_step_trap:
+        {
+          const auto& altr = this->m_stor.as<S_single_step_trap>();
 
-            case xop_cmp_eq:
-            case xop_cmp_ne:
-            case xop_cmp_un:
-            case xop_cmp_lt:
-            case xop_cmp_gt:
-            case xop_cmp_lte:
-            case xop_cmp_gte:
-            case xop_cmp_3way:
-            case xop_add:
-            case xop_sub:
-            case xop_mul:
-            case xop_div:
-            case xop_mod:
-            case xop_andb:
-            case xop_orb:
-            case xop_xorb:
-            case xop_addm:
-            case xop_subm:
-            case xop_mulm:
-            case xop_adds:
-            case xop_subs:
-            case xop_muls:
-              // binary
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-                {
-                  const bool assign = head->uparam.b0;
-                  const uint8_t uxop = head->uparam.u1;
-                  const auto& rhs = ctx.stack().top().dereference_readonly();
-                  ctx.stack().pop();
-                  auto& top = ctx.stack().mut_top();
-                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+          (void) altr;
 
-                  // The fast path should be a proper tail call.
-                  if(rhs.type() == type_integer)
-                    return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sloc = head->pv_meta->sloc;
 
-                  switch(uxop)
-                      {
-                    case xop_cmp_eq:
-                      {
-                        // Check whether the two operands are equal. Unordered values are
-                        // considered to be unequal.
-                        lhs = lhs.compare_partial(rhs) == compare_equal;
-                        return air_status_next;
-                      }
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_trap(sloc, ctx);
 
-                    case xop_cmp_ne:
-                      {
-                        // Check whether the two operands are not equal. Unordered values are
-                        // considered to be unequal.
-                        lhs = lhs.compare_partial(rhs) != compare_equal;
-                        return air_status_next;
-                      }
+              return air_status_next;
+            }
 
-                    case xop_cmp_un:
-                      {
-                        // Check whether the two operands are unordered.
-                        lhs = lhs.compare_partial(rhs) == compare_unordered;
-                        return air_status_next;
-                      }
+            // Uparam
+            , Uparam()
 
-                    case xop_cmp_lt:
-                      {
-                        // Check whether the LHS operand is less than the RHS operand. If
-                        // they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) == compare_less;
-                        return air_status_next;
-                      }
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-                    case xop_cmp_gt:
-                      {
-                        // Check whether the LHS operand is greater than the RHS operand. If
-                        // they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) == compare_greater;
-                        return air_status_next;
-                      }
+            // Collector
+            , nullptr
 
-                    case xop_cmp_lte:
-                      {
-                        // Check whether the LHS operand is less than or equal to the RHS
-                        // operand. If they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) != compare_greater;
-                        return air_status_next;
-                      }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                    case xop_cmp_gte:
-                      {
-                        // Check whether the LHS operand is greater than or equal to the RHS
-                        // operand. If they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) != compare_less;
-                        return air_status_next;
-                      }
+      case index_variadic_call:
+        {
+          const auto& altr = this->m_stor.as<S_variadic_call>();
 
-                    case xop_cmp_3way:
-                      {
-                        // Defines a partial ordering on all values. For unordered operands,
-                        // a string is returned, so `x <=> y` and `(x <=> y) <=> 0` produces
-                        // the same result.
-                        int64_t cmp = lhs.compare_partial(rhs);
-                        lhs = cmp - compare_equal;
-                        if(ROCKET_UNEXPECT(cmp == compare_unordered))
-                          lhs = &"[unordered]";
-                        return air_status_next;
-                      }
+          Uparam up2;
+          up2.u0 = altr.ptc;
 
-                    case xop_add:
-                      {
-                        // Perform logical OR on two boolean values, or get the sum of two
-                        // arithmetic values, or concatenate two strings.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const PTC_Aware ptc = static_cast<PTC_Aware>(head->uparam.u0);
+              const auto& sloc = head->pv_meta->sloc;
+              const auto sentry = ctx.global().copy_recursion_sentry();
 
-                          val += other;
-                          return air_status_next;
-                        }
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_trap(sloc, ctx);
 
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& other = rhs.as_string();
+              auto temp_value = ctx.stack().top().dereference_readonly();
+              if(temp_value.is_null()) {
+                // There is no argument for the target function.
+                ctx.alt_stack().clear();
+                ctx.stack().pop();
+              }
+              else if(temp_value.is_array()) {
+                // Push all values from left to right, as temporary values.
+                ctx.alt_stack().clear();
+                for(const auto& val : temp_value.as_array())
+                  ctx.alt_stack().push().set_temporary(val);
+                ctx.stack().pop();
+              }
+              else if(temp_value.is_function()) {
+                // Invoke the generator function with no argument to get the number
+                // of variadic arguments. This destroys its self reference, so we have
+                // to stash it first.
+                auto va_gen = move(temp_value.mut_function());
+                ctx.stack().mut_top().pop_modifier();
+                ctx.stack().push();
+                ctx.stack().mut_top() = ctx.stack().mut_top(1);
+                ctx.alt_stack().clear();
+                do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none, va_gen);
+                temp_value = ctx.stack().top().dereference_readonly();
+                ctx.stack().pop();
 
-                          val.append(other);
-                          return air_status_next;
-                        }
+                if(temp_value.type() != type_integer)
+                  throw Runtime_Error(xtc_format,
+                           "Invalid number of variadic arguments (value `$1`)", temp_value);
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+                if((temp_value.as_integer() < 0) || (temp_value.as_integer() > INT_MAX))
+                  throw Runtime_Error(xtc_format,
+                           "Invalid number of variadic arguments (value `$1`)", temp_value);
 
-                          val |= other;
-                          return air_status_next;
-                        }
+                const uint32_t nargs = static_cast<uint32_t>(temp_value.as_integer());
+                if(nargs == 0) {
+                  // There is no argument for the target function.
+                  ctx.alt_stack().clear();
+                  ctx.stack().pop();
+                }
+                else {
+                  // Initialize `this` references for variadic arguments.
+                  for(uint32_t k = 0;  k != nargs - 1;  ++k) {
+                    ctx.stack().push();
+                    ctx.stack().mut_top() = ctx.stack().top(1);
+                  }
 
-                        throw Runtime_Error(xtc_format,
-                                 "Addition not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                  // Generate varaidic arguments, and store them on `stack` from
+                  // right to left for later use.
+                  for(uint32_t k = 0;  k != nargs;  ++k) {
+                    ctx.alt_stack().clear();
+                    ctx.alt_stack().push().set_temporary(V_integer(k));
+                    do_invoke_partial(ctx.stack().mut_top(k), ctx, sloc, ptc_aware_none, va_gen);
+                    ctx.stack().top(k).dereference_readonly();
+                  }
 
-                    case xop_sub:
-                      {
-                        // Perform logical XOR on two boolean values, or get the difference
-                        // of two arithmetic values.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          // Overflow will result in an infinity, so this is safe.
-                          val -= other;
-                          return air_status_next;
-                        }
+                  // Move arguments into `alt_stack` from left to right.
+                  ctx.alt_stack().clear();
+                  for(uint32_t k = 0;  k != nargs;  ++k)
+                    ctx.alt_stack().push() = move(ctx.stack().mut_top(k));
+                  ctx.stack().pop(nargs);
+                }
+              }
+              else
+                throw Runtime_Error(xtc_format,
+                         "Invalid variadic argument generator (value `$1`)", temp_value);
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+              // Invoke the target function with arguments from `alt_stack`.
+              ctx.stack().clear_red_zone();
+              temp_value = ctx.stack().top().dereference_readonly();
+              ctx.stack().mut_top().pop_modifier();
+              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc, temp_value);
+            }
 
-                          // Perform logical XOR of the operands.
-                          val ^= other;
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "Subtraction not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-                    case xop_mul:
-                      {
-                         // Perform logical AND on two boolean values, or get the product of
-                         // two arithmetic values, or duplicate a string or array by a given
-                         // times.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          val *= other;
-                          return air_status_next;
-                        }
+            // Collector
+            , nullptr
 
-                        if(lhs.is_integer() && rhs.is_string()) {
-                          V_integer count = lhs.as_integer();
-                          lhs = rhs.as_string();
-                          V_string& val = lhs.mut_string();
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                          do_duplicate_sequence(val, count);
-                          return air_status_next;
-                        }
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
 
-                        if(lhs.is_integer() && rhs.is_array()) {
-                          V_integer count = lhs.as_integer();
-                          lhs = rhs.as_array();
-                          V_array& val = lhs.mut_array();
+          struct Sparam
+            {
+              cow_vector<AIR_Node> code_body;
+            };
 
-                          do_duplicate_sequence(val, count);
-                          return air_status_next;
-                        }
+          Sparam sp2;
+          sp2.code_body = altr.code_body;
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const auto& sloc = head->pv_meta->sloc;
 
-                          val &= other;
-                          return air_status_next;
-                        }
+              // Capture local references at this time.
+              bool dirty = false;
+              auto bound_body = sp.code_body;
+              do_rebind_nodes(dirty, bound_body, ctx);
 
-                        throw Runtime_Error(xtc_format,
-                                 "Multiplication not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+              // Instantiate the expression and push it to the current context.
+              AVM_Rod rod_body;
+              do_solidify_nodes(rod_body, bound_body);
+              ctx.mut_defer().emplace_back(sloc, move(rod_body));
+              return air_status_next;
+            }
 
-                    case xop_div:
-                      {
-                        // Get the quotient of two arithmetic values. If both operands are
-                        // integers, the result is also an integer, truncated towards zero.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
+            // Uparam
+            , Uparam()
 
-                          val /= other;
-                          return air_status_next;
-                        }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                        throw Runtime_Error(xtc_format,
-                                 "Division not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              do_collect_variables_for_each(staged, temp, sp.code_body);
+            }
 
-                    case xop_mod:
-                      {
-                        // Get the remainder of two arithmetic values. The quotient is
-                        // truncated towards zero. If both operands are integers, the result
-                        // is also an integer.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          val = ::std::fmod(val, other);
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        throw Runtime_Error(xtc_format,
-                                 "Modulo not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+      case index_import_call:
+        {
+          const auto& altr = this->m_stor.as<S_import_call>();
 
-                    case xop_andb:
-                      {
-                        // Perform the bitwise AND operation on all bits of the operands. If
-                        // the two operands have different lengths, the result is truncated
-                        // to the same length as the shorter one.
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& mask = rhs.as_string();
-
-                          if(val.size() > mask.size())
-                            val.erase(mask.size());
-                          auto maskp = mask.begin();
-                          for(auto it = val.mut_begin();  it != val.end();  ++it, ++maskp)
-                            *it = static_cast<char>(*it & *maskp);
-                          return air_status_next;
-                        }
+          Uparam up2;
+          up2.u2345 = altr.nargs;
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+          struct Sparam
+            {
+              Compiler_Options opts;
+            };
 
-                          val &= other;
-                          return air_status_next;
-                        }
+          Sparam sp2;
+          sp2.opts = altr.opts;
 
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise AND not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const uint32_t nargs = head->uparam.u2345;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const auto& sloc = head->pv_meta->sloc;
+              const auto sentry = ctx.global().copy_recursion_sentry();
 
-                    case xop_orb:
-                      {
-                        // Perform the bitwise OR operation on all bits of the operands. If
-                        // the two operands have different lengths, the result is padded to
-                        // the same length as the longer one, with zeroes.
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& mask = rhs.as_string();
-
-                          if(val.size() < mask.size())
-                            val.append(mask.size() - val.size(), 0);
-                          auto valp = val.mut_begin();
-                          for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
-                            *valp = static_cast<char>(*valp | *it);
-                          return air_status_next;
-                        }
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_trap(sloc, ctx);
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+              // Collect arguments from left to right.
+              ctx.alt_stack().clear();
+              for(uint32_t k = 0;  k != nargs - 1;  ++k)
+                ctx.alt_stack().push() = move(ctx.stack().mut_top(nargs - 2 - k));
+              ctx.stack().pop(nargs - 1);
 
-                          val |= other;
-                          return air_status_next;
-                        }
+              // Get the path to import.
+              const auto& path_val = ctx.stack().top().dereference_readonly();
+              if(path_val.type() != type_string)
+                throw Runtime_Error(xtc_format,
+                         "Path was not a string (value `$1`)", path_val);
 
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise OR not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+              if(path_val.as_string() == "")
+                throw Runtime_Error(xtc_format, "Path was empty");
 
-                    case xop_xorb:
-                      {
-                        // Perform the bitwise XOR operation on all bits of the operands. If
-                        // the two operands have different lengths, the result is padded to
-                        // the same length as the longer one, with zeroes.
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& mask = rhs.as_string();
-
-                          if(val.size() < mask.size())
-                            val.append(mask.size() - val.size(), 0);
-                          auto valp = val.mut_begin();
-                          for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
-                            *valp = static_cast<char>(*valp ^ *it);
-                          return air_status_next;
-                        }
+              cow_string abs_path = path_val.as_string();
+              if(abs_path[0] != '/') {
+                const auto& src_file = sloc.file();
+                if(src_file[0] == '/') {
+                  size_t pos = src_file.rfind('/');
+                  ROCKET_ASSERT(pos != cow_string::npos);
+                  abs_path.insert(0, src_file.c_str(), pos + 1);
+                }
+              }
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+              abs_path = get_real_path(abs_path);
+              Source_Location script_sloc(abs_path, 0, 0);
 
-                          val ^= other;
-                          return air_status_next;
-                        }
+              // The file is kept locked until the script returns, so recursive
+              // imports can be detected.
+              const auto loader = ctx.global().module_loader();
+              Module_Loader::Unique_Stream istrm;
+              istrm.reset(loader, abs_path);
 
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise XOR not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+              // If the script has been compiled before and has not been modified
+              // since, reuse the compiled function.
+              auto target = loader->get_cached_module_opt(abs_path, sp.opts, istrm);
+              if(!target) {
+                Token_Stream tstrm(sp.opts);
+                tstrm.reload(abs_path, 1, move(istrm.get()));
 
-                    case xop_addm:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Modular addition not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                Statement_Sequence stmtq(sp.opts);
+                stmtq.reload(move(tstrm));
 
-                    case xop_subm:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Modular subtraction not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                // Instantiate the script as a variadic function.
+                cow_vector<phsh_string> script_params;
+                script_params.emplace_back(&"...");
 
-                    case xop_mulm:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Modular multiplication not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                AIR_Optimizer optmz(sp.opts);
+                optmz.reload(nullptr, script_params, ctx.global(), stmtq.get_statements());
 
-                    case xop_adds:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Saturating addition not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                target = optmz.create_function(script_sloc, &"[file scope]");
+                loader->set_cached_module(abs_path, sp.opts, istrm, target);
+              }
 
-                    case xop_subs:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Saturating subtraction not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+              ctx.stack().clear_red_zone();
+              ctx.stack().mut_top().set_void();
+              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none, target);
+            }
 
-                    case xop_muls:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Saturating multiplication not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+            // Uparam
+            , up2
 
-                    default:
-                      ROCKET_UNREACHABLE();
-                  }
-                }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                // Uparam
-                , up2
+            // Collector
+            , nullptr
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                // Collector
-                , nullptr
+      case index_declare_reference:
+        {
+          const auto& altr = this->m_stor.as<S_declare_reference>();
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+          struct Sparam
+            {
+              phsh_string name;
+            };
 
-            case xop_sll:
-            case xop_srl:
-            case xop_sla:
-            case xop_sra:
-              // shift
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-                {
-                  const bool assign = head->uparam.b0;
-                  const uint8_t uxop = head->uparam.u1;
-                  const auto& rhs = ctx.stack().top().dereference_readonly();
-                  ctx.stack().pop();
-                  auto& top = ctx.stack().mut_top();
-                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+          Sparam sp2;
+          sp2.name = altr.name;
 
-                  if(rhs.type() != type_integer)
-                    throw Runtime_Error(xtc_format,
-                             "Invalid shift count (operands were `$1` and `$2`)",
-                             lhs, rhs);
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                  return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
-                }
+              // Declare a void reference.
+              ctx.insert_named_reference(sp.name).clear();
+              return air_status_next;
+            }
 
-                // Uparam
-                , up2
+            // Uparam
+            , Uparam()
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                // Collector
-                , nullptr
+            // Collector
+            , nullptr
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
 
-            case xop_fma:
-              // fused multiply-add; ternary
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-                {
-                  const bool assign = head->uparam.b0;
-                  const auto& rhs = ctx.stack().top().dereference_readonly();
-                  ctx.stack().pop();
-                  const auto& mid = ctx.stack().top().dereference_readonly();
-                  ctx.stack().pop();
-                  auto& top = ctx.stack().mut_top();
-                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+      case index_initialize_reference:
+        {
+          const auto& altr = this->m_stor.as<S_initialize_reference>();
 
-                  // Perform floating-point fused multiply-add.
-                  if(lhs.is_real() && mid.is_real() && rhs.is_real()) {
-                    V_real& val = lhs.mut_real();
-                    V_real y_mul = mid.as_real();
-                    V_real z_add = rhs.as_real();
+          struct Sparam
+            {
+              phsh_string name;
+            };
 
-                    val = ::std::fma(val, y_mul, z_add);
-                    return air_status_next;
-                  }
+          Sparam sp2;
+          sp2.name = altr.name;
 
-                  throw Runtime_Error(xtc_format,
-                           "`__fma` not applicable (operands were `$1`, `$2` and `$3`)",
-                           lhs, mid, rhs);
-                }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                // Uparam
-                , up2
+              // Move a reference from the stack into the current context.
+              ctx.insert_named_reference(sp.name) = move(ctx.stack().mut_top());
+              ctx.stack().pop();
+              return air_status_next;
+            }
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+            // Uparam
+            , Uparam()
 
-                // Collector
-                , nullptr
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+            // Collector
+            , nullptr
 
-            default:
-              ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), altr.xop);
-          }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
         }
 
-      case index_unpack_array:
+      case index_catch_expression:
         {
-          const auto& altr = this->m_stor.as<S_unpack_array>();
+          const auto& altr = this->m_stor.as<S_catch_expression>();
 
-          Uparam up2;
-          up2.b0 = altr.immutable;
-          up2.u2345 = altr.nelems;
+          struct Sparam
+            {
+              AVM_Rod rod_body;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_body, altr.code_body);
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const bool immutable = head->uparam.b0;
-              const uint32_t nelems = head->uparam.u2345;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Read the value of the initializer.
-              const auto& init = ctx.stack().top().dereference_readonly();
-              ctx.stack().pop();
+              // Save the stack.
+              Reference_Stack saved_stack = move(ctx.stack());
+              ctx.swap_stacks();
 
-              // Make sure it is really an array.
-              if(!init.is_null() && !init.is_array())
-                throw Runtime_Error(xtc_format,
-                         "Initializer was not an array (value was `$1`)", init);
+              // Evaluate the expression in a `try` block.
+              Value exval;
+              try {
+                AIR_Status status = sp.rod_body.execute(ctx);
+                ROCKET_ASSERT(status == air_status_next);
+              }
+              catch(Runtime_Error& except) {
+                exval = except.value();
+              }
 
-              for(uint32_t i = nelems - 1;  i != UINT32_MAX;  --i) {
-                // Pop variables from from right to left.
-                auto var = ctx.stack().top().unphase_variable_opt();
-                ctx.stack().pop();
-                ROCKET_ASSERT(var && !var->is_initialized());
+              // Restore the stack after the evaluation completes.
+              ctx.swap_stacks();
+              ctx.stack() = move(saved_stack);
 
-                if(ROCKET_EXPECT(init.is_array()))
-                  if(auto ielem = init.as_array().ptr(i))
-                    var->initialize(*ielem);
+              // Push the exception object.
+              ctx.stack().push().set_temporary(move(exval));
+              return air_status_next;
+            }
 
-                if(ROCKET_UNEXPECT(!var->is_initialized()))
-                  var->initialize(nullopt);
+            // Uparam
+            , Uparam()
 
-                var->set_immutable(immutable);
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_body.collect_variables(staged, temp);
+            }
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_return_statement:
+        {
+          const auto& altr = this->m_stor.as<S_return_statement>();
+
+          Uparam up2;
+          up2.b0 = altr.by_ref;
+          up2.b1 = altr.is_void;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const bool by_ref = head->uparam.b0;
+              const bool is_void = head->uparam.b1;
+              const auto& sloc = head->pv_meta->sloc;
+
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_return(sloc, ptc_aware_none);
+
+              if(is_void || ctx.stack().top().is_void()) {
+                // Discard the result.
+                return air_status_return_void;
+              }
+              else if(by_ref) {
+                // The result is passed by reference, so check whether it is
+                // dereferenceable.
+                ctx.stack().top().dereference_readonly();
+                return air_status_return_ref;
+              }
+              else {
+                // The result is passed by copy, so convert it to a temporary.
+                ctx.stack().mut_top().dereference_copy();
+                return air_status_return_ref;
               }
-              return air_status_next;
             }
 
             // Uparam
@@ -3863,59 +5110,109 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_unpack_object:
+      case index_push_constant:
         {
-          const auto& altr = this->m_stor.as<S_unpack_object>();
-
-          Uparam up2;
-          up2.b0 = altr.immutable;
+          const auto& altr = this->m_stor.as<S_push_constant>();
 
           struct Sparam
             {
-              cow_vector<phsh_string> keys;
+              Value val;
             };
 
           Sparam sp2;
-          sp2.keys = altr.keys;
+          sp2.val = altr.val;
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const bool immutable = head->uparam.b0;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              ctx.stack().push().set_temporary(sp.val);
+              return air_status_next;
+            }
 
-              // Read the value of the initializer.
-              const auto& init = ctx.stack().top().dereference_readonly();
-              ctx.stack().pop();
+            // Uparam
+            , Uparam()
 
-              // Make sure it is really an object.
-              if(!init.is_null() && !init.is_object())
-                throw Runtime_Error(xtc_format,
-                         "Initializer was not an object (value was `$1`)", init);
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-              for(auto it = sp.keys.rbegin();  it != sp.keys.rend();  ++it) {
-                // Pop variables from from right to left.
-                auto var = ctx.stack().top().unphase_variable_opt();
-                ctx.stack().pop();
-                ROCKET_ASSERT(var && !var->is_initialized());
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.val.collect_variables(staged, temp);
+            }
 
-                if(ROCKET_EXPECT(init.is_object()))
-                  if(auto ielem = init.as_object().ptr(*it))
-                    var->initialize(*ielem);
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
 
-                if(ROCKET_UNEXPECT(!var->is_initialized()))
-                  var->initialize(nullopt);
+      case index_alt_clear_stack:
+        {
+          const auto& altr = this->m_stor.as<S_alt_clear_stack>();
 
-                var->set_immutable(immutable);
-              }
+          (void) altr;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* /*head*/) -> AIR_Status
+            {
+              ctx.swap_stacks();
+              ctx.stack().clear();
               return air_status_next;
             }
 
+            // Uparam
+            , Uparam()
+
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_alt_function_call:
+        {
+          const auto& altr = this->m_stor.as<S_alt_function_call>();
+
+          Uparam up2;
+          up2.u0 = altr.ptc;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const PTC_Aware ptc = static_cast<PTC_Aware>(head->uparam.u0);
+              const auto& sloc = head->pv_meta->sloc;
+              const auto sentry = ctx.global().copy_recursion_sentry();
+
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_trap(sloc, ctx);
+
+              ctx.swap_stacks();
+
+              // Copy the target reference into the red zone, as we probably don't
+              // want to introduce a temporary object on the system stack.
+              ctx.stack().clear_red_zone();
+              ctx.stack().push();
+              ctx.stack().mut_top() = ctx.stack().top(1);
+              const auto& target = ctx.stack().top().dereference_readonly();
+              ctx.stack().pop();
+              ctx.stack().mut_top().pop_modifier();
+              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc, target);
+            }
+
             // Uparam
             , up2
 
             // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+            , 0, nullptr, nullptr, nullptr
 
             // Collector
             , nullptr
@@ -3926,40 +5223,31 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_define_null_variable:
+      case index_coalesce_expression:
         {
-          const auto& altr = this->m_stor.as<S_define_null_variable>();
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
 
           Uparam up2;
-          up2.b0 = altr.immutable;
+          up2.b0 = altr.assign;
 
           struct Sparam
             {
-              phsh_string name;
+              AVM_Rod rod_null;
             };
 
           Sparam sp2;
-          sp2.name = altr.name;
-
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool immutable = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              const auto& sloc = head->pv_meta->sloc;
-
-              // Allocate a variable and inject it into the current context.
-              const auto gcoll = ctx.global().garbage_collector();
-              const auto var = gcoll->create_variable();
-              ctx.insert_named_reference(sp.name).set_variable(var);
+          do_solidify_nodes(sp2.rod_null, altr.code_null);
 
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_declare(sloc, sp.name);
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool assign = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Initialize it to null.
-              var->initialize(nullopt);
-              var->set_immutable(immutable);
-              return air_status_next;
+              // Read the condition and evaluate the corresponding subexpression.
+              return ctx.stack().top().dereference_readonly().is_null()
+                       ? do_evaluate_subexpression(ctx, assign, sp.rod_null)
+                       : air_status_next;
             }
 
             // Uparam
@@ -3969,7 +5257,11 @@ solidify(AVM_Rod& rod) const
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , nullptr
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_null.collect_variables(staged, temp);
+            }
 
             // Symbols
             , &(altr.sloc)
@@ -3977,20 +5269,31 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_single_step_trap:
+      case index_member_access:
         {
-          const auto& altr = this->m_stor.as<S_single_step_trap>();
+          const auto& altr = this->m_stor.as<S_member_access>();
 
-          (void) altr;
+          struct Sparam
+            {
+              phsh_string key;
+              mutable uint32_t hint;
+            };
+
+          Sparam sp2;
+          sp2.key = altr.key;
+          sp2.hint = 0;
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const auto& sloc = head->pv_meta->sloc;
-
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_trap(sloc, ctx);
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              auto& top = ctx.stack().mut_top();
 
+              // Push a modifier. Objects that are accessed by the same node tend
+              // to have the same layout, so remember where the key was found.
+              Reference_Modifier::S_object_key xmod = { sp.key, sp.hint };
+              do_push_modifier_and_check(top, move(xmod));
+              sp.hint = top.last_modifier().object_key_hint();
               return air_status_next;
             }
 
@@ -3998,7 +5301,7 @@ solidify(AVM_Rod& rod) const
             , Uparam()
 
             // Sparam
-            , 0, nullptr, nullptr, nullptr
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
             , nullptr
@@ -4009,95 +5312,186 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_variadic_call:
+      case index_apply_operator_bi32:
         {
-          const auto& altr = this->m_stor.as<S_variadic_call>();
+          const auto& altr = this->m_stor.as<S_apply_operator_bi32>();
 
           Uparam up2;
-          up2.u0 = altr.ptc;
+          up2.b0 = altr.assign;
+          up2.u1 = altr.xop;
+          up2.i2345 = altr.irhs;
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+          switch(altr.xop)
             {
-              const PTC_Aware ptc = static_cast<PTC_Aware>(head->uparam.u0);
-              const auto& sloc = head->pv_meta->sloc;
-              const auto sentry = ctx.global().copy_recursion_sentry();
-
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_trap(sloc, ctx);
+            case xop_inc:
+            case xop_dec:
+            case xop_unset:
+            case xop_head:
+            case xop_tail:
+            case xop_random:
+            case xop_isvoid:
+            case xop_pos:
+            case xop_neg:
+            case xop_notb:
+            case xop_notl:
+            case xop_countof:
+            case xop_typeof:
+            case xop_sqrt:
+            case xop_isnan:
+            case xop_isinf:
+            case xop_abs:
+            case xop_sign:
+            case xop_round:
+            case xop_floor:
+            case xop_ceil:
+            case xop_trunc:
+            case xop_iround:
+            case xop_ifloor:
+            case xop_iceil:
+            case xop_itrunc:
+            case xop_lzcnt:
+            case xop_tzcnt:
+            case xop_popcnt:
+            case xop_fma:
+              ASTERIA_TERMINATE(("Constant folding not implemented for `$1`"), altr.xop);
 
-              auto temp_value = ctx.stack().top().dereference_readonly();
-              if(temp_value.is_null()) {
-                // There is no argument for the target function.
-                ctx.alt_stack().clear();
-                ctx.stack().pop();
-              }
-              else if(temp_value.is_array()) {
-                // Push all values from left to right, as temporary values.
-                ctx.alt_stack().clear();
-                for(const auto& val : temp_value.as_array())
-                  ctx.alt_stack().push().set_temporary(val);
-                ctx.stack().pop();
-              }
-              else if(temp_value.is_function()) {
-                // Invoke the generator function with no argument to get the number
-                // of variadic arguments. This destroys its self reference, so we have
-                // to stash it first.
-                auto va_gen = move(temp_value.mut_function());
-                ctx.stack().mut_top().pop_modifier();
-                ctx.stack().push();
-                ctx.stack().mut_top() = ctx.stack().mut_top(1);
-                ctx.alt_stack().clear();
-                do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none, va_gen);
-                temp_value = ctx.stack().top().dereference_readonly();
-                ctx.stack().pop();
+            case xop_assign:
+            case xop_index:
+              // binary
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+                {
+                  const uint8_t uxop = head->uparam.u1;
+                  const V_integer irhs = head->uparam.i2345;
+                  auto& top = ctx.stack().mut_top();
 
-                if(temp_value.type() != type_integer)
-                  throw Runtime_Error(xtc_format,
-                           "Invalid number of variadic arguments (value `$1`)", temp_value);
+                  switch(uxop)
+                      {
+                    case xop_assign:
+                      {
+                        // `assign` is ignored.
+                        top.dereference_mutable() = irhs;
+                        return air_status_next;
+                      }
 
-                if((temp_value.as_integer() < 0) || (temp_value.as_integer() > INT_MAX))
-                  throw Runtime_Error(xtc_format,
-                           "Invalid number of variadic arguments (value `$1`)", temp_value);
+                    case xop_index:
+                      {
+                        // Push a subscript.
+                        Reference_Modifier::S_array_index xmod = { irhs };
+                        do_push_modifier_and_check(top, move(xmod));
+                        return air_status_next;
+                      }
 
-                const uint32_t nargs = static_cast<uint32_t>(temp_value.as_integer());
-                if(nargs == 0) {
-                  // There is no argument for the target function.
-                  ctx.alt_stack().clear();
-                  ctx.stack().pop();
-                }
-                else {
-                  // Initialize `this` references for variadic arguments.
-                  for(uint32_t k = 0;  k != nargs - 1;  ++k) {
-                    ctx.stack().push();
-                    ctx.stack().mut_top() = ctx.stack().top(1);
+                    default:
+                      ROCKET_UNREACHABLE();
                   }
+                }
 
-                  // Generate varaidic arguments, and store them on `stack` from
-                  // right to left for later use.
-                  for(uint32_t k = 0;  k != nargs;  ++k) {
-                    ctx.alt_stack().clear();
-                    ctx.alt_stack().push().set_temporary(V_integer(k));
-                    do_invoke_partial(ctx.stack().mut_top(k), ctx, sloc, ptc_aware_none, va_gen);
-                    ctx.stack().top(k).dereference_readonly();
-                  }
+                // Uparam
+                , up2
 
-                  // Move arguments into `alt_stack` from left to right.
-                  ctx.alt_stack().clear();
-                  for(uint32_t k = 0;  k != nargs;  ++k)
-                    ctx.alt_stack().push() = move(ctx.stack().mut_top(k));
-                  ctx.stack().pop(nargs);
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            case xop_cmp_eq:
+            case xop_cmp_ne:
+            case xop_cmp_un:
+            case xop_cmp_lt:
+            case xop_cmp_gt:
+            case xop_cmp_lte:
+            case xop_cmp_gte:
+            case xop_cmp_3way:
+            case xop_add:
+            case xop_sub:
+            case xop_mul:
+            case xop_div:
+            case xop_mod:
+            case xop_andb:
+            case xop_orb:
+            case xop_xorb:
+            case xop_addm:
+            case xop_subm:
+            case xop_mulm:
+            case xop_adds:
+            case xop_subs:
+            case xop_muls:
+            case xop_sll:
+            case xop_srl:
+            case xop_sla:
+            case xop_sra:
+              // binary, shift
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint8_t uxop = head->uparam.u1;
+                  const V_integer irhs = head->uparam.i2345;
+                  auto& top = ctx.stack().mut_top();
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  return do_apply_binary_operator_with_integer(uxop, lhs, irhs);
                 }
-              }
-              else
-                throw Runtime_Error(xtc_format,
-                         "Invalid variadic argument generator (value `$1`)", temp_value);
 
-              // Invoke the target function with arguments from `alt_stack`.
-              ctx.stack().clear_red_zone();
-              temp_value = ctx.stack().top().dereference_readonly();
-              ctx.stack().mut_top().pop_modifier();
-              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc, temp_value);
+                // Uparam
+                , up2
+
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            default:
+              ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+          }
+        }
+
+      case index_return_statement_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_return_statement_bi32>();
+
+          Uparam up2;
+          up2.u0 = altr.type;
+          up2.i2345 = altr.irhs;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const Type type = static_cast<Type>(head->uparam.u0);
+              const V_integer irhs = head->uparam.i2345;
+              const auto& sloc = head->pv_meta->sloc;
+
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_return(sloc, ptc_aware_none);
+
+              if(type == type_null) {
+                // null
+                ctx.stack().push().set_temporary(nullopt);
+                return air_status_return_ref;
+              }
+              else if(type == type_boolean) {
+                // boolean; unnormalized
+                ctx.stack().push().set_temporary(-irhs < 0);
+                return air_status_return_ref;
+              }
+              else {
+                // integer
+                ctx.stack().push().set_temporary(irhs);
+                return air_status_return_ref;
+              }
             }
 
             // Uparam
@@ -4115,48 +5509,48 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_defer_expression:
+      case index_local_operator_bi32:
         {
-          const auto& altr = this->m_stor.as<S_defer_expression>();
+          const auto& altr = this->m_stor.as<S_local_operator_bi32>();
+
+          Uparam up2;
+          up2.b0 = altr.assign;
+          up2.u1 = altr.xop;
+          up2.i2345 = altr.irhs;
 
           struct Sparam
             {
-              cow_vector<AIR_Node> code_body;
+              phsh_string name;
+              uint32_t depth;
+              uint32_t slot;
             };
 
           Sparam sp2;
-          sp2.code_body = altr.code_body;
+          sp2.name = altr.name;
+          sp2.depth = altr.depth;
+          sp2.slot = altr.slot;
 
           rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
             {
+              const bool assign = head->uparam.b0;
+              const uint8_t uxop = head->uparam.u1;
+              const V_integer irhs = head->uparam.i2345;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              const auto& sloc = head->pv_meta->sloc;
-
-              // Capture local references at this time.
-              bool dirty = false;
-              auto bound_body = sp.code_body;
-              do_rebind_nodes(dirty, bound_body, ctx);
+              auto& top = do_push_local_reference(ctx, sp.depth, sp.slot, sp.name);
+              auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
 
-              // Instantiate the expression and push it to the current context.
-              AVM_Rod rod_body;
-              do_solidify_nodes(rod_body, bound_body);
-              ctx.mut_defer().emplace_back(sloc, move(rod_body));
-              return air_status_next;
+              return do_apply_binary_operator_with_integer(uxop, lhs, irhs);
             }
 
             // Uparam
-            , Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              do_collect_variables_for_each(staged, temp, sp.code_body);
-            }
+            , nullptr
 
             // Symbols
             , &(altr.sloc)
@@ -4164,80 +5558,39 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_import_call:
+      case index_local_member_access:
         {
-          const auto& altr = this->m_stor.as<S_import_call>();
+          const auto& altr = this->m_stor.as<S_local_member_access>();
 
           Uparam up2;
-          up2.u2345 = altr.nargs;
+          up2.u2345 = altr.depth;
 
           struct Sparam
             {
-              Compiler_Options opts;
+              phsh_string name;
+              phsh_string key;
+              uint32_t slot;
+              mutable uint32_t hint;
             };
 
           Sparam sp2;
-          sp2.opts = altr.opts;
+          sp2.name = altr.name;
+          sp2.key = altr.key;
+          sp2.slot = altr.slot;
+          sp2.hint = 0;
 
           rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
             {
-              const uint32_t nargs = head->uparam.u2345;
+              const uint32_t depth = head->uparam.u2345;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              const auto& sloc = head->pv_meta->sloc;
-              const auto sentry = ctx.global().copy_recursion_sentry();
-
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_trap(sloc, ctx);
-
-              // Collect arguments from left to right.
-              ctx.alt_stack().clear();
-              for(uint32_t k = 0;  k != nargs - 1;  ++k)
-                ctx.alt_stack().push() = move(ctx.stack().mut_top(nargs - 2 - k));
-              ctx.stack().pop(nargs - 1);
-
-              // Get the path to import.
-              const auto& path_val = ctx.stack().top().dereference_readonly();
-              if(path_val.type() != type_string)
-                throw Runtime_Error(xtc_format,
-                         "Path was not a string (value `$1`)", path_val);
-
-              if(path_val.as_string() == "")
-                throw Runtime_Error(xtc_format, "Path was empty");
-
-              cow_string abs_path = path_val.as_string();
-              if(abs_path[0] != '/') {
-                const auto& src_file = sloc.file();
-                if(src_file[0] == '/') {
-                  size_t pos = src_file.rfind('/');
-                  ROCKET_ASSERT(pos != cow_string::npos);
-                  abs_path.insert(0, src_file.c_str(), pos + 1);
-                }
-              }
-
-              abs_path = get_real_path(abs_path);
-              Source_Location script_sloc(abs_path, 0, 0);
+              auto& top = do_push_local_reference(ctx, depth, sp.slot, sp.name);
 
-              Module_Loader::Unique_Stream istrm;
-              istrm.reset(ctx.global().module_loader(), abs_path);
-
-              Token_Stream tstrm(sp.opts);
-              tstrm.reload(abs_path, 1, move(istrm.get()));
-
-              Statement_Sequence stmtq(sp.opts);
-              stmtq.reload(move(tstrm));
-
-              // Instantiate the script as a variadic function.
-              cow_vector<phsh_string> script_params;
-              script_params.emplace_back(&"...");
-
-              AIR_Optimizer optmz(sp.opts);
-              optmz.reload(nullptr, script_params, ctx.global(), stmtq.get_statements());
-
-              ctx.stack().clear_red_zone();
-              ctx.stack().mut_top().set_void();
-              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none,
-                                       optmz.create_function(script_sloc, &"[file scope]"));
+              // Push a modifier, with a cached bucket index.
+              Reference_Modifier::S_object_key xmod = { sp.key, sp.hint };
+              do_push_modifier_and_check(top, move(xmod));
+              sp.hint = top.last_modifier().object_key_hint();
+              return air_status_next;
             }
 
             // Uparam
@@ -4255,583 +5608,909 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_declare_reference:
+      case index_local_operator:
         {
-          const auto& altr = this->m_stor.as<S_declare_reference>();
+          const auto& altr = this->m_stor.as<S_local_operator>();
+
+          Uparam up2;
+          up2.b0 = altr.assign;
+          up2.u1 = altr.xop;
 
           struct Sparam
             {
               phsh_string name;
+              uint32_t depth;
+              uint32_t slot;
             };
 
           Sparam sp2;
           sp2.name = altr.name;
+          sp2.depth = altr.depth;
+          sp2.slot = altr.slot;
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+          switch(altr.xop)
             {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+            case xop_inc:
+            case xop_dec:
+              // unary
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint8_t uxop = head->uparam.u1;
+                  const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                  auto& top = do_push_local_reference(ctx, sp.depth, sp.slot, sp.name);
 
-              // Declare a void reference.
-              ctx.insert_named_reference(sp.name).clear();
-              return air_status_next;
-            }
+                  if(uxop == xop_inc)
+                    return do_apply_increment(top, assign);
+                  else
+                    return do_apply_decrement(top, assign);
+                }
 
-            // Uparam
-            , Uparam()
+                // Uparam
+                , up2
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+                // Sparam
+                , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-            // Collector
-            , nullptr
+                // Collector
+                , nullptr
 
-            // Symbols
-            , nullptr
-          );
-          return;
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            case xop_unset:
+            case xop_head:
+            case xop_tail:
+            case xop_random:
+            case xop_isvoid:
+            case xop_pos:
+            case xop_neg:
+            case xop_notb:
+            case xop_notl:
+            case xop_countof:
+            case xop_typeof:
+            case xop_sqrt:
+            case xop_isnan:
+            case xop_isinf:
+            case xop_abs:
+            case xop_sign:
+            case xop_round:
+            case xop_floor:
+            case xop_ceil:
+            case xop_trunc:
+            case xop_iround:
+            case xop_ifloor:
+            case xop_iceil:
+            case xop_itrunc:
+            case xop_lzcnt:
+            case xop_tzcnt:
+            case xop_popcnt:
+            case xop_assign:
+            case xop_index:
+            case xop_cmp_eq:
+            case xop_cmp_ne:
+            case xop_cmp_un:
+            case xop_cmp_lt:
+            case xop_cmp_gt:
+            case xop_cmp_lte:
+            case xop_cmp_gte:
+            case xop_cmp_3way:
+            case xop_add:
+            case xop_sub:
+            case xop_mul:
+            case xop_div:
+            case xop_mod:
+            case xop_andb:
+            case xop_orb:
+            case xop_xorb:
+            case xop_addm:
+            case xop_subm:
+            case xop_mulm:
+            case xop_adds:
+            case xop_subs:
+            case xop_muls:
+            case xop_sll:
+            case xop_srl:
+            case xop_sla:
+            case xop_sra:
+            case xop_fma:
+              ASTERIA_TERMINATE(("Operator fusion not implemented for `$1`"), altr.xop);
+
+            default:
+              ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+          }
         }
 
-      case index_initialize_reference:
+      case index_local_operator_local:
         {
-          const auto& altr = this->m_stor.as<S_initialize_reference>();
+          const auto& altr = this->m_stor.as<S_local_operator_local>();
+
+          Uparam up2;
+          up2.b0 = altr.assign;
+          up2.u1 = altr.xop;
 
           struct Sparam
             {
               phsh_string name;
+              phsh_string rname;
+              uint32_t depth;
+              uint32_t slot;
+              uint32_t rdepth;
+              uint32_t rslot;
             };
 
           Sparam sp2;
           sp2.name = altr.name;
+          sp2.rname = altr.rname;
+          sp2.depth = altr.depth;
+          sp2.slot = altr.slot;
+          sp2.rdepth = altr.rdepth;
+          sp2.rslot = altr.rslot;
+
+          if(!do_is_fusable_binary_operator(altr.xop))
+            ASTERIA_TERMINATE(("Operator fusion not implemented for `$1`"), altr.xop);
 
           rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
             {
+              const bool assign = head->uparam.b0;
+              const uint8_t uxop = head->uparam.u1;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Move a reference from the stack into the current context.
-              ctx.insert_named_reference(sp.name) = move(ctx.stack().mut_top());
-              ctx.stack().pop();
-              return air_status_next;
+              // Only the LHS operand is pushed onto the stack. The RHS operand
+              // is read from its variable directly.
+              auto& top = do_push_local_reference(ctx, sp.depth, sp.slot, sp.name);
+              const auto& rref = do_get_local_reference(ctx, sp.rdepth, sp.rslot, sp.rname);
+              const auto& rhs = rref.dereference_readonly();
+              auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+              if(rhs.type() == type_integer)
+                return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
+
+              return do_apply_binary_operator_with_value(uxop, lhs, rhs);
             }
 
             // Uparam
-            , Uparam()
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+    }
+  }
+
+void
+AIR_Node::
+serialize(AIR_Serializer& ser) const
+  {
+    ser.put_enum(static_cast<Index>(this->m_stor.index()));
+
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+        return;
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-            // Collector
-            , nullptr
+      case index_declare_variable:
+        {
+          const auto& altr = this->m_stor.as<S_declare_variable>();
+          ser.put_sloc(altr.sloc);
+          ser.put_name(altr.name);
+          return;
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
+      case index_initialize_variable:
+        {
+          const auto& altr = this->m_stor.as<S_initialize_variable>();
+          ser.put_sloc(altr.sloc);
+          ser.put_bool(altr.immutable);
           return;
         }
 
-      case index_catch_expression:
+      case index_if_statement:
         {
-          const auto& altr = this->m_stor.as<S_catch_expression>();
+          const auto& altr = this->m_stor.as<S_if_statement>();
+          ser.put_bool(altr.negative);
+          ser.put_code(altr.code_true);
+          ser.put_code(altr.code_false);
+          return;
+        }
 
-          struct Sparam
-            {
-              AVM_Rod rod_body;
-            };
+      case index_switch_statement:
+        {
+          const auto& altr = this->m_stor.as<S_switch_statement>();
+          ser.put_u32(static_cast<uint32_t>(altr.clauses.size()));
+          for(const auto& clause : altr.clauses) {
+            ser.put_enum(clause.type);
+            ser.put_bool(clause.lower_closed);
+            ser.put_bool(clause.upper_closed);
+            ser.put_code(clause.code_labels);
+            ser.put_code(clause.code_body);
+            ser.put_names(clause.names_added);
+          }
+          return;
+        }
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_body, altr.code_body);
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
+          ser.put_code(altr.code_body);
+          ser.put_bool(altr.negative);
+          ser.put_code(altr.code_cond);
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case index_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_while_statement>();
+          ser.put_bool(altr.negative);
+          ser.put_code(altr.code_cond);
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-              // Save the stack.
-              Reference_Stack saved_stack = move(ctx.stack());
-              ctx.swap_stacks();
+      case index_for_each_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
+          ser.put_name(altr.name_key);
+          ser.put_name(altr.name_mapped);
+          ser.put_sloc(altr.sloc_init);
+          ser.put_code(altr.code_init);
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-              // Evaluate the expression in a `try` block.
-              Value exval;
-              try {
-                AIR_Status status = sp.rod_body.execute(ctx);
-                ROCKET_ASSERT(status == air_status_next);
-              }
-              catch(Runtime_Error& except) {
-                exval = except.value();
-              }
+      case index_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_statement>();
+          ser.put_code(altr.code_init);
+          ser.put_code(altr.code_cond);
+          ser.put_code(altr.code_step);
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-              // Restore the stack after the evaluation completes.
-              ctx.swap_stacks();
-              ctx.stack() = move(saved_stack);
+      case index_try_statement:
+        {
+          const auto& altr = this->m_stor.as<S_try_statement>();
+          ser.put_sloc(altr.sloc_try);
+          ser.put_code(altr.code_try);
+          ser.put_sloc(altr.sloc_catch);
+          ser.put_name(altr.name_except);
+          ser.put_code(altr.code_catch);
+          return;
+        }
 
-              // Push the exception object.
-              ctx.stack().push().set_temporary(move(exval));
-              return air_status_next;
-            }
+      case index_throw_statement:
+        {
+          const auto& altr = this->m_stor.as<S_throw_statement>();
+          ser.put_sloc(altr.sloc);
+          return;
+        }
 
-            // Uparam
-            , Uparam()
+      case index_assert_statement:
+        {
+          const auto& altr = this->m_stor.as<S_assert_statement>();
+          ser.put_sloc(altr.sloc);
+          ser.put_string(altr.msg);
+          return;
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_simple_status:
+        {
+          const auto& altr = this->m_stor.as<S_simple_status>();
+          ser.put_enum(altr.status);
+          return;
+        }
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_body.collect_variables(staged, temp);
-            }
+      case index_check_argument:
+        {
+          const auto& altr = this->m_stor.as<S_check_argument>();
+          ser.put_sloc(altr.sloc);
+          ser.put_bool(altr.by_ref);
+          return;
+        }
 
-            // Symbols
-            , nullptr
-          );
+      case index_push_global_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_global_reference>();
+          ser.put_sloc(altr.sloc);
+          ser.put_name(altr.name);
           return;
         }
 
-      case index_return_statement:
+      case index_push_local_reference:
         {
-          const auto& altr = this->m_stor.as<S_return_statement>();
+          const auto& altr = this->m_stor.as<S_push_local_reference>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.depth);
+          ser.put_u32(altr.slot);
+          ser.put_name(altr.name);
+          return;
+        }
 
-          Uparam up2;
-          up2.b0 = altr.by_ref;
-          up2.b1 = altr.is_void;
+      case index_push_bound_reference:
+        ASTERIA_THROW(("Bound reference cannot be serialized"));
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-            {
-              const bool by_ref = head->uparam.b0;
-              const bool is_void = head->uparam.b1;
-              const auto& sloc = head->pv_meta->sloc;
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
+          ser.put_options(altr.opts);
+          ser.put_sloc(altr.sloc);
+          ser.put_string(altr.func);
+          ser.put_names(altr.params);
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_return(sloc, ptc_aware_none);
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
+          ser.put_sloc(altr.sloc);
+          ser.put_code(altr.code_true);
+          ser.put_code(altr.code_false);
+          ser.put_bool(altr.assign);
+          return;
+        }
 
-              if(is_void || ctx.stack().top().is_void()) {
-                // Discard the result.
-                return air_status_return_void;
-              }
-              else if(by_ref) {
-                // The result is passed by reference, so check whether it is
-                // dereferenceable.
-                ctx.stack().top().dereference_readonly();
-                return air_status_return_ref;
-              }
-              else {
-                // The result is passed by copy, so convert it to a temporary.
-                ctx.stack().mut_top().dereference_copy();
-                return air_status_return_ref;
-              }
-            }
+      case index_function_call:
+        {
+          const auto& altr = this->m_stor.as<S_function_call>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.nargs);
+          ser.put_enum(altr.ptc);
+          return;
+        }
 
-            // Uparam
-            , up2
+      case index_push_unnamed_array:
+        {
+          const auto& altr = this->m_stor.as<S_push_unnamed_array>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.nelems);
+          return;
+        }
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+      case index_push_unnamed_object:
+        {
+          const auto& altr = this->m_stor.as<S_push_unnamed_object>();
+          ser.put_sloc(altr.sloc);
+          ser.put_names(altr.keys);
+          return;
+        }
 
-            // Collector
-            , nullptr
+      case index_apply_operator:
+        {
+          const auto& altr = this->m_stor.as<S_apply_operator>();
+          ser.put_sloc(altr.sloc);
+          ser.put_enum(altr.xop);
+          ser.put_bool(altr.assign);
+          return;
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
+      case index_unpack_array:
+        {
+          const auto& altr = this->m_stor.as<S_unpack_array>();
+          ser.put_sloc(altr.sloc);
+          ser.put_bool(altr.immutable);
+          ser.put_u32(altr.nelems);
           return;
         }
 
-      case index_push_constant:
+      case index_unpack_object:
         {
-          const auto& altr = this->m_stor.as<S_push_constant>();
+          const auto& altr = this->m_stor.as<S_unpack_object>();
+          ser.put_sloc(altr.sloc);
+          ser.put_bool(altr.immutable);
+          ser.put_names(altr.keys);
+          return;
+        }
 
-          struct Sparam
-            {
-              Value val;
-            };
+      case index_define_null_variable:
+        {
+          const auto& altr = this->m_stor.as<S_define_null_variable>();
+          ser.put_sloc(altr.sloc);
+          ser.put_bool(altr.immutable);
+          ser.put_name(altr.name);
+          return;
+        }
 
-          Sparam sp2;
-          sp2.val = altr.val;
+      case index_single_step_trap:
+        {
+          const auto& altr = this->m_stor.as<S_single_step_trap>();
+          ser.put_sloc(altr.sloc);
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              ctx.stack().push().set_temporary(sp.val);
-              return air_status_next;
-            }
+      case index_variadic_call:
+        {
+          const auto& altr = this->m_stor.as<S_variadic_call>();
+          ser.put_sloc(altr.sloc);
+          ser.put_enum(altr.ptc);
+          return;
+        }
 
-            // Uparam
-            , Uparam()
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
+          ser.put_sloc(altr.sloc);
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_import_call:
+        {
+          const auto& altr = this->m_stor.as<S_import_call>();
+          ser.put_options(altr.opts);
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.nargs);
+          return;
+        }
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.val.collect_variables(staged, temp);
-            }
+      case index_declare_reference:
+        {
+          const auto& altr = this->m_stor.as<S_declare_reference>();
+          ser.put_name(altr.name);
+          return;
+        }
 
-            // Symbols
-            , nullptr
-          );
+      case index_initialize_reference:
+        {
+          const auto& altr = this->m_stor.as<S_initialize_reference>();
+          ser.put_sloc(altr.sloc);
+          ser.put_name(altr.name);
           return;
         }
 
-      case index_alt_clear_stack:
+      case index_catch_expression:
         {
-          const auto& altr = this->m_stor.as<S_alt_clear_stack>();
+          const auto& altr = this->m_stor.as<S_catch_expression>();
+          ser.put_code(altr.code_body);
+          return;
+        }
 
-          (void) altr;
+      case index_return_statement:
+        {
+          const auto& altr = this->m_stor.as<S_return_statement>();
+          ser.put_sloc(altr.sloc);
+          ser.put_bool(altr.by_ref);
+          ser.put_bool(altr.is_void);
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* /*head*/) -> AIR_Status
-            {
-              ctx.swap_stacks();
-              ctx.stack().clear();
-              return air_status_next;
-            }
+      case index_push_constant:
+        {
+          const auto& altr = this->m_stor.as<S_push_constant>();
+          ser.put_value(altr.val);
+          return;
+        }
 
-            // Uparam
-            , Uparam()
+      case index_alt_clear_stack:
+        return;
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+      case index_alt_function_call:
+        {
+          const auto& altr = this->m_stor.as<S_alt_function_call>();
+          ser.put_sloc(altr.sloc);
+          ser.put_enum(altr.ptc);
+          return;
+        }
 
-            // Collector
-            , nullptr
+      case index_coalesce_expression:
+        {
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+          ser.put_sloc(altr.sloc);
+          ser.put_code(altr.code_null);
+          ser.put_bool(altr.assign);
+          return;
+        }
 
-            // Symbols
-            , nullptr
-          );
+      case index_member_access:
+        {
+          const auto& altr = this->m_stor.as<S_member_access>();
+          ser.put_sloc(altr.sloc);
+          ser.put_name(altr.key);
           return;
         }
 
-      case index_alt_function_call:
+      case index_apply_operator_bi32:
         {
-          const auto& altr = this->m_stor.as<S_alt_function_call>();
+          const auto& altr = this->m_stor.as<S_apply_operator_bi32>();
+          ser.put_sloc(altr.sloc);
+          ser.put_enum(altr.xop);
+          ser.put_bool(altr.assign);
+          ser.put_i32(altr.irhs);
+          return;
+        }
 
-          Uparam up2;
-          up2.u0 = altr.ptc;
+      case index_return_statement_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_return_statement_bi32>();
+          ser.put_sloc(altr.sloc);
+          ser.put_enum(altr.type);
+          ser.put_i32(altr.irhs);
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-            {
-              const PTC_Aware ptc = static_cast<PTC_Aware>(head->uparam.u0);
-              const auto& sloc = head->pv_meta->sloc;
-              const auto sentry = ctx.global().copy_recursion_sentry();
+      case index_local_operator_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_local_operator_bi32>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.depth);
+          ser.put_u32(altr.slot);
+          ser.put_name(altr.name);
+          ser.put_enum(altr.xop);
+          ser.put_bool(altr.assign);
+          ser.put_i32(altr.irhs);
+          return;
+        }
 
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_trap(sloc, ctx);
+      case index_local_member_access:
+        {
+          const auto& altr = this->m_stor.as<S_local_member_access>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.depth);
+          ser.put_u32(altr.slot);
+          ser.put_name(altr.name);
+          ser.put_name(altr.key);
+          return;
+        }
 
-              ctx.swap_stacks();
+      case index_local_operator:
+        {
+          const auto& altr = this->m_stor.as<S_local_operator>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.depth);
+          ser.put_u32(altr.slot);
+          ser.put_name(altr.name);
+          ser.put_enum(altr.xop);
+          ser.put_bool(altr.assign);
+          return;
+        }
 
-              // Copy the target reference into the red zone, as we probably don't
-              // want to introduce a temporary object on the system stack.
-              ctx.stack().clear_red_zone();
-              ctx.stack().push();
-              ctx.stack().mut_top() = ctx.stack().top(1);
-              const auto& target = ctx.stack().top().dereference_readonly();
-              ctx.stack().pop();
-              ctx.stack().mut_top().pop_modifier();
-              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc, target);
-            }
+      case index_local_operator_local:
+        {
+          const auto& altr = this->m_stor.as<S_local_operator_local>();
+          ser.put_sloc(altr.sloc);
+          ser.put_u32(altr.depth);
+          ser.put_u32(altr.slot);
+          ser.put_name(altr.name);
+          ser.put_u32(altr.rdepth);
+          ser.put_u32(altr.rslot);
+          ser.put_name(altr.rname);
+          ser.put_enum(altr.xop);
+          ser.put_bool(altr.assign);
+          return;
+        }
 
-            // Uparam
-            , up2
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+AIR_Node
+AIR_Node::
+deserialize(AIR_Serializer& ser)
+  {
+    // Note the order of evaluation is well defined in braced lists.
+    switch(ser.get_enum(index_local_operator_local))
+      {
+      case index_clear_stack:
+        return S_clear_stack();
 
-            // Collector
-            , nullptr
+      case index_execute_block:
+        {
+          S_execute_block xnode = { ser.get_code() };
+          return move(xnode);
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
+      case index_declare_variable:
+        {
+          S_declare_variable xnode = { ser.get_sloc(), ser.get_name() };
+          return move(xnode);
         }
 
-      case index_coalesce_expression:
+      case index_initialize_variable:
         {
-          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+          S_initialize_variable xnode = { ser.get_sloc(), ser.get_bool() };
+          return move(xnode);
+        }
 
-          Uparam up2;
-          up2.b0 = altr.assign;
+      case index_if_statement:
+        {
+          S_if_statement xnode = { ser.get_bool(), ser.get_code(), ser.get_code() };
+          return move(xnode);
+        }
 
-          struct Sparam
-            {
-              AVM_Rod rod_null;
-            };
+      case index_switch_statement:
+        {
+          S_switch_statement xnode;
+          uint32_t count = ser.get_u32();
+          while(count != 0) {
+            switch_clause clause = { ser.get_enum(switch_clause_each), ser.get_bool(),
+                                     ser.get_bool(), ser.get_code(), ser.get_code(),
+                                     ser.get_names() };
+            xnode.clauses.emplace_back(move(clause));
+            count --;
+          }
+          return move(xnode);
+        }
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_null, altr.code_null);
+      case index_do_while_statement:
+        {
+          S_do_while_statement xnode = { ser.get_code(), ser.get_bool(), ser.get_code() };
+          return move(xnode);
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool assign = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case index_while_statement:
+        {
+          S_while_statement xnode = { ser.get_bool(), ser.get_code(), ser.get_code() };
+          return move(xnode);
+        }
 
-              // Read the condition and evaluate the corresponding subexpression.
-              return ctx.stack().top().dereference_readonly().is_null()
-                       ? do_evaluate_subexpression(ctx, assign, sp.rod_null)
-                       : air_status_next;
-            }
+      case index_for_each_statement:
+        {
+          S_for_each_statement xnode = { ser.get_name(), ser.get_name(), ser.get_sloc(),
+                                         ser.get_code(), ser.get_code() };
+          return move(xnode);
+        }
 
-            // Uparam
-            , up2
+      case index_for_statement:
+        {
+          S_for_statement xnode = { ser.get_code(), ser.get_code(), ser.get_code(),
+                                    ser.get_code() };
+          return move(xnode);
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_try_statement:
+        {
+          S_try_statement xnode = { ser.get_sloc(), ser.get_code(), ser.get_sloc(),
+                                    ser.get_name(), ser.get_code() };
+          return move(xnode);
+        }
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_null.collect_variables(staged, temp);
-            }
+      case index_throw_statement:
+        {
+          S_throw_statement xnode = { ser.get_sloc() };
+          return move(xnode);
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
+      case index_assert_statement:
+        {
+          S_assert_statement xnode = { ser.get_sloc(), ser.get_string() };
+          return move(xnode);
         }
 
-      case index_member_access:
+      case index_simple_status:
         {
-          const auto& altr = this->m_stor.as<S_member_access>();
+          S_simple_status xnode = { ser.get_enum(air_status_continue_for) };
+          return move(xnode);
+        }
 
-          struct Sparam
-            {
-              phsh_string key;
-            };
+      case index_check_argument:
+        {
+          S_check_argument xnode = { ser.get_sloc(), ser.get_bool() };
+          return move(xnode);
+        }
 
-          Sparam sp2;
-          sp2.key = altr.key;
+      case index_push_global_reference:
+        {
+          S_push_global_reference xnode = { ser.get_sloc(), ser.get_name() };
+          return move(xnode);
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case index_push_local_reference:
+        {
+          S_push_local_reference xnode = { ser.get_sloc(), ser.get_u32(), ser.get_u32(),
+                                           ser.get_name() };
+          return move(xnode);
+        }
 
-              // Push a modifier.
-              Reference_Modifier::S_object_key xmod = { sp.key };
-              do_push_modifier_and_check(ctx.stack().mut_top(), move(xmod));
-              return air_status_next;
-            }
+      case index_push_bound_reference:
+        ASTERIA_THROW(("Bound reference not allowed in compiled script"));
 
-            // Uparam
-            , Uparam()
+      case index_define_function:
+        {
+          S_define_function xnode = { ser.get_options(), ser.get_sloc(), ser.get_string(),
+                                      ser.get_names(), ser.get_code() };
+          return move(xnode);
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_branch_expression:
+        {
+          S_branch_expression xnode = { ser.get_sloc(), ser.get_code(), ser.get_code(),
+                                        ser.get_bool() };
+          return move(xnode);
+        }
 
-            // Collector
-            , nullptr
+      case index_function_call:
+        {
+          S_function_call xnode = { ser.get_sloc(), ser.get_u32(),
+                                    ser.get_enum(ptc_aware_void) };
+          return move(xnode);
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
+      case index_push_unnamed_array:
+        {
+          S_push_unnamed_array xnode = { ser.get_sloc(), ser.get_u32() };
+          return move(xnode);
+        }
+
+      case index_push_unnamed_object:
+        {
+          S_push_unnamed_object xnode = { ser.get_sloc(), ser.get_names() };
+          return move(xnode);
         }
 
-      case index_apply_operator_bi32:
+      case index_apply_operator:
         {
-          const auto& altr = this->m_stor.as<S_apply_operator_bi32>();
+          S_apply_operator xnode = { ser.get_sloc(), ser.get_enum(xop_isvoid), ser.get_bool() };
+          return move(xnode);
+        }
 
-          Uparam up2;
-          up2.b0 = altr.assign;
-          up2.u1 = altr.xop;
-          up2.i2345 = altr.irhs;
+      case index_unpack_array:
+        {
+          S_unpack_array xnode = { ser.get_sloc(), ser.get_bool(), ser.get_u32() };
+          return move(xnode);
+        }
 
-          switch(altr.xop)
-            {
-            case xop_inc:
-            case xop_dec:
-            case xop_unset:
-            case xop_head:
-            case xop_tail:
-            case xop_random:
-            case xop_isvoid:
-            case xop_pos:
-            case xop_neg:
-            case xop_notb:
-            case xop_notl:
-            case xop_countof:
-            case xop_typeof:
-            case xop_sqrt:
-            case xop_isnan:
-            case xop_isinf:
-            case xop_abs:
-            case xop_sign:
-            case xop_round:
-            case xop_floor:
-            case xop_ceil:
-            case xop_trunc:
-            case xop_iround:
-            case xop_ifloor:
-            case xop_iceil:
-            case xop_itrunc:
-            case xop_lzcnt:
-            case xop_tzcnt:
-            case xop_popcnt:
-            case xop_fma:
-              ASTERIA_TERMINATE(("Constant folding not implemented for `$1`"), altr.xop);
+      case index_unpack_object:
+        {
+          S_unpack_object xnode = { ser.get_sloc(), ser.get_bool(), ser.get_names() };
+          return move(xnode);
+        }
 
-            case xop_assign:
-            case xop_index:
-              // binary
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-                {
-                  const uint8_t uxop = head->uparam.u1;
-                  const V_integer irhs = head->uparam.i2345;
-                  auto& top = ctx.stack().mut_top();
+      case index_define_null_variable:
+        {
+          S_define_null_variable xnode = { ser.get_sloc(), ser.get_bool(), ser.get_name() };
+          return move(xnode);
+        }
 
-                  switch(uxop)
-                      {
-                    case xop_assign:
-                      {
-                        // `assign` is ignored.
-                        top.dereference_mutable() = irhs;
-                        return air_status_next;
-                      }
+      case index_single_step_trap:
+        {
+          S_single_step_trap xnode = { ser.get_sloc() };
+          return move(xnode);
+        }
 
-                    case xop_index:
-                      {
-                        // Push a subscript.
-                        Reference_Modifier::S_array_index xmod = { irhs };
-                        do_push_modifier_and_check(top, move(xmod));
-                        return air_status_next;
-                      }
+      case index_variadic_call:
+        {
+          S_variadic_call xnode = { ser.get_sloc(), ser.get_enum(ptc_aware_void) };
+          return move(xnode);
+        }
 
-                    default:
-                      ROCKET_UNREACHABLE();
-                  }
-                }
+      case index_defer_expression:
+        {
+          S_defer_expression xnode = { ser.get_sloc(), ser.get_code() };
+          return move(xnode);
+        }
 
-                // Uparam
-                , up2
+      case index_import_call:
+        {
+          S_import_call xnode = { ser.get_options(), ser.get_sloc(), ser.get_u32() };
+          return move(xnode);
+        }
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+      case index_declare_reference:
+        {
+          S_declare_reference xnode = { ser.get_name() };
+          return move(xnode);
+        }
 
-                // Collector
-                , nullptr
+      case index_initialize_reference:
+        {
+          S_initialize_reference xnode = { ser.get_sloc(), ser.get_name() };
+          return move(xnode);
+        }
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+      case index_catch_expression:
+        {
+          S_catch_expression xnode = { ser.get_code() };
+          return move(xnode);
+        }
 
-            case xop_cmp_eq:
-            case xop_cmp_ne:
-            case xop_cmp_un:
-            case xop_cmp_lt:
-            case xop_cmp_gt:
-            case xop_cmp_lte:
-            case xop_cmp_gte:
-            case xop_cmp_3way:
-            case xop_add:
-            case xop_sub:
-            case xop_mul:
-            case xop_div:
-            case xop_mod:
-            case xop_andb:
-            case xop_orb:
-            case xop_xorb:
-            case xop_addm:
-            case xop_subm:
-            case xop_mulm:
-            case xop_adds:
-            case xop_subs:
-            case xop_muls:
-            case xop_sll:
-            case xop_srl:
-            case xop_sla:
-            case xop_sra:
-              // binary, shift
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-                {
-                  const bool assign = head->uparam.b0;
-                  const uint8_t uxop = head->uparam.u1;
-                  const V_integer irhs = head->uparam.i2345;
-                  auto& top = ctx.stack().mut_top();
-                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+      case index_return_statement:
+        {
+          S_return_statement xnode = { ser.get_sloc(), ser.get_bool(), ser.get_bool() };
+          return move(xnode);
+        }
 
-                  return do_apply_binary_operator_with_integer(uxop, lhs, irhs);
-                }
+      case index_push_constant:
+        {
+          S_push_constant xnode = { ser.get_value() };
+          return move(xnode);
+        }
 
-                // Uparam
-                , up2
+      case index_alt_clear_stack:
+        return S_alt_clear_stack();
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+      case index_alt_function_call:
+        {
+          S_alt_function_call xnode = { ser.get_sloc(), ser.get_enum(ptc_aware_void) };
+          return move(xnode);
+        }
 
-                // Collector
-                , nullptr
+      case index_coalesce_expression:
+        {
+          S_coalesce_expression xnode = { ser.get_sloc(), ser.get_code(), ser.get_bool() };
+          return move(xnode);
+        }
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+      case index_member_access:
+        {
+          S_member_access xnode = { ser.get_sloc(), ser.get_name() };
+          return move(xnode);
+        }
 
-            default:
-              ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
-          }
+      case index_apply_operator_bi32:
+        {
+          S_apply_operator_bi32 xnode = { ser.get_sloc(), ser.get_enum(xop_isvoid),
+                                          ser.get_bool(), ser.get_i32() };
+          do_check_deserialized_operator(is_bi32_operator(xnode.xop), xnode.xop);
+          return move(xnode);
         }
 
       case index_return_statement_bi32:
         {
-          const auto& altr = this->m_stor.as<S_return_statement_bi32>();
-
-          Uparam up2;
-          up2.u0 = altr.type;
-          up2.i2345 = altr.irhs;
-
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-            {
-              const Type type = static_cast<Type>(head->uparam.u0);
-              const V_integer irhs = head->uparam.i2345;
-              const auto& sloc = head->pv_meta->sloc;
-
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_return(sloc, ptc_aware_none);
-
-              if(type == type_null) {
-                // null
-                ctx.stack().push().set_temporary(nullopt);
-                return air_status_return_ref;
-              }
-              else if(type == type_boolean) {
-                // boolean; unnormalized
-                ctx.stack().push().set_temporary(-irhs < 0);
-                return air_status_return_ref;
-              }
-              else {
-                // integer
-                ctx.stack().push().set_temporary(irhs);
-                return air_status_return_ref;
-              }
-            }
+          S_return_statement_bi32 xnode = { ser.get_sloc(), ser.get_enum(type_object),
+                                            ser.get_i32() };
+          return move(xnode);
+        }
 
-            // Uparam
-            , up2
+      case index_local_operator_bi32:
+        {
+          S_local_operator_bi32 xnode = { ser.get_sloc(), ser.get_u32(), ser.get_u32(),
+                                          ser.get_name(), ser.get_enum(xop_isvoid),
+                                          ser.get_bool(), ser.get_i32() };
+          do_check_deserialized_operator(is_bi32_operator(xnode.xop) && (xnode.xop != xop_assign)
+                                         && (xnode.xop != xop_index), xnode.xop);
+          return move(xnode);
+        }
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+      case index_local_member_access:
+        {
+          S_local_member_access xnode = { ser.get_sloc(), ser.get_u32(), ser.get_u32(),
+                                          ser.get_name(), ser.get_name() };
+          return move(xnode);
+        }
 
-            // Collector
-            , nullptr
+      case index_local_operator:
+        {
+          S_local_operator xnode = { ser.get_sloc(), ser.get_u32(), ser.get_u32(),
+                                     ser.get_name(), ser.get_enum(xop_isvoid),
+                                     ser.get_bool() };
+          do_check_deserialized_operator((xnode.xop == xop_inc) || (xnode.xop == xop_dec),
+                                         xnode.xop);
+          return move(xnode);
+        }
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
+      case index_local_operator_local:
+        {
+          S_local_operator_local xnode = { ser.get_sloc(), ser.get_u32(), ser.get_u32(),
+                                           ser.get_name(), ser.get_u32(), ser.get_u32(),
+                                           ser.get_name(), ser.get_enum(xop_isvoid),
+                                           ser.get_bool() };
+          do_check_deserialized_operator(do_is_fusable_binary_operator(xnode.xop), xnode.xop);
+          return move(xnode);
         }
+
+      default:
+        ROCKET_UNREACHABLE();
     }
   }
 
@@ -128,6 +128,7 @@ class AIR_Node
       {
         Source_Location sloc;
         uint32_t depth;
+        uint32_t slot;
         phsh_string name;
       };
 
@@ -290,6 +291,49 @@ class AIR_Node
         int32_t irhs;
       };
 
+    struct S_local_operator_bi32
+      {
+        Source_Location sloc;
+        uint32_t depth;
+        uint32_t slot;
+        phsh_string name;
+        Xop xop;
+        bool assign;
+        int32_t irhs;
+      };
+
+    struct S_local_member_access
+      {
+        Source_Location sloc;
+        uint32_t depth;
+        uint32_t slot;
+        phsh_string name;
+        phsh_string key;
+      };
+
+    struct S_local_operator
+      {
+        Source_Location sloc;
+        uint32_t depth;
+        uint32_t slot;
+        phsh_string name;
+        Xop xop;
+        bool assign;
+      };
+
+    struct S_local_operator_local
+      {
+        Source_Location sloc;
+        uint32_t depth;
+        uint32_t slot;
+        phsh_string name;
+        uint32_t rdepth;
+        uint32_t rslot;
+        phsh_string rname;
+        Xop xop;
+        bool assign;
+      };
+
     enum Index : uint8_t
       {
         index_clear_stack            =  0,
@@ -334,6 +378,10 @@ class AIR_Node
         index_member_access          = 39,
         index_apply_operator_bi32    = 40,
         index_return_statement_bi32  = 41,
+        index_local_operator_bi32    = 42,
+        index_local_member_access    = 43,
+        index_local_operator         = 44,
+        index_local_operator_local   = 45,
       };
 
   private:
@@ -381,6 +429,10 @@ class AIR_Node
         , S_member_access          // 39,
         , S_apply_operator_bi32    // 40,
         , S_return_statement_bi32  // 41,
+        , S_local_operator_bi32    // 42,
+        , S_local_member_access    // 43,
+        , S_local_operator         // 44,
+        , S_local_operator_local   // 45,
       );
 
   public:
@@ -430,9 +482,33 @@ class AIR_Node
     void
     collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const;
 
+    // Check whether `xop` can be applied with a 32-bit integer constant as
+    // `S_apply_operator_bi32`.
+    static
+    bool
+    is_bi32_operator(Xop xop) noexcept;
+
+    // Merge common sequences of nodes in `code` into superinstructions. Nested
+    // blocks are processed recursively. Bodies of closures and deferred
+    // expressions are left intact, as they have to be rebound later. `code`
+    // is only modified if any nodes have been merged, in which case `true` is
+    // returned.
+    static
+    bool
+    fuse_nodes(cow_vector<AIR_Node>& code);
+
     // Compress this IR node into `rod` for execution.
     void
     solidify(AVM_Rod& rod) const;
+
+    // Write this IR node to `ser` in a portable binary form, and read one
+    // back. Bound references cannot be serialized.
+    void
+    serialize(AIR_Serializer& ser) const;
+
+    static
+    AIR_Node
+    deserialize(AIR_Serializer& ser);
   };
 
 inline
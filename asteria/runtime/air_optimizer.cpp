@@ -22,6 +22,8 @@ AIR_Optimizer::
 clear() noexcept
   {
     this->m_code.clear();
+    this->m_source.clear();
+    this->m_serializable = false;
   }
 
 void
@@ -30,6 +32,8 @@ reload(const Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
        const Global_Context& global, const cow_vector<Statement>& stmts)
   {
     this->m_code.clear();
+    this->m_source.clear();
+    this->m_serializable = false;
     this->m_params = params;
 
     if(stmts.empty())
@@ -46,7 +50,11 @@ reload(const Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
     if(this->m_opts.optimization_level <= 0)
       return;
 
-    // TODO: Insert optimization passes
+    // Merge common sequences of nodes into superinstructions. The body of a
+    // closure may reference variables of its enclosing function, which must
+    // be rebound before fusion, so it is fused when it is instantiated.
+    if((this->m_opts.optimization_level >= 3) && !ctx_opt)
+      AIR_Node::fuse_nodes(this->m_code);
   }
 
 void
@@ -55,6 +63,8 @@ rebind(const Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
        const cow_vector<AIR_Node>& code)
   {
     this->m_code = code;
+    this->m_source = code;
+    this->m_serializable = true;
     this->m_params = params;
 
     if(code.empty())
@@ -62,10 +72,26 @@ rebind(const Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
 
     // Rebind all nodes recursively.
     Analytic_Context ctx_func(xtc_function, ctx_opt, this->m_params);
+    bool bound = false;
 
     for(size_t k = 0;  k < code.size();  ++k)
-      if(auto qnode = code.at(k).rebind_opt(ctx_func))
+      if(auto qnode = code.at(k).rebind_opt(ctx_func)) {
         this->m_code.mut(k) = move(*qnode);
+        bound = true;
+      }
+
+    // If a variable from an enclosing function has been bound, the function
+    // can't be serialized. Otherwise it can be serialized from its original
+    // code, which is shared with the node that defines it.
+    if(bound) {
+      this->m_source.clear();
+      this->m_serializable = false;
+    }
+
+    // Local references that remain after rebinding denote variables in the
+    // function itself, and can be fused.
+    if(this->m_opts.optimization_level >= 3)
+      AIR_Node::fuse_nodes(this->m_code);
   }
 
 cow_function
@@ -92,7 +118,9 @@ create_function(const Source_Location& sloc, cow_stringR name)
     }
 
     // Instantiate the function object now.
-    return ::rocket::make_refcnt<Instantiated_Function>(sloc, func, this->m_params, this->m_code);
+    return ::rocket::make_refcnt<Instantiated_Function>(this->m_opts, sloc, func, this->m_params,
+                                                        this->m_code,
+                                                        this->m_serializable ? &(this->m_source) : nullptr);
   }
 
 }  // namespace asteria
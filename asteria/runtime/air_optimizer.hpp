@@ -13,6 +13,8 @@ class AIR_Optimizer
     Compiler_Options m_opts;
     cow_vector<phsh_string> m_params;
     cow_vector<AIR_Node> m_code;
+    cow_vector<AIR_Node> m_source;  // before rebinding and fusion
+    bool m_serializable = false;
 
   public:
     explicit constexpr AIR_Optimizer(const Compiler_Options& opts) noexcept
@@ -0,0 +1,457 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "air_serializer.hpp"
+#include "air_node.hpp"
+#include "../value.hpp"
+#include "../source_location.hpp"
+#include "../utils.hpp"
+#include <zlib.h>
+namespace asteria {
+namespace {
+
+// Every compiled script starts with this signature. The first byte is not
+// valid UTF-8, so no source file can be mistaken for a compiled script.
+constexpr char s_magic[8] = { '\x89', 'A', 'S', 'T', 'A', 'I', 'R', '\x1A' };
+
+// The header consists of the signature, the format version, the CRC-32 of
+// the payload and the length of the payload, in this order. All integers
+// are little-endian.
+constexpr size_t s_header_size = 24;
+
+void
+do_store_le(char* bytes, uint64_t value, size_t width) noexcept
+  {
+    for(size_t k = 0;  k != width;  ++k)
+      bytes[k] = static_cast<char>(value >> k * 8);
+  }
+
+uint64_t
+do_load_le(const unsigned char* bytes, size_t width) noexcept
+  {
+    uint64_t value = 0;
+    for(size_t k = 0;  k != width;  ++k)
+      value |= static_cast<uint64_t>(bytes[k]) << k * 8;
+    return value;
+  }
+
+uint32_t
+do_crc32(const void* data, size_t size) noexcept
+  {
+    return static_cast<uint32_t>(::crc32_z(0, static_cast<const ::Bytef*>(data), size));
+  }
+
+}  // namespace
+
+AIR_Serializer::
+~AIR_Serializer()
+  {
+  }
+
+void
+AIR_Serializer::
+do_put_le(uint64_t value, size_t width)
+  {
+    char bytes[8];
+    do_store_le(bytes, value, width);
+    this->m_obuf.append(bytes, width);
+  }
+
+uint64_t
+AIR_Serializer::
+do_get_le(size_t width)
+  {
+    if(static_cast<size_t>(this->m_iend - this->m_ipos) < width)
+      ASTERIA_THROW(("Compiled script truncated"));
+
+    uint64_t value = do_load_le(this->m_ipos, width);
+    this->m_ipos += width;
+    return value;
+  }
+
+bool
+AIR_Serializer::
+is_compiled(const void* data, size_t size) noexcept
+  {
+    return (size >= sizeof(s_magic)) && (::memcmp(data, s_magic, sizeof(s_magic)) == 0);
+  }
+
+cow_string
+AIR_Serializer::
+save(const Compiler_Options& opts, cow_stringR name, const cow_vector<phsh_string>& params,
+     const cow_vector<AIR_Node>& code)
+  {
+    // Encode the body first, which also populates the string table.
+    this->m_strings.clear();
+    this->m_string_index.clear();
+    this->m_obuf.clear();
+
+    this->put_options(opts);
+    this->put_string(name);
+    this->put_names(params);
+    this->put_code(code);
+
+    cow_string body;
+    body.swap(this->m_obuf);
+
+    // The string table precedes the body, so it can be loaded in one pass.
+    this->put_u32(static_cast<uint32_t>(this->m_strings.size()));
+    for(const auto& str : this->m_strings) {
+      this->put_u32(static_cast<uint32_t>(str.size()));
+      this->m_obuf.append(str.rdstr());
+    }
+    this->m_obuf.append(body);
+
+    // Compose the header.
+    char header[s_header_size];
+    ::memcpy(header, s_magic, sizeof(s_magic));
+    do_store_le(header + 8, format_version, 4);
+    do_store_le(header + 12, do_crc32(this->m_obuf.data(), this->m_obuf.size()), 4);
+    do_store_le(header + 16, this->m_obuf.size(), 8);
+
+    cow_string bytes;
+    bytes.reserve(s_header_size + this->m_obuf.size());
+    bytes.append(header, s_header_size);
+    bytes.append(this->m_obuf);
+    this->m_obuf.clear();
+    return bytes;
+  }
+
+void
+AIR_Serializer::
+load(Compiler_Options& opts, cow_string& name, cow_vector<phsh_string>& params,
+     cow_vector<AIR_Node>& code, const void* data, size_t size)
+  {
+    // Validate the header.
+    if(!is_compiled(data, size))
+      ASTERIA_THROW(("Invalid signature of compiled script"));
+
+    if(size < s_header_size)
+      ASTERIA_THROW(("Compiled script truncated (size `$1`)"), size);
+
+    auto bptr = static_cast<const unsigned char*>(data);
+    uint32_t version = static_cast<uint32_t>(do_load_le(bptr + 8, 4));
+    if(version != format_version)
+      ASTERIA_THROW((
+          "Compiled script format version `$1` not supported",
+          "[expecting version `$2`]"),
+          version, format_version);
+
+    uint64_t length = do_load_le(bptr + 16, 8);
+    if(length != size - s_header_size)
+      ASTERIA_THROW((
+          "Compiled script length mismatch",
+          "[`$1` bytes expected, `$2` bytes available]"),
+          length, size - s_header_size);
+
+    uint32_t crc = static_cast<uint32_t>(do_load_le(bptr + 12, 4));
+    if(do_crc32(bptr + s_header_size, size - s_header_size) != crc)
+      ASTERIA_THROW(("Compiled script checksum mismatch"));
+
+    this->m_ipos = bptr + s_header_size;
+    this->m_iend = bptr + size;
+
+    // Load the string table.
+    this->m_strings.clear();
+    this->m_string_index.clear();
+
+    uint32_t nstrs = this->get_u32();
+    if(nstrs > static_cast<size_t>(this->m_iend - this->m_ipos) / 4)
+      ASTERIA_THROW(("Compiled script string table corrupted (count `$1`)"), nstrs);
+
+    this->m_strings.reserve(nstrs);
+    while(this->m_strings.size() != nstrs) {
+      uint32_t len = this->get_u32();
+      if(len > static_cast<size_t>(this->m_iend - this->m_ipos))
+        ASTERIA_THROW(("Compiled script string table corrupted (length `$1`)"), len);
+
+      this->m_strings.emplace_back(cow_string(reinterpret_cast<const char*>(this->m_ipos), len));
+      this->m_ipos += len;
+    }
+
+    // Load the body.
+    opts = this->get_options();
+    name = this->get_string();
+    params = this->get_names();
+    code = this->get_code();
+
+    if(this->m_ipos != this->m_iend)
+      ASTERIA_THROW(("Compiled script contains `$1` trailing bytes"),
+                    this->m_iend - this->m_ipos);
+  }
+
+bool
+AIR_Serializer::
+get_bool()
+  {
+    uint8_t value = this->get_u8();
+    if(value > 1)
+      ASTERIA_THROW(("Invalid boolean value `$1` in compiled script"), value);
+    return value;
+  }
+
+void
+AIR_Serializer::
+throw_invalid_enum(uint8_t value)
+  {
+    ASTERIA_THROW(("Invalid enumeration `$1` in compiled script"), value);
+  }
+
+void
+AIR_Serializer::
+put_f64(double value)
+  {
+    uint64_t bits;
+    bcopy(bits, value);
+    this->do_put_le(bits, 8);
+  }
+
+double
+AIR_Serializer::
+get_f64()
+  {
+    uint64_t bits = this->do_get_le(8);
+    double value;
+    bcopy(value, bits);
+    return value;
+  }
+
+void
+AIR_Serializer::
+put_name(phsh_stringR name)
+  {
+    auto qindex = this->m_string_index.ptr(name);
+    if(qindex)
+      return this->put_u32(*qindex);
+
+    uint32_t index = static_cast<uint32_t>(this->m_strings.size());
+    this->m_strings.emplace_back(name);
+    this->m_string_index.try_emplace(name, index);
+    this->put_u32(index);
+  }
+
+phsh_string
+AIR_Serializer::
+get_name()
+  {
+    uint32_t index = this->get_u32();
+    if(index >= this->m_strings.size())
+      ASTERIA_THROW(("Invalid string index `$1` in compiled script"), index);
+    return this->m_strings[index];
+  }
+
+void
+AIR_Serializer::
+put_names(const cow_vector<phsh_string>& names)
+  {
+    this->put_u32(static_cast<uint32_t>(names.size()));
+    for(const auto& name : names)
+      this->put_name(name);
+  }
+
+cow_vector<phsh_string>
+AIR_Serializer::
+get_names()
+  {
+    uint32_t count = this->get_u32();
+    if(count > static_cast<size_t>(this->m_iend - this->m_ipos) / 4)
+      ASTERIA_THROW(("Compiled script truncated (`$1` names expected)"), count);
+
+    cow_vector<phsh_string> names;
+    names.reserve(count);
+    while(names.size() != count)
+      names.emplace_back(this->get_name());
+    return names;
+  }
+
+void
+AIR_Serializer::
+put_sloc(const Source_Location& sloc)
+  {
+    this->put_string(sloc.file());
+    this->put_i32(sloc.line());
+    this->put_i32(sloc.column());
+  }
+
+Source_Location
+AIR_Serializer::
+get_sloc()
+  {
+    // Note the order of evaluation is well defined in braced lists.
+    return { this->get_string(), this->get_i32(), this->get_i32() };
+  }
+
+void
+AIR_Serializer::
+put_options(const Compiler_Options& opts)
+  {
+    this->put_u8(opts.version);
+    this->put_bool(opts.escapable_single_quotes);
+    this->put_bool(opts.keywords_as_identifiers);
+    this->put_bool(opts.integers_as_reals);
+    this->put_bool(opts.proper_tail_calls);
+    this->put_bool(opts.verbose_single_step_traps);
+    this->put_bool(opts.implicit_global_names);
+    this->put_u8(opts.optimization_level);
+  }
+
+Compiler_Options
+AIR_Serializer::
+get_options()
+  {
+    Compiler_Options opts;
+    uint8_t version = this->get_u8();
+    if(version != opts.version)
+      ASTERIA_THROW(("Compiler options version `$1` not supported"), version);
+
+    opts.escapable_single_quotes = this->get_bool();
+    opts.keywords_as_identifiers = this->get_bool();
+    opts.integers_as_reals = this->get_bool();
+    opts.proper_tail_calls = this->get_bool();
+    opts.verbose_single_step_traps = this->get_bool();
+    opts.implicit_global_names = this->get_bool();
+    opts.optimization_level = this->get_u8();
+    return opts;
+  }
+
+void
+AIR_Serializer::
+put_value(const Value& val)
+  {
+    this->put_enum(val.type());
+
+    switch(val.type())
+      {
+      case type_null:
+        return;
+
+      case type_boolean:
+        return this->put_bool(val.as_boolean());
+
+      case type_integer:
+        return this->put_i64(val.as_integer());
+
+      case type_real:
+        return this->put_f64(val.as_real());
+
+      case type_string:
+        return this->put_string(val.as_string());
+
+      case type_opaque:
+      case type_function:
+        ASTERIA_THROW(("Value of type `$1` cannot be serialized"), describe_type(val.type()));
+
+      case type_array:
+        {
+          const auto& arr = val.as_array();
+          this->put_u32(static_cast<uint32_t>(arr.size()));
+          for(const auto& elem : arr)
+            this->put_value(elem);
+          return;
+        }
+
+      case type_object:
+        {
+          const auto& obj = val.as_object();
+          this->put_u32(static_cast<uint32_t>(obj.size()));
+          for(const auto& pair : obj) {
+            this->put_name(pair.first);
+            this->put_value(pair.second);
+          }
+          return;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), val.type());
+    }
+  }
+
+Value
+AIR_Serializer::
+get_value()
+  {
+    const auto sentry = this->m_sentry;
+    auto type = this->get_enum(type_object);
+
+    switch(type)
+      {
+      case type_null:
+        return nullopt;
+
+      case type_boolean:
+        return this->get_bool();
+
+      case type_integer:
+        return this->get_i64();
+
+      case type_real:
+        return this->get_f64();
+
+      case type_string:
+        return this->get_string();
+
+      case type_opaque:
+      case type_function:
+        ASTERIA_THROW(("Value of type `$1` not allowed in compiled script"), describe_type(type));
+
+      case type_array:
+        {
+          uint32_t count = this->get_u32();
+          if(count > static_cast<size_t>(this->m_iend - this->m_ipos))
+            ASTERIA_THROW(("Compiled script truncated (`$1` elements expected)"), count);
+
+          V_array arr;
+          arr.reserve(count);
+          while(arr.size() != count)
+            arr.emplace_back(this->get_value());
+          return arr;
+        }
+
+      case type_object:
+        {
+          uint32_t count = this->get_u32();
+          if(count > static_cast<size_t>(this->m_iend - this->m_ipos) / 5)
+            ASTERIA_THROW(("Compiled script truncated (`$1` elements expected)"), count);
+
+          V_object obj;
+          obj.reserve(count);
+          while(count != 0) {
+            auto key = this->get_name();
+            obj.insert_or_assign(move(key), this->get_value());
+            count --;
+          }
+          return obj;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), type);
+    }
+  }
+
+void
+AIR_Serializer::
+put_code(const cow_vector<AIR_Node>& code)
+  {
+    this->put_u32(static_cast<uint32_t>(code.size()));
+    for(const auto& node : code)
+      node.serialize(*this);
+  }
+
+cow_vector<AIR_Node>
+AIR_Serializer::
+get_code()
+  {
+    const auto sentry = this->m_sentry;
+    uint32_t count = this->get_u32();
+    if(count > static_cast<size_t>(this->m_iend - this->m_ipos))
+      ASTERIA_THROW(("Compiled script truncated (`$1` nodes expected)"), count);
+
+    cow_vector<AIR_Node> code;
+    code.reserve(count);
+    while(code.size() != count)
+      code.emplace_back(AIR_Node::deserialize(*this));
+    return code;
+  }
+
+}  // namespace asteria
@@ -0,0 +1,176 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_AIR_SERIALIZER_
+#define ASTERIA_RUNTIME_AIR_SERIALIZER_
+
+#include "../fwd.hpp"
+#include "../recursion_sentry.hpp"
+namespace asteria {
+
+class AIR_Serializer
+  {
+  public:
+    // This shall be incremented whenever the encoding of an IR node changes.
+    static constexpr uint32_t format_version = 2;
+
+  private:
+    // Strings are stored in a table, and are referenced by index.
+    cow_vector<phsh_string> m_strings;
+    cow_dictionary<uint32_t> m_string_index;
+
+    // These are used for saving.
+    cow_string m_obuf;
+
+    // These are used for loading.
+    const unsigned char* m_ipos = nullptr;
+    const unsigned char* m_iend = nullptr;
+    Recursion_Sentry m_sentry;
+
+  public:
+    AIR_Serializer() noexcept
+      { }
+
+  private:
+    void
+    do_put_le(uint64_t value, size_t width);
+
+    uint64_t
+    do_get_le(size_t width);
+
+  public:
+    AIR_Serializer(const AIR_Serializer&) = delete;
+    AIR_Serializer& operator=(const AIR_Serializer&) & = delete;
+    ~AIR_Serializer();
+
+    // Checks whether `data` starts with the signature of a compiled script.
+    static bool
+    is_compiled(const void* data, size_t size) noexcept;
+
+    // Encodes a compiled script into a sequence of bytes, which can be
+    // written to a file and loaded later.
+    cow_string
+    save(const Compiler_Options& opts, cow_stringR name, const cow_vector<phsh_string>& params,
+         const cow_vector<AIR_Node>& code);
+
+    // Decodes a compiled script. All data are validated, and an exception is
+    // thrown if they are truncated or corrupted. Depths of local references
+    // are checked when the code is rebound. `data` is not referenced after
+    // this function returns.
+    void
+    load(Compiler_Options& opts, cow_string& name, cow_vector<phsh_string>& params,
+         cow_vector<AIR_Node>& code, const void* data, size_t size);
+
+    // These functions encode and decode individual fields. They are called
+    // by `AIR_Node`.
+    void
+    put_u8(uint8_t value)
+      { this->do_put_le(value, 1);  }
+
+    uint8_t
+    get_u8()
+      { return static_cast<uint8_t>(this->do_get_le(1));  }
+
+    void
+    put_bool(bool value)
+      { this->do_put_le(value, 1);  }
+
+    bool
+    get_bool();
+
+    template<typename enumT>
+    void
+    put_enum(enumT value)
+      { this->do_put_le(static_cast<uint8_t>(value), 1);  }
+
+    template<typename enumT>
+    enumT
+    get_enum(enumT last)
+      {
+        uint8_t value = this->get_u8();
+        if(value > static_cast<uint8_t>(last))
+          this->throw_invalid_enum(value);
+        return static_cast<enumT>(value);
+      }
+
+    [[noreturn]]
+    void
+    throw_invalid_enum(uint8_t value);
+
+    void
+    put_u32(uint32_t value)
+      { this->do_put_le(value, 4);  }
+
+    uint32_t
+    get_u32()
+      { return static_cast<uint32_t>(this->do_get_le(4));  }
+
+    void
+    put_i32(int32_t value)
+      { this->do_put_le(static_cast<uint32_t>(value), 4);  }
+
+    int32_t
+    get_i32()
+      { return static_cast<int32_t>(static_cast<uint32_t>(this->do_get_le(4)));  }
+
+    void
+    put_i64(int64_t value)
+      { this->do_put_le(static_cast<uint64_t>(value), 8);  }
+
+    int64_t
+    get_i64()
+      { return static_cast<int64_t>(this->do_get_le(8));  }
+
+    void
+    put_f64(double value);
+
+    double
+    get_f64();
+
+    void
+    put_name(phsh_stringR name);
+
+    phsh_string
+    get_name();
+
+    void
+    put_string(cow_stringR str)
+      { this->put_name(phsh_string(str));  }
+
+    cow_string
+    get_string()
+      { return this->get_name().rdstr();  }
+
+    void
+    put_names(const cow_vector<phsh_string>& names);
+
+    cow_vector<phsh_string>
+    get_names();
+
+    void
+    put_sloc(const Source_Location& sloc);
+
+    Source_Location
+    get_sloc();
+
+    void
+    put_options(const Compiler_Options& opts);
+
+    Compiler_Options
+    get_options();
+
+    void
+    put_value(const Value& val);
+
+    Value
+    get_value();
+
+    void
+    put_code(const cow_vector<AIR_Node>& code);
+
+    cow_vector<AIR_Node>
+    get_code();
+  };
+
+}  // namespace asteria
+#endif
@@ -5,7 +5,76 @@
 #include "garbage_collector.hpp"
 #include "variable.hpp"
 #include "../utils.hpp"
+#include <time.h>  // ::clock_gettime(), ::timespec
 namespace asteria {
+namespace {
+
+int64_t
+do_monotonic_now_ns() noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  }
+
+int64_t
+do_thread_cpu_now_ns() noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  }
+
+void
+do_record_pause(GC_Statistics& stats, int64_t start_ns) noexcept
+  {
+    uint64_t dur_ns = (uint64_t) ::rocket::max(do_monotonic_now_ns() - start_ns, 0);
+    stats.pause_count ++;
+    stats.pause_total_ns += dur_ns;
+    stats.pause_max_ns = ::rocket::max(stats.pause_max_ns, dur_ns);
+
+    // Get the binary logarithm of the duration in microseconds.
+    uint64_t dur_us = dur_ns / 1000;
+    size_t k = (dur_us <= 1) ? 0 : (size_t) (63 - ROCKET_LZCNT64(dur_us));
+    k = ::rocket::min(k, stats.pause_histogram.size() - 1);
+    stats.pause_histogram[k] ++;
+  }
+
+void
+do_transfer_variables(Variable_HashMap& to, Variable_HashMap& from)
+  {
+    if(to.empty()) {
+      to.swap(from);
+      return;
+    }
+
+    // Move variables one by one, so each of them stays in exactly one table
+    // if an exception is thrown.
+    Variable* var;
+    while(from.extract_variable(var))
+      try {
+        to.insert(var, var);
+      }
+      catch(...) {
+        from.insert(var, var);
+        throw;
+      }
+  }
+
+void
+do_release_variables(Variable_HashMap& table, bool wipe) noexcept
+  {
+    // Drop references that are owned by `table`. Variables may be shared
+    // elsewhere, so their values are destroyed only if `wipe` is set.
+    Variable* var;
+    while(table.extract_variable(var)) {
+      refcnt_ptr<Variable> ref(var);
+      if(wipe)
+        var->uninitialize();
+    }
+  }
+
+}  // namespace
 
 Garbage_Collector::
 Garbage_Collector() noexcept
@@ -15,11 +84,17 @@ Garbage_Collector() noexcept
 Garbage_Collector::
 ~Garbage_Collector()
   {
+    for(auto& tracked : this->m_tracked)
+      do_release_variables(tracked, false);
+
+    do_release_variables(this->m_slice, false);
+    do_release_variables(this->m_visited, false);
+    do_release_variables(this->m_pool, false);
   }
 
 size_t
 Garbage_Collector::
-do_collect_generation(uint32_t gen)
+do_collect_tracked(Variable_HashMap& tracked, uint32_t gen, bool local)
   {
     // Ignore recursive requests.
     if(this->m_recur > 0)
@@ -27,12 +102,26 @@ do_collect_generation(uint32_t gen)
 
     this->m_recur ++;
     const ::rocket::unique_ptr<int, void (int*)> rguard(&(this->m_recur), *[](int* ptr) { -- *ptr;  });
+    const int64_t start_ns = do_monotonic_now_ns();
+    const int64_t start_cpu_ns = (this->m_policy == gc_policy_adaptive) ? do_thread_cpu_now_ns() : 0;
+    auto& gstat = this->m_stats.generations.at(gen);
 
     // This algorithm is described at
     //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
+    // If `local` is set, only variables in `tracked` are traced. Variables
+    // that are referenced from elsewhere are not counted as internal, which
+    // makes them look reachable, so this remains safe. When a slice of the
+    // oldest generation is being checked, other variables of that generation
+    // are pulled into it, so cycles among them can be found as a whole.
+    //
+    // Tables own no references. A variable that is encountered here is kept
+    // alive by either a table of this collector or the value of another
+    // variable, and no value is modified before the last step. The `gc_ref`
+    // counter of a variable counts the reference from `tracked` and those
+    // from values that have been traced, and is set to `-1` when it has been
+    // proven reachable.
     size_t nvars = 0;
-    refcnt_ptr<Variable> var;
-    auto& tracked = this->m_tracked.at(gMax - gen);
+    Variable* var;
     const auto next_opt = (gen >= gMax) ? nullptr : &(this->m_tracked.at(gMax - gen - 1));
     const auto count_opt = (gen >= gMax) ? nullptr : &(this->m_counts.at(gMax - gen - 1));
 
@@ -40,69 +129,92 @@ do_collect_generation(uint32_t gen)
     this->m_temp_1.clear();
     this->m_temp_2.clear();
     this->m_unreach.clear();
-    tracked.merge_into(this->m_temp_1);
-
-    while(this->m_temp_1.extract_variable(var)) {
-      // Each variable that is encountered here shall have a direct reference
-      // from either `tracked` or `m_staged`, so its `gc_ref` counter shall be
-      // initialized to one.
-      var->set_gc_ref(1);
-      ROCKET_ASSERT(var->get_gc_ref() <= var->use_count() - 1);
-      var->get_value().collect_variables(this->m_staged, this->m_temp_1);
-    }
 
-    this->m_temp_1.clear();
+    tracked.for_each(
+      [&](Variable* qvar) {
+        // Each variable in `tracked` has a reference from this collector.
+        qvar->set_gc_ref(1);
+        qvar->get_value().collect_variables(this->m_staged, this->m_temp_2);
+        gstat.scanned ++;
+      });
+
+    while(this->m_temp_2.extract_variable(var)) {
+      // Trace each other variable once. `m_temp_1` records variables that
+      // are not in `tracked`.
+      if(tracked.find(var) || !this->m_temp_1.insert(var, var))
+        continue;
+
+      bool member = false;
+      if(local && (gen >= gMax) && (tracked.size() < this->m_budget)) {
+        auto& pending = this->m_tracked.at(0);
+        if(pending.find(var) || this->m_visited.find(var)) {
+          tracked.insert(var, var);
+          if(!pending.erase(var))
+            this->m_visited.erase(var);
+          member = true;
+        }
+      }
+
+      var->set_gc_ref(member);
+      if(local && !member)
+        continue;
 
-    while(this->m_staged.extract_variable(var)) {
-      // Each key in `m_staged` denotes an internal reference, so its `gc_ref`
-      // counter shall be incremented.
-      var->set_gc_ref(var->get_gc_ref() + 1);
-      ROCKET_ASSERT(var->get_gc_ref() <= var->use_count() - 1);
-      this->m_temp_1.insert(var.get(), var);
+      var->get_value().collect_variables(this->m_staged, this->m_temp_2);
+      gstat.scanned ++;
     }
 
+    // Each key in `m_staged` denotes an internal reference, so its `gc_ref`
+    // counter shall be incremented.
+    this->m_staged.for_each(
+      [&](Variable* qvar) {
+        qvar->set_gc_ref(qvar->get_gc_ref() + 1);
+        ROCKET_ASSERT(qvar->get_gc_ref() <= qvar->use_count());
+      });
+
     this->m_staged.clear();
-    tracked.merge_into(this->m_temp_1);
-
-    while(this->m_temp_1.extract_variable(var)) {
-      // Each variable whose `gc_ref` counter equals its reference count is
-      // marked as possibly unreachable. Note `var` here owns a reference
-      // which must be excluded.
-      if(var->get_gc_ref() == var->use_count() - 1)
-        this->m_unreach.insert(var.get(), var);
-      else
-        this->m_temp_2.insert(var.get(), var);
-    }
 
+    // Each variable whose reference count exceeds its `gc_ref` counter is
+    // referenced from elsewhere, so it is reachable. Mark it, and variables
+    // that it references.
+    const auto mark_root =
+      [&](Variable* qvar) {
+        if((qvar->get_gc_ref() < 0) || (qvar->get_gc_ref() >= qvar->use_count()))
+          return;
+
+        qvar->set_gc_ref(-1);
+        if(!local || tracked.find(qvar))
+          qvar->get_value().collect_variables(this->m_staged, this->m_temp_2);
+      };
+
+    tracked.for_each(mark_root);
+    this->m_temp_1.for_each(mark_root);
     this->m_temp_1.clear();
 
     while(this->m_temp_2.extract_variable(var)) {
       // Mark this indirectly reachable variable, too.
-      var->set_gc_ref(0);
-      this->m_temp_1.erase(var.get());
-      this->m_unreach.erase(var.get());
-
-      var->get_value().collect_variables(this->m_staged, this->m_temp_2);
+      if(var->get_gc_ref() < 0)
+        continue;
 
-      if(next_opt && tracked.erase(var.get()))
-        try {
-          // Move the variable to the next generation.
-          next_opt->insert(var.get(), var);
-          *count_opt += 1;
-        }
-        catch(...) {
-          tracked.insert(var.get(), var);
-        }
+      var->set_gc_ref(-1);
+      if(!local || tracked.find(var))
+        var->get_value().collect_variables(this->m_staged, this->m_temp_2);
     }
 
-    this->m_temp_2.clear();
+    this->m_staged.clear();
 
-    while(this->m_unreach.extract_variable(var)) {
-      // This variable is unreachable now, so collect it.
-      if(!tracked.erase(var.get()))
-        continue;
+    // Variables that have not been marked are unreachable.
+    tracked.for_each(
+      [&](Variable* qvar) {
+        if(qvar->get_gc_ref() >= 0)
+          this->m_unreach.insert(qvar, qvar);
+      });
 
+    while(this->m_unreach.extract_variable(var)) {
+      // This variable is unreachable now, so collect it. Its reference is
+      // taken from `tracked`.
       ROCKET_ASSERT(var->get_gc_ref() != 0);
+      refcnt_ptr<Variable> ref(var);
+      tracked.erase(var);
       nvars += 1;
 
       try {
@@ -110,7 +222,8 @@ do_collect_generation(uint32_t gen)
         // If an exception is thrown during uninitialization, the variable
         // shall be collected immediately.
         var->uninitialize();
-        this->m_pool.insert(var.get(), var);
+        this->m_pool.insert(var, var);
+        ref.release();
       }
       catch(exception& stdex) {
         ::fprintf(stderr,
@@ -124,34 +237,225 @@ do_collect_generation(uint32_t gen)
       }
     }
 
-    this->m_unreach.clear();
+    if(next_opt) {
+      // Move surviving variables to the next generation.
+      size_t nmoved = tracked.size();
+      do_transfer_variables(*next_opt, tracked);
+      *count_opt += nmoved;
+      gstat.promoted += nmoved;
+    }
+
+    gstat.collections ++;
+    gstat.freed += nvars;
+    gstat.time_ns += (uint64_t) ::rocket::max(do_monotonic_now_ns() - start_ns, 0);
+    if(this->m_policy == gc_policy_adaptive)
+      this->m_adapt_cpu_ns.at(gen) += ::rocket::max(do_thread_cpu_now_ns() - start_cpu_ns, 0);
+
+    // Return the number of variables that have been collected.
+    return nvars;
+  }
+
+size_t
+Garbage_Collector::
+do_collect_generation(uint32_t gen, bool local)
+  {
+    size_t nvars = this->do_collect_tracked(this->m_tracked.at(gMax - gen), gen, local);
 
     // Reset the GC counter to zero only if the operation completes
     // normally i.e. don't reset it if an exception is thrown.
     this->m_counts[gMax-gen] = 0;
+    return nvars;
+  }
 
-    // Return the number of variables that have been collected.
+size_t
+Garbage_Collector::
+do_collect_slice()
+  {
+    if(this->m_recur > 0)
+      return 0;
+
+    // Take variables that have not been checked in this pass. Half of the
+    // budget is reserved for variables that are reachable from them, which
+    // will be pulled in during tracing.
+    Variable* var;
+    auto& pending = this->m_tracked.at(0);
+    size_t nseeds = this->m_budget / 2 + 1;
+    while((this->m_slice.size() < nseeds) && pending.extract_variable(var))
+      try {
+        this->m_slice.insert(var, var);
+      }
+      catch(...) {
+        pending.insert(var, var);
+        throw;
+      }
+
+    size_t nvars = this->do_collect_tracked(this->m_slice, gMax, true);
+
+    // Mark survivors as checked.
+    do_transfer_variables(this->m_visited, this->m_slice);
+
+    if(pending.empty()) {
+      // All variables have been checked, so finish this pass.
+      pending.swap(this->m_visited);
+      this->m_counts[0] = 0;
+      this->m_incr = false;
+
+      if(this->m_policy == gc_policy_adaptive)
+        this->do_adapt_threshold(gMax);
+    }
     return nvars;
   }
 
+void
+Garbage_Collector::
+do_cancel_incremental()
+  {
+    // Put all variables back into the oldest generation.
+    auto& pending = this->m_tracked.at(0);
+    do_transfer_variables(pending, this->m_slice);
+    do_transfer_variables(pending, this->m_visited);
+    this->m_incr = false;
+  }
+
+void
+Garbage_Collector::
+do_adapt_threshold(uint32_t gen)
+  {
+    // Get statistics since the last adjustment. Time is measured on the CPU
+    // clock of the current thread, so time when this thread is not running,
+    // or is waiting for something, is not counted. If the context has been
+    // moved to another thread, the clock is not comparable, and the negative
+    // difference is clamped.
+    const auto& gstat = this->m_stats.generations.at(gen);
+    auto& last = this->m_adapt_stats.at(gen);
+    int64_t now_ns = do_thread_cpu_now_ns();
+    double pause_ns = (double) this->m_adapt_cpu_ns.at(gen);
+    double total_ns = (double) ::rocket::max(now_ns - this->m_adapt_time.at(gen), 1);
+    double nscanned = (double) (gstat.scanned - last.scanned);
+    double nfreed = (double) (gstat.freed - last.freed);
+    last = gstat;
+    this->m_adapt_time.at(gen) = now_ns;
+    this->m_adapt_cpu_ns.at(gen) = 0;
+
+    // Collect less often if more time than the target has been spent, and
+    // more often otherwise. The step is limited to avoid oscillation.
+    double scale = ::rocket::clamp(pause_ns / total_ns / this->m_target, 0.5, 2.0);
+    if(scale > 1) {
+      // Collecting less often only saves time that is spent on variables that
+      // survive, or that belong to other generations. Tracing garbage costs
+      // the same, no matter how it is batched.
+      double waste = (nscanned > 0) ? (nscanned - nfreed) / nscanned : 0.0;
+      scale = 1 + (scale - 1) * waste;
+    }
+
+    double thres = (double) this->m_thres[gMax-gen] * scale;
+    if(gen == gMax) {
+      // Do not check the oldest generation again before it has grown by a
+      // quarter, as most of it is going to survive anyway.
+      thres = ::rocket::max(thres, (nscanned - nfreed) / 4);
+    }
+
+    this->m_thres[gMax-gen] = (size_t) ::rocket::clamp(thres, 10.0, 16777216.0);
+  }
+
+void
+Garbage_Collector::
+set_policy(GC_Policy policy, double target)
+  {
+    if(!(target > 0) || !(target < 1))
+      ASTERIA_THROW(("Invalid target overhead `$1`"), target);
+
+    // Start measuring from now on.
+    int64_t now_ns = do_thread_cpu_now_ns();
+    for(uint32_t gen = 0;  gen <= gMax;  ++gen) {
+      this->m_adapt_stats.at(gen) = this->m_stats.generations.at(gen);
+      this->m_adapt_time.at(gen) = now_ns;
+      this->m_adapt_cpu_ns.at(gen) = 0;
+    }
+
+    this->m_policy = policy;
+    this->m_target = target;
+  }
+
+void
+Garbage_Collector::
+set_incremental_budget(size_t budget) noexcept
+  {
+    if(budget == 0)
+      try {
+        this->do_cancel_incremental();
+      }
+      catch(exception& stdex) {
+        // Variables cannot be put back without memory, so keep the current
+        // pass, which will be finished later.
+        ::fprintf(stderr,
+            "WARNING: Could not cancel incremental garbage collection: %s\n",
+            stdex.what());
+        return;
+      }
+
+    this->m_budget = budget;
+  }
+
+void
+Garbage_Collector::
+clear_pooled_variables() noexcept
+  {
+    do_release_variables(this->m_pool, false);
+  }
+
 refcnt_ptr<Variable>
 Garbage_Collector::
 create_variable(GC_Generation gen_hint)
   {
-    // Perform automatic garbage collection.
-    for(uint32_t gen = 0;  gen <= gMax;  ++gen)
-      if(this->m_counts[gMax-gen] >= this->m_thres[gMax-gen])
-        this->do_collect_generation(gen);
+    // Perform automatic garbage collection. In incremental mode, the oldest
+    // generation is checked in slices. All collections in this call make up
+    // a single pause.
+    int64_t start_ns = -1;
+    uint32_t gen_limit = (this->m_budget == 0) ? gMax : gMax - 1;
+    for(uint32_t gen = 0;  gen <= gen_limit;  ++gen)
+      if((this->m_recur == 0) && (this->m_counts[gMax-gen] >= this->m_thres[gMax-gen])) {
+        if(start_ns < 0)
+          start_ns = do_monotonic_now_ns();
+
+        this->do_collect_generation(gen, gen_limit < gMax);
+
+        if(this->m_policy == gc_policy_adaptive)
+          this->do_adapt_threshold(gen);
+      }
+
+    if(gen_limit < gMax) {
+      if(this->m_counts[0] >= this->m_thres[0])
+        this->m_incr = true;
+
+      if((this->m_recur == 0) && this->m_incr) {
+        if(start_ns < 0)
+          start_ns = do_monotonic_now_ns();
+
+        this->do_collect_slice();
+      }
+    }
 
-    // Get a cached variable.
+    if(start_ns >= 0)
+      do_record_pause(this->m_stats, start_ns);
+
+    // Get a cached variable. Its reference is taken from the pool.
     refcnt_ptr<Variable> var;
-    this->m_pool.extract_variable(var);
-    if(!var)
-      var = ::rocket::make_refcnt<Variable>();
+    Variable* qvar;
+    auto& gstat = this->m_stats.generations.at(gen_hint);
+    if(this->m_pool.extract_variable(qvar)) {
+      var.reset(qvar);
+      gstat.pool_hits ++;
+    }
+    else {
+      var.reset(new(this->m_arena) Variable());
+      gstat.pool_misses ++;
+    }
 
-    // Track it.
+    // Track it. The generation owns another reference.
     size_t gen = gMax - gen_hint;
-    this->m_tracked.at(gen).insert(var.get(), var);
+    this->m_tracked.at(gen).insert(var.get(), var.get());
+    var->add_reference();
     this->m_counts[gen] += 1;
     return var;
   }
@@ -160,14 +464,27 @@ size_t
 Garbage_Collector::
 collect_variables(GC_Generation gen_limit)
   {
-    // Collect all variables up to generation `gen_limit`.
+    // Collect all variables up to generation `gen_limit`. Recursive requests
+    // are ignored, and are not counted as pauses.
+    const bool recursive = this->m_recur > 0;
+
+    // A full collection of the oldest generation supersedes an incremental
+    // pass, which must not be cancelled by a recursive request from inside
+    // one of its slices.
+    if(!recursive && (gen_limit >= gMax))
+      this->do_cancel_incremental();
+
+    const int64_t start_ns = do_monotonic_now_ns();
     size_t nvars = 0;
     for(uint32_t gen = 0;  (gen <= gMax) && (gen <= gen_limit);  ++gen)
-      nvars += this->do_collect_generation(gen);
+      nvars += this->do_collect_generation(gen, false);
+
+    if(!recursive)
+      do_record_pause(this->m_stats, start_ns);
 
     // Clear cached variables.
     // Return the number of variables that have been collected.
-    this->m_pool.clear();
+    do_release_variables(this->m_pool, false);
     return nvars;
   }
 
@@ -180,7 +497,6 @@ finalize() noexcept
       ASTERIA_TERMINATE(("Garbage collector not finalizable while in use"));
 
     size_t nvars = 0;
-    refcnt_ptr<Variable> var;
 
     this->m_staged.clear();
     this->m_temp_1.clear();
@@ -190,15 +506,20 @@ finalize() noexcept
     for(size_t gen = 0;  gen <= gMax;  ++gen)
       nvars += this->m_tracked.at(gMax-gen).size();
 
+    // Wipe out variables from an incremental pass.
+    nvars += this->m_slice.size() + this->m_visited.size();
+    do_release_variables(this->m_slice, true);
+    do_release_variables(this->m_visited, true);
+    this->m_incr = false;
+
     // Wipe out all tracked variables. Indirect ones may be foreign so they
     // must not be wiped.
     for(size_t gen = 0;  gen <= gMax;  ++gen)
-      while(this->m_tracked.at(gMax-gen).extract_variable(var))
-        var->uninitialize();
+      do_release_variables(this->m_tracked.at(gMax-gen), true);
 
     // Clear cached variables.
     nvars += this->m_pool.size();
-    this->m_pool.clear();
+    do_release_variables(this->m_pool, false);
     return nvars;
   }
 
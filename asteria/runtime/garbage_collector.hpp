@@ -6,15 +6,50 @@
 
 #include "../fwd.hpp"
 #include "../llds/variable_hashmap.hpp"
+#include "../llds/variable_arena.hpp"
 #include <array>
 namespace asteria {
 
+struct GC_Statistics
+  {
+    struct Generation
+      {
+        uint64_t collections;  // number of collections
+        uint64_t scanned;  // number of variables that have been traced
+        uint64_t freed;  // number of variables that have been collected
+        uint64_t promoted;  // number of variables moved to the next generation
+        uint64_t pool_hits;  // number of variables reused from the pool
+        uint64_t pool_misses;  // number of variables allocated anew
+        uint64_t time_ns;  // total duration of collections of this generation
+      };
+
+    // This is indexed by `GC_Generation`.
+    ::std::array<Generation, gc_generation_oldest+1> generations;
+
+    // Each call to `create_variable()` that collects any generation or takes
+    // a step of an incremental collection, and each call to
+    // `collect_variables()`, counts as one pause, no matter how many
+    // generations it collects. The element `k` of `pause_histogram` is the
+    // number of pauses whose duration `d` satisfies `2^k <= d / 1us <
+    // 2^(k+1)`, except that the first element also counts shorter pauses,
+    // and the last element also counts longer pauses.
+    uint64_t pause_count;
+    uint64_t pause_total_ns;
+    uint64_t pause_max_ns;
+    ::std::array<uint64_t, 32> pause_histogram;
+  };
+
 class Garbage_Collector
   :
     public rcfwd<Garbage_Collector>
   {
   private:
     int m_recur = 0;
+    Variable_Arena m_arena;  // storage of variables; destroyed last
+
+    // Each variable in `m_pool`, `m_tracked`, `m_slice` or `m_visited` is
+    // owned by that table, which holds one reference to it. Other tables
+    // are only used during collection and own nothing.
     Variable_HashMap m_pool;  // key is a pointer to the `Variable` itself
 
     static constexpr uint32_t gMax = gc_generation_oldest;
@@ -27,14 +62,40 @@ class Garbage_Collector
     Variable_HashMap m_temp_2;
     Variable_HashMap m_unreach;
 
+    size_t m_budget = 0;  // zero disables incremental collection
+    bool m_incr = false;  // an incremental pass is in progress
+    Variable_HashMap m_slice;  // oldest variables being checked in this step
+    Variable_HashMap m_visited;  // oldest variables checked in this pass
+
+    GC_Statistics m_stats = { };
+
+    GC_Policy m_policy = gc_policy_fixed;
+    double m_target = 0.05;  // fraction of time spent in collection
+    ::std::array<GC_Statistics::Generation, gMax+1> m_adapt_stats = { };
+    ::std::array<int64_t, gMax+1> m_adapt_time = { };  // thread CPU time
+    ::std::array<int64_t, gMax+1> m_adapt_cpu_ns = { };  // spent in collection
+
   public:
     // Creates an empty garbage collector.
     Garbage_Collector() noexcept;
 
   private:
+    size_t
+    do_collect_tracked(Variable_HashMap& tracked, uint32_t gen, bool local);
+
+    inline
+    size_t
+    do_collect_generation(uint32_t gen, bool local);
+
     inline
     size_t
-    do_collect_generation(uint32_t gen);
+    do_collect_slice();
+
+    void
+    do_cancel_incremental();
+
+    void
+    do_adapt_threshold(uint32_t gen);
 
   public:
     Garbage_Collector(const Garbage_Collector&) = delete;
@@ -52,15 +113,59 @@ class Garbage_Collector
 
     size_t
     count_tracked_variables(GC_Generation gen) const
-      { return this->m_tracked.at(gMax-gen).size();  }
+      {
+        size_t count = this->m_tracked.at(gMax-gen).size();
+        if(gen == gMax)
+          count += this->m_slice.size() + this->m_visited.size();
+        return count;
+      }
+
+    // With the adaptive policy, after each automatic collection, the threshold
+    // of the generation is scaled so the time spent in collection approaches
+    // `target` of the CPU time of the current thread. The threshold of the
+    // oldest generation is also kept above a quarter of its surviving
+    // variables.
+    GC_Policy
+    get_policy() const noexcept
+      { return this->m_policy;  }
+
+    double
+    get_target_overhead() const noexcept
+      { return this->m_target;  }
+
+    void
+    set_policy(GC_Policy policy, double target = 0.05);
+
+    // Incremental collection is enabled if the budget is non-zero. In this
+    // mode, each generation is collected without tracing into variables that
+    // it does not contain. The oldest generation is checked in slices of at
+    // most `budget` variables, one slice per call to `create_variable()`,
+    // which bounds the time that each call may take.
+    size_t
+    get_incremental_budget() const noexcept
+      { return this->m_budget;  }
+
+    void
+    set_incremental_budget(size_t budget) noexcept;
+
+    bool
+    is_incremental_pass_active() const noexcept
+      { return this->m_incr;  }
+
+    const GC_Statistics&
+    get_statistics() const noexcept
+      { return this->m_stats;  }
+
+    void
+    clear_statistics() noexcept
+      { this->m_stats = { };  }
 
     size_t
     count_pooled_variables() const noexcept
       { return this->m_pool.size();  }
 
     void
-    clear_pooled_variables() noexcept
-      { this->m_pool.clear();  }
+    clear_pooled_variables() noexcept;
 
     // These functions manage dynamic memory by managing variables. Variables
     // that are not created with `create_variable()` are 'foreign' and will never
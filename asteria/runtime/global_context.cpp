@@ -6,6 +6,7 @@
 #include "garbage_collector.hpp"
 #include "random_engine.hpp"
 #include "module_loader.hpp"
+#include "regex_cache.hpp"
 #include "abstract_hooks.hpp"
 #include "../library/version.hpp"
 #include "../library/gc.hpp"
@@ -74,9 +75,11 @@ struct Module_Comparator
 Global_Context::
 Global_Context(API_Version api_version_req)
   :
+    m_acct(new ::rocket::xmemacct()),
     m_gcoll(::rocket::make_refcnt<Garbage_Collector>()),
     m_prng(::rocket::make_refcnt<Random_Engine>()),
-    m_ldrlk(::rocket::make_refcnt<Module_Loader>())
+    m_ldrlk(::rocket::make_refcnt<Module_Loader>()),
+    m_rcache(::rocket::make_refcnt<Regex_Cache>())
   {
     // Get the range of modules to initialize.
     // This also determines the maximum version number of the library, which
@@ -97,7 +100,21 @@ Global_Context(API_Version api_version_req)
         mod.init(r.first->second.mut_object(), eptr[-1].api_version);
       });
 
-    this->do_mut_named_reference(nullptr, &"std").set_temporary(move(ostd));
+    this->m_std = move(ostd);
+    this->do_mut_named_reference(nullptr, &"std").set_temporary(this->m_std);
+  }
+
+Global_Context::
+Global_Context(const V_object& std_lib)
+  :
+    m_acct(new ::rocket::xmemacct()),
+    m_gcoll(::rocket::make_refcnt<Garbage_Collector>()),
+    m_prng(::rocket::make_refcnt<Random_Engine>()),
+    m_ldrlk(::rocket::make_refcnt<Module_Loader>()),
+    m_rcache(::rocket::make_refcnt<Regex_Cache>()),
+    m_std(std_lib)
+  {
+    this->do_mut_named_reference(nullptr, &"std").set_temporary(this->m_std);
   }
 
 Global_Context::
@@ -109,6 +126,16 @@ Global_Context::
     unerase_cast<Garbage_Collector*>(this->m_gcoll.get())->finalize();
   }
 
+void
+Global_Context::
+reset()
+  {
+    // Variables that are still referenced by someone else are not destroyed.
+    this->do_clear_named_references();
+    unerase_cast<Garbage_Collector*>(this->m_gcoll.get())->collect_variables();
+    this->do_mut_named_reference(nullptr, &"std").set_temporary(this->m_std);
+  }
+
 API_Version
 Global_Context::
 max_api_version() const noexcept
@@ -7,6 +7,7 @@
 #include "../fwd.hpp"
 #include "abstract_context.hpp"
 #include "../recursion_sentry.hpp"
+#include "../../rocket/xmemory.hpp"
 namespace asteria {
 
 class Global_Context
@@ -14,17 +15,25 @@ class Global_Context
     public Abstract_Context
   {
   private:
+    unique_ptr<::rocket::xmemacct, ::rocket::xmemacct_releaser> m_acct;
     Recursion_Sentry m_sentry;
     rcfwd_ptr<Abstract_Hooks> m_qhooks;
     rcfwd_ptr<Garbage_Collector> m_gcoll;
     rcfwd_ptr<Random_Engine> m_prng;
     rcfwd_ptr<Module_Loader> m_ldrlk;
+    rcfwd_ptr<Regex_Cache> m_rcache;
+    V_object m_std;
 
   public:
     // Creates a global context, with the standard library initialized according
     // to `api_version_req`.
     explicit Global_Context(API_Version api_version_req = api_version_latest);
 
+    // Creates a global context, with a standard library that has been created
+    // by another global context. Library functions are immutable, so they can
+    // be shared by global contexts on different threads.
+    explicit Global_Context(const V_object& std_lib);
+
   protected:
     bool
     do_is_analytic() const noexcept override
@@ -39,6 +48,18 @@ class Global_Context
     Global_Context& operator=(const Global_Context&) & = delete;
     ~Global_Context();
 
+    // Gets the standard library, which can be passed to the constructor of
+    // another global context.
+    const V_object&
+    std_library() const noexcept
+      { return this->m_std;  }
+
+    // Destroys all global references, collects variables that have become
+    // unreachable, then restores the standard library. Hooks and cached
+    // modules are kept.
+    void
+    reset();
+
     // This provides stack overflow protection.
     Recursion_Sentry
     copy_recursion_sentry() const
@@ -52,6 +73,34 @@ class Global_Context
     set_recursion_base(const void* base) noexcept
       { this->m_sentry.set_base(base);  }
 
+    // These provide memory accounting. Storage of strings, arrays and objects
+    // that is allocated during calls to functions with this context is charged
+    // to it. If the limit is exceeded, an exception is thrown, which scripts
+    // can catch. A limit of zero means no limit.
+    ::rocket::xmemacct*
+    memory_accountant() const noexcept
+      { return this->m_acct.get();  }
+
+    size_t
+    memory_usage() const noexcept
+      { return this->m_acct->usage();  }
+
+    size_t
+    peak_memory_usage() const noexcept
+      { return this->m_acct->peak_usage();  }
+
+    void
+    reset_peak_memory_usage() noexcept
+      { this->m_acct->reset_peak_usage();  }
+
+    size_t
+    memory_limit() const noexcept
+      { return this->m_acct->limit();  }
+
+    void
+    set_memory_limit(size_t limit) noexcept
+      { this->m_acct->set_limit(limit);  }
+
     // Get the maximum API version that is supported when this library is built.
     // N.B. This function must not be inlined for this reason.
     ROCKET_CONST
@@ -85,6 +134,11 @@ class Global_Context
     refcnt_ptr<Module_Loader>
     module_loader() const noexcept
       { return unerase_pointer_cast<Module_Loader>(this->m_ldrlk);  }
+
+    ASTERIA_INCOMPLET(Regex_Cache)
+    refcnt_ptr<Regex_Cache>
+    regex_cache() const noexcept
+      { return unerase_pointer_cast<Regex_Cache>(this->m_rcache);  }
   };
 
 }  // namespace asteria
@@ -15,13 +15,21 @@
 namespace asteria {
 
 Instantiated_Function::
-Instantiated_Function(const Source_Location& xsloc, const cow_string& xfunc,
-                      const cow_vector<phsh_string>& xparams, const cow_vector<AIR_Node>& code)
+Instantiated_Function(const Compiler_Options& opts, const Source_Location& xsloc,
+                      const cow_string& xfunc, const cow_vector<phsh_string>& xparams,
+                      const cow_vector<AIR_Node>& code, const cow_vector<AIR_Node>* source_opt)
   :
-    m_sloc(xsloc), m_func(xfunc), m_params(xparams)
+    m_opts(opts), m_sloc(xsloc), m_func(xfunc), m_params(xparams)
   {
     ::rocket::for_each(code, [&](const AIR_Node& node) { node.solidify(this->m_rod);  });
     this->m_rod.finalize();
+
+    // Keep the code only if it may be needed later. The source is shared with
+    // the node that defines this function, so keeping it is cheap.
+    if(source_opt) {
+      this->m_code = *source_opt;
+      this->m_serializable = true;
+    }
   }
 
 Instantiated_Function::
@@ -41,6 +49,8 @@ Instantiated_Function::
 collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
   {
     this->m_rod.collect_variables(staged, temp);
+
+    ::rocket::for_each(this->m_code, [&](const AIR_Node& node) { node.collect_variables(staged, temp);  });
   }
 
 Reference&
@@ -13,14 +13,18 @@ class Instantiated_Function
     public Abstract_Function
   {
   private:
+    Compiler_Options m_opts;
     Source_Location m_sloc;
     cow_string m_func;
     cow_vector<phsh_string> m_params;
+    cow_vector<AIR_Node> m_code;  // empty if not needed
+    bool m_serializable = false;
     AVM_Rod m_rod;
 
   public:
-    Instantiated_Function(const Source_Location& xsloc, const cow_string& xfunc,
-                          const cow_vector<phsh_string>& xparams, const cow_vector<AIR_Node>& code);
+    Instantiated_Function(const Compiler_Options& opts, const Source_Location& xsloc,
+                          const cow_string& xfunc, const cow_vector<phsh_string>& xparams,
+                          const cow_vector<AIR_Node>& code, const cow_vector<AIR_Node>* source_opt);
 
   public:
     Instantiated_Function(const Instantiated_Function&) = delete;
@@ -35,10 +39,20 @@ class Instantiated_Function
     func() const noexcept
       { return this->m_func;  }
 
+    const Compiler_Options&
+    opts() const noexcept
+      { return this->m_opts;  }
+
     const cow_vector<phsh_string>&
     params() const noexcept
       { return this->m_params;  }
 
+    // This is the code that this function can be serialized from. It is null
+    // if the function refers to variables of enclosing functions.
+    const cow_vector<AIR_Node>*
+    source_opt() const noexcept
+      { return this->m_serializable ? &(this->m_code) : nullptr;  }
+
     tinyfmt&
     describe(tinyfmt& fmt) const override;
 
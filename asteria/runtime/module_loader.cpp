@@ -9,6 +9,28 @@
 #include <sys/file.h>  // ::flock()
 #include <unistd.h>  // ::fstat()
 namespace asteria {
+namespace {
+
+bool
+do_stat_stream(struct ::stat& info, const ::rocket::tinybuf_file& file)
+  {
+    if(!file.get_handle())
+      return false;
+
+    return ::fstat(::fileno(file.get_handle()), &info) == 0;
+  }
+
+int64_t
+do_get_mtime_ns(const struct ::stat& info)
+  {
+#ifdef __USE_XOPEN2K8
+    return (int64_t) info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#else
+    return (int64_t) info.st_mtime * 1000000000;
+#endif
+  }
+
+}  // namespace
 
 Module_Loader::
 Module_Loader() noexcept
@@ -64,4 +86,49 @@ do_unlock_stream(locked_pair* qstrm) noexcept
     ROCKET_ASSERT(count == 1);
   }
 
+cow_function
+Module_Loader::
+get_cached_module_opt(cow_stringR path, const Compiler_Options& opts, const Unique_Stream& strm)
+  {
+    auto qmod = this->m_cache.mut_ptr(path);
+    if(!qmod)
+      return nullptr;
+
+    // Check whether the file has been modified since it was compiled. If the
+    // file can't be examined, assume it has.
+    struct ::stat info;
+    if(!do_stat_stream(info, strm.get())
+       || (qmod->dev != (uint64_t) info.st_dev) || (qmod->ino != (uint64_t) info.st_ino)
+       || (qmod->size != (int64_t) info.st_size) || (qmod->mtime_ns != do_get_mtime_ns(info))
+       || (::memcmp(&(qmod->opts), &opts, sizeof(opts)) != 0)) {
+      // Discard the outdated module.
+      this->m_cache.erase(path);
+      return nullptr;
+    }
+
+    return qmod->func;
+  }
+
+void
+Module_Loader::
+set_cached_module(cow_stringR path, const Compiler_Options& opts, const Unique_Stream& strm,
+                  const cow_function& func)
+  {
+    // If the file can't be examined, don't cache it.
+    struct ::stat info;
+    if(!do_stat_stream(info, strm.get())) {
+      this->m_cache.erase(path);
+      return;
+    }
+
+    cached_module mod;
+    mod.dev = (uint64_t) info.st_dev;
+    mod.ino = (uint64_t) info.st_ino;
+    mod.size = (int64_t) info.st_size;
+    mod.mtime_ns = do_get_mtime_ns(info);
+    mod.opts = opts;
+    mod.func = func;
+    this->m_cache.insert_or_assign(path, move(mod));
+  }
+
 }  // namespace asteria
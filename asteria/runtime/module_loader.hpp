@@ -19,6 +19,21 @@ class Module_Loader
     cow_dictionary<::rocket::tinybuf_file> m_strms;
     using locked_pair = pair<const phsh_string, ::rocket::tinybuf_file>;
 
+    struct cached_module
+      {
+        // file identity
+        uint64_t dev;
+        uint64_t ino;
+        int64_t size;
+        int64_t mtime_ns;
+
+        // compiled code
+        Compiler_Options opts;
+        cow_function func;
+      };
+
+    cow_dictionary<cached_module> m_cache;  // key is canonical path
+
   public:
     // Creates an empty module loader.
     Module_Loader() noexcept;
@@ -34,6 +49,27 @@ class Module_Loader
     Module_Loader(const Module_Loader&) = delete;
     Module_Loader& operator=(const Module_Loader&) & = delete;
     ~Module_Loader();
+
+    // These functions manage compiled modules. A module is identified by its
+    // canonical path. A cached module is returned only if it was compiled with
+    // the same options, and the file that `strm` denotes is identical to the one
+    // from which it was compiled, otherwise it is discarded and a null function
+    // is returned. The caller shall keep `strm` locked.
+    cow_function
+    get_cached_module_opt(cow_stringR path, const Compiler_Options& opts,
+                          const Unique_Stream& strm);
+
+    void
+    set_cached_module(cow_stringR path, const Compiler_Options& opts,
+                      const Unique_Stream& strm, const cow_function& func);
+
+    size_t
+    count_cached_modules() const noexcept
+      { return this->m_cache.size();  }
+
+    void
+    clear_cached_modules() noexcept
+      { this->m_cache.clear();  }
   };
 
 class Module_Loader::Unique_Stream
@@ -31,9 +31,9 @@ collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
   {
     this->m_value.collect_variables(staged, temp);
 
-    if(auto var = unerase_pointer_cast<Variable>(this->m_var))
+    if(auto var = unerase_cast<Variable*>(this->m_var.get()))
       if(staged.insert(&(this->m_var), var))
-        temp.insert(var.get(), var);
+        temp.insert(var, var);
   }
 
 const Value&
@@ -182,6 +182,13 @@ class Reference
     clear_modifiers() noexcept
       { this->m_mods.clear();  }
 
+    const Reference_Modifier&
+    last_modifier() const noexcept
+      {
+        ROCKET_ASSERT(!this->m_mods.empty());
+        return this->m_mods.back();
+      }
+
     template<typename xModifier,
     ROCKET_ENABLE_IF(::std::is_constructible<Reference_Modifier, xModifier&&>::value)>
     Reference&
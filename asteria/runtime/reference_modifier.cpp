@@ -47,7 +47,10 @@ apply_read_opt(const Value& parent) const
 
           const auto& obj = parent.as_object();
 
-          return obj.ptr(altr.key);
+          size_t hint = altr.hint;
+          auto qval = obj.ptr(hint, altr.key);
+          altr.hint = static_cast<uint32_t>(hint);
+          return qval;
         }
 
       case index_array_head:
@@ -150,7 +153,10 @@ apply_write_opt(Value& parent) const
 
           auto& obj = parent.mut_object();
 
-          return obj.mut_ptr(altr.key);
+          size_t hint = altr.hint;
+          auto qval = obj.mut_ptr(hint, altr.key);
+          altr.hint = static_cast<uint32_t>(hint);
+          return qval;
         }
 
       case index_array_head:
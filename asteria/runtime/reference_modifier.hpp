@@ -18,6 +18,11 @@ class Reference_Modifier
     struct S_object_key
       {
         phsh_string key;
+
+        // This is the bucket index where `key` was found last time, which
+        // is checked first by the next lookup. It is written back without
+        // synchronization, as a rod is only executed by one thread at a time.
+        mutable uint32_t hint = 0;
       };
 
     struct S_array_head
@@ -96,6 +101,10 @@ class Reference_Modifier
     as_object_key() const
       { return this->m_stor.as<S_object_key>().key; }
 
+    uint32_t
+    object_key_hint() const
+      { return this->m_stor.as<S_object_key>().hint;  }
+
     bool
     is_array_head() const noexcept
       { return this->m_stor.index() == index_array_head;  }
@@ -0,0 +1,96 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "regex_cache.hpp"
+#include "../utils.hpp"
+namespace asteria {
+
+Regex_Cache::
+Regex_Cache() noexcept
+  {
+  }
+
+Regex_Cache::
+~Regex_Cache()
+  {
+  }
+
+void
+Regex_Cache::
+do_evict(size_t count) noexcept
+  {
+    while(count != 0) {
+      // Find the least recently used entry, and replace it with the last one.
+      size_t k = 0;
+      for(size_t t = 1;  t < this->m_cache.size();  ++t)
+        if(this->m_cache[t].stamp < this->m_cache[k].stamp)
+          k = t;
+
+      if(k != this->m_cache.size() - 1)
+        ::std::swap(this->m_cache.mut(k), this->m_cache.mut_back());
+      this->m_cache.pop_back();
+      count --;
+    }
+  }
+
+refcnt_ptr<Abstract_Opaque>
+Regex_Cache::
+get_cached_regex_opt(cow_stringR patt, uint32_t opts)
+  {
+    if(this->m_cache.empty())
+      return nullptr;
+
+    // Compare hash values first, which are cheap.
+    uint32_t hval = cow_string::hash()(patt);
+    for(size_t t = 0;  t != this->m_cache.size();  ++t) {
+      const auto& entry = this->m_cache[t];
+      if((entry.hval != hval) || (entry.opts != opts) || (entry.patt != patt))
+        continue;
+
+      this->m_cache.mut(t).stamp = ++ this->m_stamp;
+      return entry.code;
+    }
+    return nullptr;
+  }
+
+void
+Regex_Cache::
+set_cached_regex(cow_stringR patt, uint32_t opts, const refcnt_ptr<Abstract_Opaque>& code)
+  {
+    if(this->m_max_size == 0)
+      return;
+
+    uint32_t hval = cow_string::hash()(patt);
+    for(size_t t = 0;  t != this->m_cache.size();  ++t) {
+      auto& entry = this->m_cache.mut(t);
+      if((entry.hval != hval) || (entry.opts != opts) || (entry.patt != patt))
+        continue;
+
+      entry.stamp = ++ this->m_stamp;
+      entry.code = code;
+      return;
+    }
+
+    if(this->m_cache.size() >= this->m_max_size)
+      this->do_evict(this->m_cache.size() - this->m_max_size + 1);
+
+    auto& entry = this->m_cache.emplace_back();
+    entry.hval = hval;
+    entry.opts = opts;
+    entry.patt = patt;
+    entry.stamp = ++ this->m_stamp;
+    entry.code = code;
+  }
+
+void
+Regex_Cache::
+set_max_size(size_t max_size) noexcept
+  {
+    if(this->m_cache.size() > max_size)
+      this->do_evict(this->m_cache.size() - max_size);
+
+    this->m_max_size = max_size;
+  }
+
+}  // namespace asteria
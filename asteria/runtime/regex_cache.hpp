@@ -0,0 +1,71 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_REGEX_CACHE_
+#define ASTERIA_RUNTIME_REGEX_CACHE_
+
+#include "../fwd.hpp"
+namespace asteria {
+
+class Regex_Cache
+  :
+    public rcfwd<Regex_Cache>
+  {
+  private:
+    struct cached_regex
+      {
+        // key
+        uint32_t hval;
+        uint32_t opts;
+        cow_string patt;
+
+        // compiled code
+        uint64_t stamp;
+        refcnt_ptr<Abstract_Opaque> code;
+      };
+
+    cow_vector<cached_regex> m_cache;
+    size_t m_max_size = 64;
+    uint64_t m_stamp = 0;
+
+  public:
+    // Creates an empty cache.
+    Regex_Cache() noexcept;
+
+  private:
+    void
+    do_evict(size_t count) noexcept;
+
+  public:
+    Regex_Cache(const Regex_Cache&) = delete;
+    Regex_Cache& operator=(const Regex_Cache&) & = delete;
+    ~Regex_Cache();
+
+    // These functions manage compiled regular expressions. An expression is
+    // identified by its pattern and options. The cache is small, so entries
+    // are searched linearly. When it is full, the least recently used entry
+    // is discarded. A maximum size of zero disables caching.
+    refcnt_ptr<Abstract_Opaque>
+    get_cached_regex_opt(cow_stringR patt, uint32_t opts);
+
+    void
+    set_cached_regex(cow_stringR patt, uint32_t opts, const refcnt_ptr<Abstract_Opaque>& code);
+
+    size_t
+    count_cached_regexes() const noexcept
+      { return this->m_cache.size();  }
+
+    void
+    clear_cached_regexes() noexcept
+      { this->m_cache.clear();  }
+
+    size_t
+    max_size() const noexcept
+      { return this->m_max_size;  }
+
+    void
+    set_max_size(size_t max_size) noexcept;
+  };
+
+}  // namespace asteria
+#endif
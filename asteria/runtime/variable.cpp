@@ -3,9 +3,39 @@
 
 #include "../xprecompiled.hpp"
 #include "variable.hpp"
+#include "../llds/variable_arena.hpp"
 #include "../utils.hpp"
 namespace asteria {
 
+void*
+Variable::
+operator new(size_t size)
+  {
+    return Variable_Arena::allocate_unpooled(size);
+  }
+
+void*
+Variable::
+operator new(size_t size, Variable_Arena& arena)
+  {
+    ROCKET_ASSERT(size == sizeof(Variable));
+    return arena.allocate();
+  }
+
+void
+Variable::
+operator delete(void* ptr) noexcept
+  {
+    Variable_Arena::deallocate(ptr);
+  }
+
+void
+Variable::
+operator delete(void* ptr, Variable_Arena& /*arena*/) noexcept
+  {
+    Variable_Arena::deallocate(ptr);
+  }
+
 Variable::
 ~Variable()
   {
@@ -23,6 +23,24 @@ class Variable
       { }
 
   public:
+    // Storage of a variable comes from either the heap or an arena. Either
+    // way, it is returned by the `operator delete` below.
+    static
+    void*
+    operator new(size_t size);
+
+    static
+    void*
+    operator new(size_t size, Variable_Arena& arena);
+
+    static
+    void
+    operator delete(void* ptr) noexcept;
+
+    static
+    void
+    operator delete(void* ptr, Variable_Arena& arena) noexcept;
+
     Variable(const Variable&) = delete;
     Variable& operator=(const Variable&) & = delete;
     ~Variable();
@@ -0,0 +1,138 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "xprecompiled.hpp"
+#include "script_pool.hpp"
+#include "runtime/air_optimizer.hpp"
+#include "llds/reference_stack.hpp"
+#include "utils.hpp"
+namespace asteria {
+
+Script_Pool::
+Script_Pool(const Simple_Script& script, size_t size)
+  :
+    m_opts(script.code_options()), m_name(script.name()), m_code(script.code())
+  {
+    if(!script)
+      ASTERIA_THROW(("No script loaded"));
+
+    if(!script.has_code())
+      ASTERIA_THROW(("Code of script not kept"));
+
+    if(size == 0)
+      ASTERIA_THROW(("Script pool size must be positive"));
+
+    cow_vector<phsh_string> script_params;
+    script_params.emplace_back(&"...");
+    Source_Location script_sloc(this->m_name, 0, 0);
+
+    // All contexts share the standard library of `script`, so the library is
+    // not initialized again. Each context gets a function of its own, as
+    // execution state is recorded in it, but the code is shared.
+    this->m_slots.reserve(size);
+    this->m_free.reserve(size);
+
+    for(size_t k = 0;  k < size;  ++k) {
+      auto slot = ::rocket::make_unique<Slot>(script.global().std_library());
+
+      AIR_Optimizer optmz(this->m_opts);
+      optmz.rebind(nullptr, script_params, this->m_code);
+      slot->func = optmz.create_function(script_sloc, &"[file scope]");
+
+      this->m_free.emplace_back(slot.get());
+      this->m_slots.emplace_back(move(slot));
+    }
+  }
+
+Script_Pool::
+~Script_Pool()
+  {
+    ROCKET_ASSERT(this->m_free.size() == this->m_slots.size());
+  }
+
+void
+Script_Pool::
+do_release(Slot* slot) noexcept
+  try {
+    // Reset the context before returning it, so the next worker does not pay
+    // for this.
+    slot->global.reset();
+
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    this->m_free.emplace_back(slot);
+    this->m_avail.notify_one();
+  }
+  catch(exception& stdex) {
+    // The context cannot be returned without memory, which should never
+    // happen, as `m_free` has enough capacity.
+    ASTERIA_TERMINATE((
+        "Could not return global context to pool: $1"),
+        stdex);
+  }
+
+size_t
+Script_Pool::
+count_available() const noexcept
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    return this->m_free.size();
+  }
+
+Script_Pool::Lease
+Script_Pool::
+checkout()
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    while(this->m_free.empty())
+      this->m_avail.wait(lock);
+
+    auto slot = this->m_free.back();
+    this->m_free.pop_back();
+    return Lease(this, slot);
+  }
+
+Script_Pool::Lease
+Script_Pool::
+try_checkout()
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    if(this->m_free.empty())
+      return Lease();
+
+    auto slot = this->m_free.back();
+    this->m_free.pop_back();
+    return Lease(this, slot);
+  }
+
+Reference
+Script_Pool::Lease::
+execute(Reference_Stack&& stack)
+  {
+    ROCKET_ASSERT_MSG(this->m_slot, "no context");
+    Reference self;
+    this->m_slot->global.set_recursion_base(&self);
+    auto func = this->m_slot->func;
+    func.invoke(self, this->m_slot->global, move(stack));
+    ::fflush(nullptr);
+    return self;
+  }
+
+Reference
+Script_Pool::Lease::
+execute(cow_vector<Value>&& args)
+  {
+    Reference_Stack stack;
+    for(auto it = args.mut_begin();  it != args.end(); ++it)
+      stack.push().set_temporary(move(*it));
+    return this->execute(move(stack));
+  }
+
+Reference
+Script_Pool::Lease::
+execute()
+  {
+    Reference_Stack stack;
+    return this->execute(move(stack));
+  }
+
+}  // namespace asteria
@@ -0,0 +1,165 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_SCRIPT_POOL_
+#define ASTERIA_SCRIPT_POOL_
+
+#include "fwd.hpp"
+#include "simple_script.hpp"
+#include "../rocket/mutex.hpp"
+#include "../rocket/condition_variable.hpp"
+namespace asteria {
+
+class Script_Pool
+  {
+  public:
+    class Lease;  // RAII wrapper
+
+  private:
+    struct Slot
+      {
+        Global_Context global;
+        cow_function func;
+
+        explicit Slot(const V_object& std_lib)
+          :
+            global(std_lib)
+          { }
+      };
+
+    Compiler_Options m_opts;
+    cow_string m_name;
+    cow_vector<AIR_Node> m_code;
+    cow_vector<unique_ptr<Slot>> m_slots;
+
+    mutable ::rocket::mutex m_mutex;
+    ::rocket::condition_variable m_avail;
+    cow_vector<Slot*> m_free;
+
+  public:
+    // Creates a pool of `size` global contexts for the script that has been
+    // loaded into `script`. All contexts share the same compiled code and the
+    // same standard library, which are immutable. Each context has its own
+    // garbage collector, random engine and module loader. The code of `script`
+    // must have been kept with `Simple_Script::set_keep_code(true)`.
+    Script_Pool(const Simple_Script& script, size_t size);
+
+  private:
+    void
+    do_release(Slot* slot) noexcept;
+
+  public:
+    Script_Pool(const Script_Pool&) = delete;
+    Script_Pool& operator=(const Script_Pool&) & = delete;
+    ~Script_Pool();
+
+    const Compiler_Options&
+    options() const noexcept
+      { return this->m_opts;  }
+
+    const cow_string&
+    name() const noexcept
+      { return this->m_name;  }
+
+    size_t
+    size() const noexcept
+      { return this->m_slots.size();  }
+
+    size_t
+    count_available() const noexcept;
+
+    // Checks out a global context, waiting until one becomes available. The
+    // context is reset and returned to the pool when the lease is destroyed,
+    // so the pool shall outlive all leases. These functions are thread-safe.
+    Lease
+    checkout();
+
+    // Checks out a global context if one is available, otherwise returns a
+    // null lease.
+    Lease
+    try_checkout();
+  };
+
+class Script_Pool::Lease
+  {
+  private:
+    friend class Script_Pool;
+
+    Script_Pool* m_pool = nullptr;
+    Slot* m_slot = nullptr;
+
+    constexpr Lease(Script_Pool* pool, Slot* slot) noexcept
+      :
+        m_pool(pool), m_slot(slot)
+      { }
+
+  public:
+    constexpr Lease() noexcept = default;
+
+    Lease(Lease&& other) noexcept
+      {
+        this->swap(other);
+      }
+
+    Lease&
+    operator=(Lease&& other) & noexcept
+      {
+        this->swap(other);
+        return *this;
+      }
+
+    Lease&
+    swap(Lease& other) noexcept
+      {
+        ::std::swap(this->m_pool, other.m_pool);
+        ::std::swap(this->m_slot, other.m_slot);
+        return *this;
+      }
+
+  public:
+    ~Lease()
+      {
+        this->reset();
+      }
+
+    explicit operator bool() const noexcept
+      { return this->m_slot != nullptr;  }
+
+    Global_Context&
+    mut_global() const noexcept
+      {
+        ROCKET_ASSERT_MSG(this->m_slot, "no context");
+        return this->m_slot->global;
+      }
+
+    // Resets the context and returns it to the pool.
+    Lease&
+    reset() noexcept
+      {
+        if(this->m_slot == nullptr)
+          return *this;
+
+        auto old_pool = ::rocket::exchange(this->m_pool);
+        auto old_slot = ::rocket::exchange(this->m_slot);
+        old_pool->do_release(old_slot);
+        return *this;
+      }
+
+    // Execute the script in the leased context.
+    Reference
+    execute(Reference_Stack&& stack);
+
+    Reference
+    execute(cow_vector<Value>&& args);
+
+    Reference
+    execute();
+  };
+
+inline
+void
+swap(Script_Pool::Lease& lhs, Script_Pool::Lease& rhs) noexcept
+  { lhs.swap(rhs);  }
+
+}  // namespace asteria
+#endif
@@ -7,10 +7,14 @@
 #include "compiler/statement_sequence.hpp"
 #include "compiler/expression_unit.hpp"
 #include "runtime/air_optimizer.hpp"
+#include "runtime/air_serializer.hpp"
 #include "runtime/variable.hpp"
 #include "runtime/garbage_collector.hpp"
 #include "llds/reference_stack.hpp"
 #include "utils.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 namespace asteria {
 
 refcnt_ptr<Variable>
@@ -47,6 +51,17 @@ erase_global_variable(phsh_stringR name) noexcept
     return this->m_global.erase_named_reference(name, nullptr);
   }
 
+void
+Simple_Script::
+do_set_code(const Compiler_Options& opts, const cow_vector<AIR_Node>& code)
+  {
+    this->m_has_code = this->m_keep_code;
+    this->m_code_opts = opts;
+    this->m_code.clear();
+    if(this->m_keep_code)
+      this->m_code = code;
+  }
+
 void
 Simple_Script::
 reload(cow_stringR name, Statement_Sequence&& stmtq)
@@ -60,6 +75,8 @@ reload(cow_stringR name, Statement_Sequence&& stmtq)
 
     Source_Location script_sloc(name, 0, 0);
     this->m_func = optmz.create_function(script_sloc, &"[file scope]");
+    this->m_name = name;
+    this->do_set_code(this->m_opts, optmz.get_code());
   }
 
 void
@@ -119,9 +136,105 @@ reload_file(cow_stringR path)
     ::rocket::tinybuf_file cbuf;
     cow_string abs_path = get_real_path(path);
     cbuf.open(abs_path.c_str(), tinybuf::open_read);
+
+    // If this file has been precompiled, load it as such. This does not
+    // alter the file position, and fails harmlessly on pipes.
+    char magic[8];
+    ::ssize_t nread = ::pread(::fileno(cbuf.get_handle()), magic, sizeof(magic), 0);
+    if((nread > 0) && AIR_Serializer::is_compiled(magic, static_cast<size_t>(nread)))
+      return this->reload_compiled(abs_path);
+
     this->reload(abs_path, 1, move(cbuf));
   }
 
+cow_string
+Simple_Script::
+save_compiled() const
+  {
+    if(!this->m_func)
+      ASTERIA_THROW(("No script loaded"));
+
+    if(!this->m_has_code)
+      ASTERIA_THROW(("Code of script not kept"));
+
+    cow_vector<phsh_string> script_params;
+    script_params.emplace_back(&"...");
+
+    AIR_Serializer ser;
+    return ser.save(this->m_code_opts, this->m_name, script_params, this->m_code);
+  }
+
+void
+Simple_Script::
+save_compiled(cow_stringR path) const
+  {
+    cow_string bytes = this->save_compiled();
+
+    ::rocket::tinybuf_file obuf;
+    obuf.open(path.safe_c_str(), tinybuf::open_write | tinybuf::open_create
+                                 | tinybuf::open_truncate | tinybuf::open_binary);
+    obuf.putn(bytes.data(), bytes.size());
+    obuf.flush();
+  }
+
+void
+Simple_Script::
+reload_compiled(const void* data, size_t size)
+  {
+    Compiler_Options opts;
+    cow_string name;
+    cow_vector<phsh_string> script_params;
+    cow_vector<AIR_Node> code;
+
+    AIR_Serializer ser;
+    ser.load(opts, name, script_params, code, data, size);
+
+    // Instantiate the function.
+    AIR_Optimizer optmz(opts);
+    optmz.rebind(nullptr, script_params, code);
+
+    Source_Location script_sloc(name, 0, 0);
+    this->m_func = optmz.create_function(script_sloc, &"[file scope]");
+    this->m_name = move(name);
+    this->do_set_code(opts, code);
+  }
+
+void
+Simple_Script::
+reload_compiled(cow_stringR path)
+  {
+    ::rocket::unique_posix_fd fd(::open(path.safe_c_str(), O_RDONLY));
+    if(!fd)
+      ASTERIA_THROW((
+          "Could not open script file '$1'",
+          "[`open()` failed: ${errno:full}]"),
+          path);
+
+    struct ::stat info;
+    if(::fstat(fd, &info) != 0)
+      ASTERIA_THROW((
+          "Could not get properties of script file '$1'",
+          "[`fstat()` failed: ${errno:full}]"),
+          path);
+
+    // Map the file into memory. The data are copied during validation, so
+    // the mapping can be discarded afterwards.
+    size_t size = static_cast<size_t>(info.st_size);
+    if(size == 0)
+      return this->reload_compiled(nullptr, 0);
+
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data == MAP_FAILED)
+      ASTERIA_THROW((
+          "Could not map script file '$1'",
+          "[`mmap()` failed: ${errno:full}]"),
+          path);
+
+    const auto guard = ::rocket::make_unique_handle(data,
+                             [size](void* ptr) { ::munmap(ptr, size);  });
+    this->reload_compiled(data, size);
+  }
+
 Reference
 Simple_Script::
 execute(Reference_Stack&& stack)
@@ -7,6 +7,7 @@
 #include "fwd.hpp"
 #include "runtime/global_context.hpp"
 #include "runtime/reference.hpp"
+#include "runtime/air_node.hpp"
 #include "llds/reference_stack.hpp"
 namespace asteria {
 
@@ -15,8 +16,20 @@ class Simple_Script
   private:
     Compiler_Options m_opts;
     Global_Context m_global;
+    cow_string m_name;
     cow_function m_func;
 
+    // The code of the script is only kept if it has been requested before
+    // the script is loaded, together with the options it was compiled with.
+    bool m_keep_code = false;
+    bool m_has_code = false;
+    Compiler_Options m_code_opts;
+    cow_vector<AIR_Node> m_code;
+
+  private:
+    void
+    do_set_code(const Compiler_Options& opts, const cow_vector<AIR_Node>& code);
+
   public:
     explicit Simple_Script(API_Version version = api_version_latest)
       :
@@ -40,6 +53,33 @@ class Simple_Script
     mut_global() noexcept
       { return this->m_global;  }
 
+    const cow_string&
+    name() const noexcept
+      { return this->m_name;  }
+
+    // Keep the code of scripts that are loaded later, which is required by
+    // `save_compiled()` and `Script_Pool`. This is off by default, as the
+    // code is not needed for execution.
+    bool
+    keeps_code() const noexcept
+      { return this->m_keep_code;  }
+
+    void
+    set_keep_code(bool keep) noexcept
+      { this->m_keep_code = keep;  }
+
+    bool
+    has_code() const noexcept
+      { return this->m_has_code;  }
+
+    const Compiler_Options&
+    code_options() const noexcept
+      { return this->m_code_opts;  }
+
+    const cow_vector<AIR_Node>&
+    code() const noexcept
+      { return this->m_code;  }
+
     explicit operator bool() const noexcept
       { return static_cast<bool>(this->m_func);  }
 
@@ -48,7 +88,11 @@ class Simple_Script
 
     void
     reset() noexcept
-      { this->m_func.reset();  }
+      {
+        this->m_func.reset();
+        this->m_has_code = false;
+        this->m_code.clear();
+      }
 
     // Manage global variables in the bundled context.
     refcnt_ptr<Variable>
@@ -86,6 +130,25 @@ class Simple_Script
     void
     reload_file(cow_stringR path);
 
+    // Save the script that has been loaded in a binary form, which can be
+    // loaded again without lexing or parsing. `reload_file()` recognizes
+    // such files automatically. The script must have been loaded with
+    // `set_keep_code(true)`.
+    cow_string
+    save_compiled() const;
+
+    void
+    save_compiled(cow_stringR path) const;
+
+    // Load a script that has been saved by `save_compiled()`. The options
+    // that are stored in it are used for the script, but do not replace
+    // `options()`.
+    void
+    reload_compiled(const void* data, size_t size);
+
+    void
+    reload_compiled(cow_stringR path);
+
     // Execute the script that has been loaded.
     Reference
     execute(Reference_Stack&& stack);
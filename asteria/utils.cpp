@@ -6,6 +6,15 @@
 #include <time.h>  // ::timespec, ::clock_gettime(), ::localtime()
 #include <unistd.h>  // ::write
 #include <openssl/rand.h>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#  include <tmmintrin.h>
+#endif
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
 namespace asteria {
 namespace {
 
@@ -45,6 +54,147 @@ const char s_char_escapes[][5] =
     "\\xF8", "\\xF9", "\\xFA", "\\xFB", "\\xFC", "\\xFD", "\\xFE", "\\xFF",
   };
 
+#ifdef __SSSE3__
+// These tables implement the UTF-8 validation algorithm by John Keiser and
+// Daniel Lemire. Each pair of adjacent bytes is looked up by the high and low
+// nibbles of the first byte and the high nibble of the second; an error is
+// indicated by a bit that is set in all three results.
+constexpr uint8_t u8v_too_short      = 0x01;  // 11______ 0_______ or 11______ 11______
+constexpr uint8_t u8v_too_long       = 0x02;  // 0_______ 10______
+constexpr uint8_t u8v_overlong_3     = 0x04;  // 11100000 100_____
+constexpr uint8_t u8v_too_large      = 0x08;  // 11110100 1001____ and above
+constexpr uint8_t u8v_surrogate      = 0x10;  // 11101101 101_____
+constexpr uint8_t u8v_overlong_2     = 0x20;  // 1100000_ 10______
+constexpr uint8_t u8v_too_large_1000 = 0x40;  // 11110101 1000____ and above
+constexpr uint8_t u8v_overlong_4     = 0x40;  // 11110000 1000____
+constexpr uint8_t u8v_two_conts      = 0x80;  // 10______ 10______
+constexpr uint8_t u8v_carry          = u8v_too_short | u8v_too_long | u8v_two_conts;
+
+alignas(16) constexpr uint8_t s_u8v_byte_1_high[16] =
+  {
+    u8v_too_long, u8v_too_long, u8v_too_long, u8v_too_long,
+    u8v_too_long, u8v_too_long, u8v_too_long, u8v_too_long,
+    u8v_two_conts, u8v_two_conts, u8v_two_conts, u8v_two_conts,
+    u8v_too_short | u8v_overlong_2,
+    u8v_too_short,
+    u8v_too_short | u8v_overlong_3 | u8v_surrogate,
+    u8v_too_short | u8v_too_large | u8v_too_large_1000 | u8v_overlong_4,
+  };
+
+alignas(16) constexpr uint8_t s_u8v_byte_1_low[16] =
+  {
+    u8v_carry | u8v_overlong_3 | u8v_overlong_2 | u8v_overlong_4,
+    u8v_carry | u8v_overlong_2,
+    u8v_carry,
+    u8v_carry,
+    u8v_carry | u8v_too_large,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000 | u8v_surrogate,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+    u8v_carry | u8v_too_large | u8v_too_large_1000,
+  };
+
+alignas(16) constexpr uint8_t s_u8v_byte_2_high[16] =
+  {
+    u8v_too_short, u8v_too_short, u8v_too_short, u8v_too_short,
+    u8v_too_short, u8v_too_short, u8v_too_short, u8v_too_short,
+    u8v_too_long | u8v_overlong_2 | u8v_two_conts | u8v_overlong_3 | u8v_too_large_1000
+      | u8v_overlong_4,
+    u8v_too_long | u8v_overlong_2 | u8v_two_conts | u8v_overlong_3 | u8v_too_large,
+    u8v_too_long | u8v_overlong_2 | u8v_two_conts | u8v_surrogate | u8v_too_large,
+    u8v_too_long | u8v_overlong_2 | u8v_two_conts | u8v_surrogate | u8v_too_large,
+    u8v_too_short, u8v_too_short, u8v_too_short, u8v_too_short,
+  };
+
+inline
+__m128i
+do_u8v_load_table_128(const uint8_t (&table)[16]) noexcept
+  {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+  }
+
+inline
+__m128i
+do_u8v_check_128(__m128i input, __m128i prev_input) noexcept
+  {
+    // Check pairs of adjacent bytes.
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i err = _mm_shuffle_epi8(do_u8v_load_table_128(s_u8v_byte_1_high),
+                                   _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    err = _mm_and_si128(err, _mm_shuffle_epi8(do_u8v_load_table_128(s_u8v_byte_1_low),
+                                              _mm_and_si128(prev1, nibble)));
+    err = _mm_and_si128(err, _mm_shuffle_epi8(do_u8v_load_table_128(s_u8v_byte_2_high),
+                                              _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+    // The third and fourth bytes of a sequence must be continuation bytes,
+    // where `u8v_two_conts` has been set above, and others must not.
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0x60)),
+                                  _mm_subs_epu8(prev3, _mm_set1_epi8(0x70)));
+    return _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(-0x80)), err);
+  }
+
+inline
+__m128i
+do_u8v_incomplete_128(__m128i input) noexcept
+  {
+    // Check whether a sequence is truncated at the end of this block.
+    return _mm_subs_epu8(input, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                              -1, -1, -1, -1, -1, -0x11, -0x21, -0x41));
+  }
+#endif
+
+#ifdef __AVX2__
+inline
+__m256i
+do_u8v_load_table_256(const uint8_t (&table)[16]) noexcept
+  {
+    return _mm256_broadcastsi128_si256(do_u8v_load_table_128(table));
+  }
+
+inline
+__m256i
+do_u8v_check_256(__m256i input, __m256i prev_input) noexcept
+  {
+    // This is the same as `do_u8v_check_128()`, but `alignr` works within
+    // 128-bit lanes, so bytes have to be taken from the other lane.
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i cross = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, cross, 15);
+    __m256i err = _mm256_shuffle_epi8(do_u8v_load_table_256(s_u8v_byte_1_high),
+                                      _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    err = _mm256_and_si256(err, _mm256_shuffle_epi8(do_u8v_load_table_256(s_u8v_byte_1_low),
+                                                    _mm256_and_si256(prev1, nibble)));
+    err = _mm256_and_si256(err, _mm256_shuffle_epi8(do_u8v_load_table_256(s_u8v_byte_2_high),
+                                                    _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+    __m256i prev2 = _mm256_alignr_epi8(input, cross, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, cross, 13);
+    __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60)),
+                                     _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70)));
+    return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(-0x80)), err);
+  }
+
+inline
+__m256i
+do_u8v_incomplete_256(__m256i input) noexcept
+  {
+    return _mm256_subs_epu8(input, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                                    -1, -1, -1, -1, -1, -1, -1, -1,
+                                                    -1, -1, -1, -1, -1, -1, -1, -1,
+                                                    -1, -1, -1, -1, -1, -0x11, -0x21, -0x41));
+  }
+#endif
+
 }  // namespace
 
 ptrdiff_t
@@ -287,7 +437,7 @@ utf8_decode(char32_t& cp, const char*& pos, size_t avail) noexcept
 
     // Accumulate trailing code units.
     for(size_t i = 1;  i < u8len;  ++i)
-      if(((uint8_t) *pos >= 0x80U) || ((uint8_t) *pos < 0xC0U))
+      if(((uint8_t) *pos >= 0x80U) && ((uint8_t) *pos < 0xC0U))
         cp = (cp << 6) | ((uint8_t) *(pos++) & 0x3FU);
       else
         return false;
@@ -317,6 +467,100 @@ utf8_decode(char32_t& cp, cow_stringR text, size_t& offset)
     return true;
   }
 
+bool
+utf8_validate(const char* str, size_t len) noexcept
+  {
+    const char* pos = str;
+    const char* end = str + len;
+
+#ifdef __AVX2__
+    // Validate the string in blocks. The last block is padded with zeroes.
+    __m256i err = _mm256_setzero_si256();
+    __m256i prev = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    alignas(32) char last[32];
+
+    while(pos != end) {
+      __m256i t;
+      if(end - pos >= 32) {
+        t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        pos += 32;
+      }
+      else {
+        ::memset(last, 0, sizeof(last));
+        ::memcpy(last, pos, (size_t) (end - pos));
+        t = _mm256_load_si256(reinterpret_cast<const __m256i*>(last));
+        pos = end;
+      }
+
+      // ASCII characters can only complete a preceding sequence.
+      if(_mm256_movemask_epi8(t) == 0)
+        err = _mm256_or_si256(err, prev_incomplete);
+      else {
+        err = _mm256_or_si256(err, do_u8v_check_256(t, prev));
+        prev_incomplete = do_u8v_incomplete_256(t);
+      }
+      prev = t;
+    }
+
+    err = _mm256_or_si256(err, prev_incomplete);
+    return _mm256_testz_si256(err, err);
+#elif defined __SSSE3__
+    __m128i err = _mm_setzero_si128();
+    __m128i prev = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    alignas(16) char last[16];
+
+    while(pos != end) {
+      __m128i t;
+      if(end - pos >= 16) {
+        t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        pos += 16;
+      }
+      else {
+        ::memset(last, 0, sizeof(last));
+        ::memcpy(last, pos, (size_t) (end - pos));
+        t = _mm_load_si128(reinterpret_cast<const __m128i*>(last));
+        pos = end;
+      }
+
+      if(_mm_movemask_epi8(t) == 0)
+        err = _mm_or_si128(err, prev_incomplete);
+      else {
+        err = _mm_or_si128(err, do_u8v_check_128(t, prev));
+        prev_incomplete = do_u8v_incomplete_128(t);
+      }
+      prev = t;
+    }
+
+    err = _mm_or_si128(err, prev_incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) == 0xFFFF;
+#else
+    char32_t cp;
+    while(pos != end) {
+      // Skip ASCII characters in blocks.
+#  ifdef __SSE2__
+      while(end - pos >= 16) {
+        __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        uint32_t bits = (uint32_t) _mm_movemask_epi8(t);
+        if(bits != 0) {
+          pos += ROCKET_TZCNT32(bits);
+          break;
+        }
+        pos += 16;
+      }
+#  endif
+      if(pos == end)
+        break;
+
+      // Decode other characters one by one.
+      if(!utf8_decode(cp, pos, (size_t) (end - pos)))
+        return false;
+    }
+    return true;
+#endif
+  }
+
 bool
 utf16_encode(char16_t*& pos, char32_t cp) noexcept
   {
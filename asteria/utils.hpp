@@ -221,6 +221,12 @@ utf8_decode(char32_t& cp, const char*& pos, size_t avail) noexcept;
 bool
 utf8_decode(char32_t& cp, cow_stringR text, size_t& offset);
 
+// Checks whether a string is valid UTF-8. Where SSSE3 or AVX2 is available,
+// the string is checked in blocks of 16 or 32 bytes; otherwise runs of ASCII
+// characters are skipped in blocks.
+bool
+utf8_validate(const char* str, size_t len) noexcept;
+
 // UTF-16 conversion functions
 bool
 utf16_encode(char16_t*& pos, char32_t cp) noexcept;
@@ -146,10 +146,9 @@ do_collect_variables_slow(Variable_HashMap& staged, Variable_HashMap& temp) cons
     // Expand recursion by hand with a stack.
     auto qval = this;
     cow_vector<Rbr_Element> stack;
-    const refcnt_ptr<Variable> null_var_ptr;
 
   r:
-    if(staged.insert(qval, null_var_ptr))  // mark once
+    if(staged.insert(qval, nullptr))  // mark once
       switch(qval->m_stor.index())
         {
         case type_opaque:
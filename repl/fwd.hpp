@@ -34,6 +34,7 @@ extern unsigned long repl_index;  // snippet index
 extern cow_string repl_source;  // snippet text
 extern cow_string repl_file;  // name of snippet
 extern cow_vector<Value> repl_args;  // script arguments
+extern cow_string repl_compile;  // output of compiled script
 extern cow_string repl_heredoc;  // heredoc terminator
 
 extern cow_string repl_last_source;
@@ -57,11 +58,15 @@ exit_printf(Exit_Status stat, const char* fmt, ...) noexcept;
 void
 install_verbose_hooks();
 
-// This function is defined in 'single.cpp'.
+// These functions are defined in 'single.cpp'.
 [[noreturn]]
 void
 load_and_execute_single_noreturn();
 
+[[noreturn]]
+void
+load_and_compile_single_noreturn();
+
 // These functions are defined in 'commands.cpp'.
 void
 prepare_repl_commands();
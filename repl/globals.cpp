@@ -89,6 +89,7 @@ unsigned long repl_index;  // snippet index
 cow_string repl_source;  // snippet text
 cow_string repl_file;  // name of snippet
 cow_vector<Value> repl_args;  // script arguments
+cow_string repl_compile;  // output of compiled script
 cow_string repl_heredoc;  // heredoc terminator
 
 cow_string repl_last_source;
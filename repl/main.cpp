@@ -7,6 +7,7 @@
 #include <locale.h>  // setlocale()
 #include <unistd.h>  // isatty()
 #include <signal.h>  // sigaction()
+#include <getopt.h>  // getopt_long()
 namespace {
 using namespace ::asteria;
 
@@ -24,6 +25,7 @@ do_print_help_and_exit(const char* self)
 """""""""""""""""""""""""""""""""""""""""""""""""""""""""" R"'''''''''''''''(
 Usage: %s [OPTIONS] [[--] FILE [ARGUMENTS]...]
 
+  -c OUT  compile FILE and write it to OUT then exit [`--compile=OUT`]
   -h      show help message then exit
   -I      suppress interactive mode [default = auto]
   -i      force interactive mode [default = auto]
@@ -39,6 +41,9 @@ If neither `-I` or `-i` is set, interactive mode is enabled when no FILE is
 specified and standard input is connected to a terminal; otherwise it is
 disabled. Be advised, specifying `-` explicitly disables interactive mode.
 
+A script that has been compiled with `-c` is loaded without being lexed or
+parsed again. Such files are recognized automatically when given as FILE.
+
 When running in non-interactive mode, characters are read from FILE, then
 compiled and executed. If the script returns an integer, it is truncated to
 an 8-bit unsigned integer and then used as the exit status. If the script
@@ -93,7 +98,7 @@ do_parse_command_line(int argc, char** argv)
     opt<bool> verbose, interactive;
     opt<int> optimize;
 
-    opt<cow_string> path;
+    opt<cow_string> path, compile;
     cow_vector<Value> args;
 
     // Check for some common options before calling `getopt()`.
@@ -106,10 +111,20 @@ do_parse_command_line(int argc, char** argv)
     }
 
     // Parse command-line options.
+    static const struct ::option long_opts[] =
+      {
+        { "compile", required_argument, nullptr, 'c' },
+        { nullptr, 0, nullptr, 0 },
+      };
+
     int ch;
-    while((ch = ::getopt(argc, argv, "+hIiO::Vv")) != -1) {
+    while((ch = ::getopt_long(argc, argv, "+c:hIiO::Vv", long_opts, nullptr)) != -1) {
       // Identify a single option.
       switch(ch) {
+        case 'c':
+          compile = V_string(optarg);
+          continue;
+
         case 'h':
           help = true;
           continue;
@@ -166,8 +181,11 @@ do_parse_command_line(int argc, char** argv)
       repl_verbose = *verbose;
 
     // Interactive mode is enabled when no FILE is given (not even `-`) and
-    // standard input is connected to a terminal.
-    if(interactive)
+    // standard input is connected to a terminal. Compilation never enters
+    // interactive mode.
+    if(compile)
+      repl_interactive = false;
+    else if(interactive)
       repl_interactive = *interactive;
     else
       repl_interactive = !path && ::isatty(STDIN_FILENO);
@@ -182,6 +200,7 @@ do_parse_command_line(int argc, char** argv)
     // These arguments are always overwritten.
     repl_file = path.move_value_or(&"-");
     repl_args = move(args);
+    repl_compile = compile.move_value_or(&"");
   }
 
 }  // namespace
@@ -212,6 +231,10 @@ main(int argc, char** argv)
       ::sigaction(SIGCONT, &sigact, nullptr);
     }
 
+    // If compilation is requested, read the script, save it, then exit.
+    if(!repl_compile.empty())
+      load_and_compile_single_noreturn();
+
     // In non-interactive mode, read the script, execute it, then exit.
     if(!repl_interactive)
       load_and_execute_single_noreturn();
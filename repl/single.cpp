@@ -35,4 +35,25 @@ load_and_execute_single_noreturn()
     quick_exit(exit_non_integer);
   }
 
+void
+load_and_compile_single_noreturn()
+  {
+    // Load and parse the script, then write it in binary form.
+    try {
+      repl_script.set_keep_code(true);
+      if(repl_file == "-")
+        repl_script.reload_stdin();
+      else
+        repl_script.reload_file(repl_file);
+
+      repl_script.save_compiled(repl_compile);
+    }
+    catch(exception& stdex) {
+      // Print the error and exit.
+      exit_printf(exit_compiler_error, "! exception: %s", stdex.what());
+    }
+
+    quick_exit();
+  }
+
 }  // namespace asteria
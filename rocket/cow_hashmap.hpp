@@ -9,6 +9,7 @@
 #include "xthrow.hpp"
 #include "reference_counter.hpp"
 #include "xallocator.hpp"
+#include "xmemory.hpp"
 #include "xhashtable.hpp"
 #include <tuple>  // std::forward_as_tuple()
 #include <cstdio>  // std::sprintf()
@@ -398,7 +399,7 @@ class cow_hashmap
         if(!this->m_sth.unique())
           return this->do_deallocate();
 
-        this->m_sth.erase_range_unchecked(0, this->size());
+        this->m_sth.erase_range_unchecked(0, this->bucket_count());
         return *this;
       }
 
@@ -732,6 +733,28 @@ class cow_hashmap
         return ::std::addressof(this->do_mut_buckets()[tpos]->second);
       }
 
+    // N.B. This is a non-standard extension.
+    // `hint` is a bucket index where `ykey` is likely to be found, such as one
+    // from a previous call. It is updated to the actual position.
+    template<typename ykeyT>
+    const mapped_type*
+    ptr(size_type& hint, const ykeyT& ykey) const
+      {
+        if(!this->m_sth.find_hinted(hint, ykey))
+          return nullptr;
+        return ::std::addressof(this->do_buckets()[hint]->second);
+      }
+
+    // N.B. This is a non-standard extension.
+    template<typename ykeyT>
+    mapped_type*
+    mut_ptr(size_type& hint, const ykeyT& ykey)
+      {
+        if(!this->m_sth.find_hinted(hint, ykey))
+          return nullptr;
+        return ::std::addressof(this->do_mut_buckets()[hint]->second);
+      }
+
     // N.B. This function is a non-standard extension.
     template<typename inputT,
     ROCKET_ENABLE_IF(is_input_iterator<inputT>::value)>
@@ -9,6 +9,7 @@
 #include "xthrow.hpp"
 #include "reference_counter.hpp"
 #include "xallocator.hpp"
+#include "xmemory.hpp"
 namespace rocket {
 
 // Differences from `std::vector`:
@@ -11,6 +11,7 @@ using unknown_function  = void (...);
 struct storage_header
   {
     mutable reference_counter<int> nref = { };
+    xmemacct* acct = nullptr;
 
     unknown_function* dtor;
     size_t nelem;
@@ -387,6 +388,16 @@ class storage_handle
     storage_handle& operator=(const storage_handle&) = delete;
 
   private:
+    static constexpr
+    size_t
+    do_charged_size(size_type nblk) noexcept
+      {
+        // Elements are allocated separately, so charge them in advance for
+        // the full capacity.
+        return nblk * sizeof(storage)
+               + storage::max_nbkt_for_nblk(nblk) / max_load_factor_reciprocal * sizeof(value_type);
+      }
+
 #ifdef __cpp_constexpr_dynamic_alloc
     constexpr
 #endif
@@ -409,9 +420,11 @@ class storage_handle
     do_destroy_storage(storage_pointer qstor) noexcept
       {
         auto nblk = qstor->nblk;
+        auto acct = qstor->acct;
         storage_allocator st_alloc(*qstor);
         noadl::destroy(noadl::unfancy(qstor));
         allocator_traits<storage_allocator>::deallocate(st_alloc, qstor, nblk);
+        xmemacct::refund(acct, do_charged_size(nblk));
       }
 
   public:
@@ -566,6 +579,26 @@ class storage_handle
         return qbkt;
       }
 
+    template<typename ykeyT>
+    const bucket_type*
+    find_hinted(size_type& tpos, const ykeyT& ykey) const noexcept
+      {
+        auto qstor = this->m_qstor;
+        if(!qstor)
+          return nullptr;
+
+        // Check the bucket that was found last time. If it still contains an
+        // equivalent key, there is no need to calculate its hash value.
+        if(tpos < qstor->bucket_count()) {
+          auto qbkt = qstor->bkts + tpos;
+          if(*qbkt && this->as_key_equal() ((*qbkt)->first, ykey))
+            return qbkt;
+        }
+
+        // Perform a full lookup otherwise. `tpos` is updated for next time.
+        return this->find(tpos, ykey);
+      }
+
     template<typename ykeyT, typename... paramsT>
     bool
     keyed_try_emplace(size_type& tpos, const ykeyT& ykey, paramsT&&... params)
@@ -626,11 +659,13 @@ class storage_handle
 
         // Allocate an array of `storage` large enough for a header + `cap` instances of `bucket_type`.
         auto nblk = sth.m_qstor->nblk;
+        xmemacct_charge charge(do_charged_size(nblk));
         storage_allocator st_alloc(this->as_allocator());
         auto qstor = allocator_traits<storage_allocator>::allocate(st_alloc, nblk);
         noadl::construct(noadl::unfancy(qstor),
                  reinterpret_cast<void (*)(...)>(this->do_destroy_storage),
                  this->as_allocator(), this->as_hasher(), nblk);
+        qstor->acct = charge.release();
 
         // Copy/move old elements from `sth`.
         try {
@@ -658,11 +693,13 @@ class storage_handle
 
         // Allocate an array of `storage` large enough for a header + `cap` instances of `bucket_type`.
         auto nblk = storage::min_nblk_for_nbkt(cap * max_load_factor_reciprocal);
+        xmemacct_charge charge(do_charged_size(nblk));
         storage_allocator st_alloc(this->as_allocator());
         auto qstor = allocator_traits<storage_allocator>::allocate(st_alloc, nblk);
         noadl::construct(noadl::unfancy(qstor),
                  reinterpret_cast<void (*)(...)>(this->do_destroy_storage),
                  this->as_allocator(), this->as_hasher(), nblk);
+        qstor->acct = charge.release();
 
         // Copy/move old elements from `sth`.
         try {
@@ -9,6 +9,7 @@ namespace details_cow_string {
 struct storage_header
   {
     mutable reference_counter<int> nref = { };
+    xmemacct* acct = nullptr;
   };
 
 template<typename allocT>
@@ -129,9 +130,11 @@ class storage_handle
     do_destroy_storage(storage_pointer qstor) noexcept
       {
         auto nblk = qstor->nblk;
+        auto acct = qstor->acct;
         storage_allocator st_alloc(*qstor);
         noadl::destroy(noadl::unfancy(qstor));
         allocator_traits<storage_allocator>::deallocate(st_alloc, qstor, nblk);
+        xmemacct::refund(acct, nblk * sizeof(storage));
       }
 
   public:
@@ -238,9 +241,11 @@ class storage_handle
         // Allocate an array of `storage` large enough for a header + `cap`
         // instances of `value_type`.
         auto nblk = storage::min_nblk_for_nchar(cap);
+        xmemacct_charge charge(nblk * sizeof(storage));
         storage_allocator st_alloc(this->as_allocator());
         auto qstor = allocator_traits<storage_allocator>::allocate(st_alloc, nblk);
         noadl::construct(noadl::unfancy(qstor), this->as_allocator(), nblk);
+        qstor->acct = charge.release();
 
         // Add a null character anyway. The user still has to keep track of it
         // if the storage is not fully utilized.
@@ -11,6 +11,7 @@ using unknown_function  = void (...);
 struct storage_header
   {
     mutable reference_counter<int> nref = { };
+    xmemacct* acct = nullptr;
 
     unknown_function* dtor;
     size_t nelem;
@@ -254,9 +255,11 @@ class storage_handle
     do_destroy_storage(storage_pointer qstor) noexcept
       {
         auto nblk = qstor->nblk;
+        auto acct = qstor->acct;
         storage_allocator st_alloc(*qstor);
         noadl::destroy(noadl::unfancy(qstor));
         allocator_traits<storage_allocator>::deallocate(st_alloc, qstor, nblk);
+        xmemacct::refund(acct, nblk * sizeof(storage));
       }
 
   public:
@@ -413,11 +416,13 @@ class storage_handle
 
         // Allocate an array of `storage` large enough for a header + `cap` instances of `value_type`.
         auto nblk = sth.m_qstor->nblk;
+        xmemacct_charge charge(nblk * sizeof(storage));
         storage_allocator st_alloc(this->as_allocator());
         auto qstor = allocator_traits<storage_allocator>::allocate(st_alloc, nblk);
         noadl::construct(noadl::unfancy(qstor),
                  reinterpret_cast<unknown_function*>(this->do_destroy_storage), len,
                  this->as_allocator(), nblk);
+        qstor->acct = charge.release();
 
         // Copy/move old elements from `sth`.
         try {
@@ -445,11 +450,13 @@ class storage_handle
 
         // Allocate an array of `storage` large enough for a header + `cap` instances of `value_type`.
         auto nblk = storage::min_nblk_for_nelem(cap);
+        xmemacct_charge charge(nblk * sizeof(storage));
         storage_allocator st_alloc(this->as_allocator());
         auto qstor = allocator_traits<storage_allocator>::allocate(st_alloc, nblk);
         noadl::construct(noadl::unfancy(qstor),
                  reinterpret_cast<unknown_function*>(this->do_destroy_storage), len,
                  this->as_allocator(), nblk);
+        qstor->acct = charge.release();
 
         // Copy/move old elements from `sth`.
         try {
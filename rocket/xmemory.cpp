@@ -3,6 +3,9 @@
 
 #include "xmemory.hpp"
 #include "atomic.hpp"
+#include "mutex.hpp"
+#include "xthrow.hpp"
+#include <pthread.h>
 namespace rocket {
 namespace {
 
@@ -12,16 +15,78 @@ struct free_block
     free_block* next;
   };
 
+// These are global pools, which are shared by all threads. Blocks are moved
+// between them and thread-local magazines in batches. `count` may be read
+// without locking `mtx`, as a hint.
 struct alignas(64) pool
   {
-    atomic_acq_rel<free_block*> head;
+    mutex mtx;
+    free_block* head;
+    atomic_relaxed<size_t> count;
   };
 
 pool s_pools[64];
 
+atomic_relaxed<uint64_t> s_stat_hits;
+atomic_relaxed<uint64_t> s_stat_misses;
+atomic_relaxed<int64_t> s_stat_bytes;
+
+// A magazine is a thread-local cache in front of a global pool. It holds at
+// most `mag_max_count` blocks and at most `mag_max_bytes` bytes. Blocks that
+// are larger than `mag_max_bytes` go to global pools directly.
+constexpr uint32_t mag_max_count = 64;
+constexpr uint32_t mag_max_bytes = 256 * 1024;
+
+// Counters are published to global ones after this number of operations.
+constexpr uint32_t stat_batch_size = 1024;
+
+struct magazine
+  {
+    free_block* head;
+    uint32_t count;
+  };
+
+enum : uint8_t
+  {
+    thread_cache_uninit  = 0,
+    thread_cache_alive   = 1,
+    thread_cache_dead    = 2,
+  };
+
+// This is trivially destructible, so it remains accessible during destruction
+// of other thread-local objects.
+struct thread_cache
+  {
+    magazine mags[64];
+    uint8_t state;
+    uint32_t pending_hits;
+    uint32_t pending_misses;
+    int64_t pending_bytes;
+  };
+
+thread_local thread_cache s_tcache;
+
+// This is the memory accountant of the current thread. In order to reduce
+// contention, bytes are charged in batches and reserved here, until they
+// are used by subsequent charges, or until another accountant is installed.
+struct acct_state
+  {
+    xmemacct* acct;
+    int64_t reserve;
+  };
+
+thread_local acct_state s_acct_state;
+
+constexpr int64_t acct_reserve_size = 64 * 1024;
+
+// Small allocations may exceed the limit by this much, so errors can be
+// handled when the limit has been reached.
+constexpr size_t acct_small_size = 4096;
+constexpr int64_t acct_min_headroom = 256 * 1024;
+
 inline
-pool&
-do_get_pool_for_size(size_t& size)
+int
+do_get_size_index(size_t& size)
   {
     int si = 5;
     uint64_t rsize64 = 1ULL << si;
@@ -34,7 +99,171 @@ do_get_pool_for_size(size_t& size)
 
     ROCKET_ASSERT(size <= rsize64);
     size = (size_t) rsize64;
-    return s_pools[si];
+    return si;
+  }
+
+inline
+uint32_t
+do_get_magazine_capacity(int si) noexcept
+  {
+    return (si > 31) ? 0 : min(mag_max_count, mag_max_bytes >> si);
+  }
+
+void
+do_publish_stats(thread_cache& tc) noexcept
+  {
+    if(tc.pending_hits != 0)
+      s_stat_hits.xadd(exchange(tc.pending_hits, 0U));
+
+    if(tc.pending_misses != 0)
+      s_stat_misses.xadd(exchange(tc.pending_misses, 0U));
+
+    if(tc.pending_bytes != 0)
+      s_stat_bytes.xadd(exchange(tc.pending_bytes, 0));
+  }
+
+void
+do_push_global(int si, free_block* head, free_block* tail, size_t count) noexcept
+  {
+    auto& p = s_pools[si];
+    mutex::unique_lock lock(p.mtx);
+    tail->next = p.head;
+    p.head = head;
+    p.count.store(p.count.load() + count);
+  }
+
+free_block*
+do_pop_global(int si, size_t max_count, size_t& count) noexcept
+  {
+    auto& p = s_pools[si];
+    if(p.count.load() == 0)
+      return nullptr;
+
+    mutex::unique_lock lock(p.mtx);
+    free_block* head = p.head;
+    if(!head)
+      return nullptr;
+
+    // Detach at most `max_count` blocks from the front.
+    free_block* tail = head;
+    count = 1;
+    while((count < max_count) && tail->next) {
+      tail = tail->next;
+      count ++;
+    }
+
+    p.head = tail->next;
+    p.count.store(p.count.load() - count);
+    tail->next = nullptr;
+    return head;
+  }
+
+void
+do_delete_list(free_block* b) noexcept
+  {
+    while(b != nullptr)
+      ::operator delete(exchange(b, b->next));
+  }
+
+void
+do_flush_magazine(thread_cache& tc, int si, uint32_t count) noexcept
+  {
+    auto& m = tc.mags[si];
+    ROCKET_ASSERT(count <= m.count);
+    if(count == 0)
+      return;
+
+    // Move `count` blocks from the front of the magazine into the pool. Bytes
+    // are still cached, so statistics don't change.
+    free_block* head = m.head;
+    free_block* tail = head;
+    for(uint32_t k = 1;  k != count;  ++k)
+      tail = tail->next;
+
+    m.head = tail->next;
+    m.count -= count;
+    do_push_global(si, head, tail, count);
+  }
+
+void
+do_clear_size_class(thread_cache* tc, int si) noexcept
+  {
+    free_block* b;
+    int64_t nbytes = 0;
+
+    if(tc) {
+      // Free blocks in the magazine of the calling thread.
+      auto& m = tc->mags[si];
+      nbytes += (int64_t) m.count << si;
+      m.count = 0;
+      do_delete_list(exchange(m.head, nullptr));
+    }
+
+    auto& p = s_pools[si];
+    mutex::unique_lock lock(p.mtx);
+    b = exchange(p.head, nullptr);
+    nbytes += (int64_t) p.count.load() << si;
+    p.count.store(0);
+    lock.unlock();
+
+    do_delete_list(b);
+    s_stat_bytes.xsub(nbytes);
+  }
+
+void
+do_flush_thread_cache(thread_cache& tc) noexcept
+  {
+    for(int si = 0;  si != 64;  ++si)
+      do_flush_magazine(tc, si, tc.mags[si].count);
+
+    do_publish_stats(tc);
+  }
+
+// Magazines are flushed by the destructor of a thread-specific key. A
+// `thread_local` object with a destructor would be registered with
+// `__cxa_thread_atexit()`, which may call `operator new`, and may recurse
+// into this allocator or break accounting of allocated memory.
+::pthread_once_t s_tcache_key_once = PTHREAD_ONCE_INIT;
+::pthread_key_t s_tcache_key;
+bool s_tcache_key_valid;
+
+void
+do_flush_thread_cache_on_exit(void* param) noexcept
+  {
+    // Return all cached blocks to global pools, as this thread is about to
+    // exit. Blocks that are freed after this point bypass magazines.
+    auto& tc = *(thread_cache*) param;
+    do_flush_thread_cache(tc);
+    tc.state = thread_cache_dead;
+  }
+
+void
+do_create_tcache_key() noexcept
+  {
+    s_tcache_key_valid = ::pthread_key_create(&s_tcache_key, do_flush_thread_cache_on_exit) == 0;
+  }
+
+inline
+thread_cache*
+do_get_thread_cache() noexcept
+  {
+    auto& tc = s_tcache;
+    if(ROCKET_EXPECT(tc.state == thread_cache_alive))
+      return &tc;
+
+    if(tc.state == thread_cache_dead)
+      return nullptr;
+
+    // Associate the cache with the key, so it will be flushed when this
+    // thread exits. If this fails, magazines are bypassed.
+    ::pthread_once(&s_tcache_key_once, do_create_tcache_key);
+    if(!s_tcache_key_valid || (::pthread_setspecific(s_tcache_key, &tc) != 0)) {
+      tc.state = thread_cache_dead;
+      return nullptr;
+    }
+
+    tc.state = thread_cache_alive;
+    return &tc;
   }
 
 }  // namespace
@@ -47,25 +276,49 @@ xmemalloc(xmeminfo& info, xmemopt opt)
       throw ::std::bad_alloc();
 
     free_block* b = nullptr;
-    auto& p = do_get_pool_for_size(rsize);
+    int si = do_get_size_index(rsize);
 
     if(opt == xmemopt_use_cache) {
-      // Get a block from the cache.
-      b = p.head.xchg(nullptr);
-      if(ROCKET_EXPECT(b != nullptr) && (b->next != nullptr))
-        b->next = p.head.xchg(b->next);
-    }
-    else if(opt == xmemopt_clear_cache) {
-      // Extract all blocks.
-      b = p.head.xchg(nullptr);
+      thread_cache* tc = do_get_thread_cache();
+      uint32_t cap = do_get_magazine_capacity(si);
+      size_t count;
+
+      if(tc && (cap != 0)) {
+        // Refill the magazine with half its capacity if it's empty.
+        auto& m = tc->mags[si];
+        if(m.count == 0) {
+          m.head = do_pop_global(si, (cap + 1) / 2, count);
+          if(m.head)
+            m.count = (uint32_t) count;
+        }
+
+        if(m.count != 0) {
+          b = m.head;
+          m.head = b->next;
+          m.count --;
+          tc->pending_bytes -= (int64_t) rsize;
+          tc->pending_hits ++;
+        }
+        else
+          tc->pending_misses ++;
+
+        if(tc->pending_hits + tc->pending_misses >= stat_batch_size)
+          do_publish_stats(*tc);
+      }
+      else {
+        // Get a block from the pool directly.
+        b = do_pop_global(si, 1, count);
+        if(b)
+          s_stat_bytes.xsub((int64_t) rsize);
+        (b ? s_stat_hits : s_stat_misses).xadd(1U);
+      }
     }
+    else if(opt == xmemopt_clear_cache)
+      do_clear_size_class(do_get_thread_cache(), si);
 
     // If the cache was empty, allocate a block from the system.
     if(b == nullptr)
       b = (free_block*) ::operator new(rsize);
-    else
-      while(b->next != nullptr)
-        ::operator delete(exchange(b->next, b->next->next));
 
 #ifdef ROCKET_DEBUG
     ::memset(b, 0xB5, rsize);
@@ -82,7 +335,7 @@ xmemfree(xmeminfo& info, xmemopt opt) noexcept
       return;
 
     size_t rsize = info.element_size * info.count;
-    auto& p = do_get_pool_for_size(rsize);
+    int si = do_get_size_index(rsize);
 
 #ifdef ROCKET_DEBUG
     ::memset(b, 0xCB, rsize);
@@ -91,32 +344,191 @@ xmemfree(xmeminfo& info, xmemopt opt) noexcept
     b->next = nullptr;
 
     if(opt == xmemopt_use_cache) {
-      // Put the block into the cache.
-      b->next = p.head.load();
-      while(!p.head.cmpxchg_weak(b->next, b));
-      b = nullptr;
-    }
-    else if(opt == xmemopt_clear_cache) {
-      // Append all blocks from the cache to `b`.
-      b->next = p.head.xchg(nullptr);
+      thread_cache* tc = do_get_thread_cache();
+      uint32_t cap = do_get_magazine_capacity(si);
+
+      if(tc && (cap != 0)) {
+        // Put the block into the magazine. If it overflows, move half of it
+        // into the pool.
+        auto& m = tc->mags[si];
+        b->next = m.head;
+        m.head = b;
+        m.count ++;
+        tc->pending_bytes += (int64_t) rsize;
+
+        if(m.count > cap)
+          do_flush_magazine(*tc, si, m.count / 2);
+      }
+      else {
+        // Put the block into the pool directly.
+        do_push_global(si, b, b, 1);
+        s_stat_bytes.xadd((int64_t) rsize);
+      }
+      return;
     }
+    else if(opt == xmemopt_clear_cache)
+      do_clear_size_class(do_get_thread_cache(), si);
 
-    // Return all blocks to the system.
-    while(b != nullptr)
-      ::operator delete(exchange(b, b->next));
+    // Return the block to the system.
+    ::operator delete(b);
   }
 
 void
 xmemclean() noexcept
   {
-    for(auto& p : s_pools) {
-      // Extract all blocks.
-      free_block* b = p.head.xchg(nullptr);
+    // Magazines of other threads are not accessible, but the calling thread
+    // can release its own.
+    thread_cache* tc = (s_tcache.state == thread_cache_alive) ? &s_tcache : nullptr;
+
+    for(int si = 0;  si != 64;  ++si)
+      do_clear_size_class(tc, si);
+
+    if(tc)
+      do_publish_stats(*tc);
+  }
+
+void
+xmemstat(xmemstats& stats) noexcept
+  {
+    // Counters of other threads are published in batches, so they may lag
+    // behind a little.
+    int64_t bytes = s_stat_bytes.load();
+    stats.hits = s_stat_hits.load();
+    stats.misses = s_stat_misses.load();
 
-      // Return all blocks to the system.
-      while(b != nullptr)
-        ::operator delete(exchange(b, b->next));
+    if(s_tcache.state == thread_cache_alive) {
+      stats.hits += s_tcache.pending_hits;
+      stats.misses += s_tcache.pending_misses;
+      bytes += s_tcache.pending_bytes;
     }
+
+    stats.bytes_cached = (uint64_t) max(bytes, (int64_t) 0);
+  }
+
+void
+xmemacct::
+do_throw_limit_exceeded(int64_t usage, size_t nbytes, int64_t limit)
+  {
+    sprintf_and_throw<length_error>(
+        "xmemacct: memory limit exceeded (usage `%lld`, request `%lld`, limit `%lld`)",
+        (long long) usage, (long long) nbytes, (long long) limit);
+  }
+
+bool
+xmemacct::
+do_try_charge(int64_t nbytes, bool small) noexcept
+  {
+    int64_t usage = (this->m_held.xadd(nbytes) & (owner_bias - 1)) + nbytes;
+    int64_t limit = this->m_limit.load();
+
+    if((limit != 0) && (usage > limit)) {
+      int64_t headroom = 0;
+      if(small)
+        headroom = max(limit / 8, acct_min_headroom);
+
+      if(usage > limit + headroom) {
+        // This accountant is still referenced by the caller, so it can't
+        // be destroyed here.
+        this->m_held.xsub(nbytes);
+        return false;
+      }
+    }
+
+    // Update the peak value.
+    int64_t peak = this->m_peak.load();
+    while((peak < usage) && !this->m_peak.cmpxchg_weak(peak, usage));
+    return true;
+  }
+
+void
+xmemacct::
+do_refund(int64_t nbytes) noexcept
+  {
+    // If this is the last reference, destroy the accountant.
+    int64_t old = this->m_held.xsub(nbytes);
+    ROCKET_ASSERT((old & (owner_bias - 1)) >= nbytes);
+    if(old == nbytes)
+      delete this;
+  }
+
+void
+xmemacct::
+do_refund_slow(xmemacct* acct, size_t nbytes) noexcept
+  {
+    auto& st = s_acct_state;
+    if(acct != st.acct)
+      return acct->do_refund((int64_t) nbytes);
+
+    // Keep the bytes for subsequent charges. If too many bytes have been
+    // reserved, return some.
+    st.reserve += (int64_t) nbytes;
+    if(st.reserve > acct_reserve_size * 2) {
+      acct->do_refund(st.reserve - acct_reserve_size);
+      st.reserve = acct_reserve_size;
+    }
+  }
+
+void
+xmemacct::
+release() noexcept
+  {
+    int64_t old = this->m_held.xsub(owner_bias);
+    ROCKET_ASSERT(old >= owner_bias);
+    if(old == owner_bias)
+      delete this;
+  }
+
+xmemacct*
+xmemacct::
+current() noexcept
+  {
+    return s_acct_state.acct;
+  }
+
+xmemacct*
+xmemacct::
+exchange_current(xmemacct* acct_opt) noexcept
+  {
+    auto& st = s_acct_state;
+    auto old = st.acct;
+    if(acct_opt == old)
+      return old;
+
+    // Return reserved bytes to the old accountant.
+    if(st.reserve != 0)
+      old->do_refund(exchange(st.reserve, 0));
+
+    st.acct = acct_opt;
+    return old;
+  }
+
+xmemacct*
+xmemacct::
+charge_current(size_t nbytes)
+  {
+    auto& st = s_acct_state;
+    auto acct = st.acct;
+    if(!acct)
+      return nullptr;
+
+    if((int64_t) nbytes <= st.reserve) {
+      st.reserve -= (int64_t) nbytes;
+      return acct;
+    }
+
+    // Reserve some more bytes, so subsequent charges will not have to update
+    // the shared counter. If this would exceed the limit, reserve none.
+    int64_t need = (int64_t) nbytes - st.reserve;
+    bool small = nbytes < acct_small_size;
+
+    if(acct->do_try_charge(need + acct_reserve_size, small))
+      st.reserve = acct_reserve_size;
+    else if(acct->do_try_charge(need, small))
+      st.reserve = 0;
+    else
+      do_throw_limit_exceeded((int64_t) acct->usage(), nbytes, acct->m_limit.load());
+
+    return acct;
   }
 
 }  // namespace rocket
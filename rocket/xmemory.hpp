@@ -6,6 +6,7 @@
 
 #include "fwd.hpp"
 #include "xassert.hpp"
+#include "atomic.hpp"
 namespace rocket {
 
 struct xmeminfo
@@ -36,10 +37,176 @@ xmemalloc(xmeminfo& info, xmemopt opt = xmemopt_use_cache);
 void
 xmemfree(xmeminfo& info, xmemopt opt = xmemopt_use_cache) noexcept;
 
-// Clears the global cache.
+// Clears the global cache, as well as the cache of the calling thread.
+// Blocks that are cached by other threads are not affected.
 void
 xmemclean() noexcept;
 
+struct xmemstats
+  {
+    uint64_t hits;  // allocations that have been served from caches
+    uint64_t misses;  // allocations that have been served by the system
+    uint64_t bytes_cached;  // number of bytes in all caches
+  };
+
+// Gets statistics about the cache. Each thread has its own cache in front
+// of the global one, and publishes its counters periodically, so values
+// from other threads may lag behind.
+void
+xmemstat(xmemstats& stats) noexcept;
+
+// This is an accountant of memory that is held by containers. When an
+// accountant is installed on a thread, storage that is allocated by
+// `cow_string`, `cow_vector` and `cow_hashmap` on that thread is charged to
+// it, and it is refunded when the storage is deallocated, which may happen on
+// another thread. An accountant is created by its owner, and is destroyed
+// after the owner has released it and all storage has been refunded.
+class xmemacct
+  {
+  private:
+    static constexpr int64_t owner_bias = INT64_C(1) << 62;
+
+    atomic_acq_rel<int64_t> m_held;  // bytes, plus `owner_bias` if owned
+    atomic_relaxed<int64_t> m_peak;
+    atomic_relaxed<int64_t> m_limit;  // zero means no limit
+
+  public:
+    xmemacct() noexcept
+      :
+        m_held(owner_bias), m_peak(0), m_limit(0)
+      { }
+
+  private:
+    ~xmemacct() = default;
+
+    [[noreturn]] static
+    void
+    do_throw_limit_exceeded(int64_t usage, size_t nbytes, int64_t limit);
+
+    bool
+    do_try_charge(int64_t nbytes, bool small) noexcept;
+
+    void
+    do_refund(int64_t nbytes) noexcept;
+
+    static
+    void
+    do_refund_slow(xmemacct* acct, size_t nbytes) noexcept;
+
+  public:
+    xmemacct(const xmemacct&) = delete;
+    xmemacct& operator=(const xmemacct&) = delete;
+
+    // Releases the accountant on behalf of its owner.
+    void
+    release() noexcept;
+
+    // Usage is charged in batches of 64 KiB by each thread, so these values
+    // may include bytes that have been reserved but not used yet.
+    size_t
+    usage() const noexcept
+      { return (size_t) (this->m_held.load() & (owner_bias - 1));  }
+
+    size_t
+    peak_usage() const noexcept
+      { return (size_t) this->m_peak.load();  }
+
+    void
+    reset_peak_usage() noexcept
+      { this->m_peak.store(this->m_held.load() & (owner_bias - 1));  }
+
+    size_t
+    limit() const noexcept
+      { return (size_t) this->m_limit.load();  }
+
+    // Sets the limit of usage in bytes, or removes it if `limit` is zero.
+    // Storage that would exceed the limit is not allocated, and an exception
+    // is thrown instead. In order for errors to be handled, allocations that
+    // are smaller than 4 KiB are allowed to exceed the limit by an eighth, or
+    // 256 KiB, whichever is larger.
+    void
+    set_limit(size_t limit) noexcept
+      { this->m_limit.store((int64_t) min(limit, (size_t) (owner_bias - 1)));  }
+
+    // Gets the accountant of the calling thread.
+    static
+    xmemacct*
+    current() noexcept;
+
+    // Installs an accountant on the calling thread, and returns the old one.
+    static
+    xmemacct*
+    exchange_current(xmemacct* acct_opt) noexcept;
+
+    // Charges the accountant of the calling thread, and returns it. If no
+    // accountant has been installed, a null pointer is returned.
+    static
+    xmemacct*
+    charge_current(size_t nbytes);
+
+    // Refunds an accountant that has been charged.
+    static
+    void
+    refund(xmemacct* acct_opt, size_t nbytes) noexcept
+      {
+        if(acct_opt)
+          do_refund_slow(acct_opt, nbytes);
+      }
+  };
+
+// This can be used as the deleter of a smart pointer that owns an accountant.
+struct xmemacct_releaser
+  {
+    void
+    operator()(xmemacct* acct) const noexcept
+      { acct->release();  }
+  };
+
+// This installs an accountant for the current scope.
+class xmemacct_scope
+  {
+  private:
+    xmemacct* m_old;
+
+  public:
+    explicit xmemacct_scope(xmemacct* acct_opt) noexcept
+      :
+        m_old(xmemacct::exchange_current(acct_opt))
+      { }
+
+    xmemacct_scope(const xmemacct_scope&) = delete;
+    xmemacct_scope& operator=(const xmemacct_scope&) = delete;
+
+    ~xmemacct_scope()
+      { xmemacct::exchange_current(this->m_old);  }
+  };
+
+// This charges the accountant of the calling thread, and refunds it upon
+// destruction, unless the charge has been released. Containers release the
+// charge into their storage, after it has been allocated successfully.
+class xmemacct_charge
+  {
+  private:
+    xmemacct* m_acct;
+    size_t m_nbytes;
+
+  public:
+    explicit xmemacct_charge(size_t nbytes)
+      :
+        m_acct(xmemacct::charge_current(nbytes)), m_nbytes(nbytes)
+      { }
+
+    xmemacct_charge(const xmemacct_charge&) = delete;
+    xmemacct_charge& operator=(const xmemacct_charge&) = delete;
+
+    ~xmemacct_charge()
+      { xmemacct::refund(this->m_acct, this->m_nbytes);  }
+
+    xmemacct*
+    release() noexcept
+      { return exchange(this->m_acct, nullptr);  }
+  };
+
 // Copies a block into another, with some checking.
 inline
 void
@@ -0,0 +1,39 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_TEST_ALLOCATION_COUNT_
+#define ASTERIA_TEST_ALLOCATION_COUNT_
+
+#include "utils.hpp"
+#include "../rocket/atomic.hpp"
+
+// Replace the global `operator new` and `operator delete` to count blocks
+// that have not been freed. As replacement functions can't be inline, this
+// file shall be included by only one source file of a test.
+::rocket::atomic_relaxed<int> bcnt;
+
+void* operator new(size_t cb)
+  {
+    auto ptr = ::std::malloc(cb);
+    if(!ptr)
+      throw ::std::bad_alloc();
+
+    bcnt.xadd(1);
+    return ptr;
+  }
+
+void operator delete(void* ptr) noexcept
+  {
+    if(!ptr)
+      return;
+
+    bcnt.xsub(1);
+    ::std::free(ptr);
+  }
+
+void operator delete(void* ptr, size_t) noexcept
+  {
+    operator delete(ptr);
+  }
+
+#endif
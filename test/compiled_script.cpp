@@ -0,0 +1,116 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/air_serializer.hpp"
+#include "../asteria/runtime/enums.hpp"
+#include <stdio.h>  // ::remove()
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.set_keep_code(true);
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        const one = 1;
+        var obj = { a: 1, "b": [ 2.5, "three", null, true ] };
+        func fib(n) {
+          return n <= one ? n : fib(n - one) + fib(n - 2);
+        }
+        var log = [];
+        for(var i = 0;  i < 3;  ++i) {
+          switch(i) {
+            case 0:
+              log[$] = "zero";
+              break;
+            case 1:
+              continue;
+            default:
+              defer log[$] = "deferred";
+              log[$] = "other";
+          }
+        }
+        for(each k, v -> obj)
+          log[$] = k;
+        try { throw "meow"; } catch(e) { log[$] = e; }
+        var [ x, y ] = [ 10, 20 ];
+        var { a, b } = obj;
+        assert typeof b == "array" : "not an array";
+        var s = null;
+        s ??= __varg(0) ?? "none";
+        log[$] = s;
+        return [ fib(11) + one + x + y + a, log ];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    auto res = code.execute();
+    auto str = res.dereference_readonly().as_array().at(1).as_array().at(0).as_string();
+    ASTERIA_TEST_CHECK(res.dereference_readonly().as_array().at(0).as_integer() == 121);
+    ASTERIA_TEST_CHECK(str == "zero");
+
+    // Round-trip the script through its binary form.
+    cow_string bytes = code.save_compiled();
+    Simple_Script loaded;
+    loaded.mut_options().optimization_level = 0;
+    loaded.set_keep_code(true);
+    loaded.reload_compiled(bytes.data(), bytes.size());
+    ASTERIA_TEST_CHECK(loaded.options().optimization_level == 0);
+    auto res2 = loaded.execute();
+    ASTERIA_TEST_CHECK(res2.dereference_readonly().as_array().at(0).as_integer() == 121);
+    ASTERIA_TEST_CHECK(res2.dereference_readonly().as_array().at(1).as_array().size()
+                       == res.dereference_readonly().as_array().at(1).as_array().size());
+    ASTERIA_TEST_CHECK(loaded.save_compiled() == bytes);
+
+    // Files that have been precompiled are recognized by `reload_file()`.
+    cow_string path = format_string("/tmp/.compiled_script-test_$1", ::getpid());
+    code.save_compiled(path);
+    Simple_Script from_file;
+    from_file.reload_file(path);
+    auto res3 = from_file.execute();
+    ASTERIA_TEST_CHECK(res3.dereference_readonly().as_array().at(0).as_integer() == 121);
+    ::remove(path.c_str());
+
+    // Corrupted data shall be rejected.
+    ASTERIA_TEST_CHECK_CATCH(loaded.reload_compiled(bytes.data(), bytes.size() - 1));
+    cow_string bad = bytes;
+    bad.mut(bad.size() / 2) ^= 0x40;
+    ASTERIA_TEST_CHECK_CATCH(loaded.reload_compiled(bad.data(), bad.size()));
+    bad = bytes;
+    bad.mut(0) = '#';
+    ASTERIA_TEST_CHECK_CATCH(loaded.reload_compiled(bad.data(), bad.size()));
+
+    // A reference to a context that does not exist shall be rejected.
+    cow_vector<phsh_string> params;
+    params.emplace_back(&"...");
+    cow_vector<AIR_Node> bad_code;
+    AIR_Node::S_push_local_reference xnode = { Source_Location(&"bad", 1, 1), 5, 0, &"x" };
+    bad_code.emplace_back(move(xnode));
+    AIR_Serializer ser;
+    bad = ser.save(Compiler_Options(), &"bad", params, bad_code);
+    ASTERIA_TEST_CHECK_CATCH(loaded.reload_compiled(bad.data(), bad.size()));
+
+    // Operators that a node can't have been created with shall be rejected.
+    Source_Location bad_sloc(&"bad", 1, 1);
+    AIR_Node::S_apply_operator_bi32 xnode_bi32 = { bad_sloc, xop_fma, false, 1 };
+    AIR_Node::S_local_operator_bi32 xnode_lbi32 = { bad_sloc, 0, 0, &"...", xop_assign, false, 1 };
+    AIR_Node::S_local_operator xnode_local = { bad_sloc, 0, 0, &"...", xop_neg, false };
+    AIR_Node::S_local_operator_local xnode_ll = { bad_sloc, 0, 0, &"...", 0, 0, &"...",
+                                                  xop_sll, false };
+    for(const AIR_Node& node : { AIR_Node(xnode_bi32), AIR_Node(xnode_lbi32),
+                                 AIR_Node(xnode_local), AIR_Node(xnode_ll) }) {
+      bad_code.clear();
+      bad_code.emplace_back(node);
+      bad = ser.save(Compiler_Options(), &"bad", params, bad_code);
+      ASTERIA_TEST_CHECK_CATCH(loaded.reload_compiled(bad.data(), bad.size()));
+    }
+
+    // The code is not kept unless requested.
+    Simple_Script plain;
+    plain.reload_string(&"plain", &"return 1;");
+    ASTERIA_TEST_CHECK(plain.has_code() == false);
+    ASTERIA_TEST_CHECK_CATCH(plain.save_compiled());
+  }
@@ -0,0 +1,34 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../rocket/cow_hashmap.hpp"
+using namespace ::rocket;
+
+struct int_hash
+  {
+    size_t
+    operator()(int val) const noexcept
+      { return static_cast<size_t>(val) * 0x9E3779B9U;  }
+  };
+
+int main()
+  {
+    cow_hashmap<int, int, int_hash> map;
+    for(int k = 0;  k < 100;  ++k)
+      map.try_emplace(k, k * 2);
+    ASTERIA_TEST_CHECK(map.size() == 100);
+    ASTERIA_TEST_CHECK(map.bucket_count() > 100);
+
+    // All buckets are cleared, not only the first `size()` ones.
+    map.clear();
+    ASTERIA_TEST_CHECK(map.size() == 0);
+    ASTERIA_TEST_CHECK(map.begin() == map.end());
+    for(int k = 0;  k < 100;  ++k)
+      ASTERIA_TEST_CHECK(map.find(k) == map.end());
+
+    // Storage is reused.
+    map.try_emplace(42, 1);
+    ASTERIA_TEST_CHECK(map.size() == 1);
+    ASTERIA_TEST_CHECK(map.find(42)->second == 1);
+  }
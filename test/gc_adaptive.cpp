@@ -0,0 +1,55 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        assert std.gc.get_policy() == "fixed";
+        assert std.gc.set_policy("adaptive", 0.01) == "fixed";
+        assert std.gc.get_policy() == "adaptive";
+
+        try { std.gc.set_policy("meow");  assert false;  }
+          catch(e) assert std.string.find(e, "Invalid garbage collection policy") != null;
+        try { std.gc.set_policy("adaptive", 0);  assert false;  }
+          catch(e) assert std.string.find(e, "Invalid target overhead") != null;
+        try { std.gc.set_policy("adaptive", 1.5);  assert false;  }
+          catch(e) assert std.string.find(e, "Invalid target overhead") != null;
+
+        var data = [];
+        for(var i = 0;  i < 2000;  ++i) {
+          var x = i;
+          data[$] = func() { return x;  };
+        }
+
+        // Nearly all time is spent outside collection, so a target close to
+        // one reduces thresholds to their minimum.
+        std.gc.set_policy("adaptive", 0.99);
+        var s = 0;
+        for(var i = 0;  i < 100000;  ++i) {
+          var x = i;
+          var f = func() { return x;  };
+          s += f();
+        }
+        assert s == 4999950000;
+
+        var t1 = std.gc.get_threshold(0);
+        assert t1 == 10;
+
+        for(var i = 0;  i < 2000;  ++i)
+          assert data[i]() == i;
+
+        assert std.gc.set_policy("fixed") == "adaptive";
+        assert std.gc.get_threshold(0) == t1;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
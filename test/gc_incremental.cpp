@@ -0,0 +1,91 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "allocation_count.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+#include "../asteria/runtime/variable.hpp"
+#include "../rocket/xmemory.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Ignore leaks of emutls, emergency pool, etc.
+    delete new int;
+
+    bcnt.store(0);
+    {
+      Simple_Script code;
+      code.reload_string(
+        &__FILE__, __LINE__, &""
+        "const nloop = 20000;"
+        R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          assert std.gc.get_incremental_budget() == 0;
+          assert std.gc.set_incremental_budget(64) == 0;
+          assert std.gc.get_incremental_budget() == 64;
+          std.gc.set_threshold(2, 100);
+
+          // These live variables must survive all steps.
+          var live = [];
+          for(var i = 0;  i < 300;  ++i) {
+            var x = i;
+            live[$] = func() { return x;  };
+          }
+
+          // Keep cycles alive for a while, so they are promoted to the
+          // oldest generation before they become unreachable.
+          var ring = [];
+          func leak(i) {
+            var f;
+            var h = func() { return f;  };
+            f = func() { return h;  };
+            ring[i % 500] = f;
+          }
+          for(var i = 0;  i < nloop;  ++i) {
+            leak(i);
+          }
+
+          // Cycles shall have been collected without an explicit call.
+          assert std.gc.count_variables(2) < 2000;
+
+          for(var i = 0;  i < 300;  ++i)
+            assert live[i]() == i;
+
+          var stats = std.gc.get_statistics();
+          assert countof stats.generations == 3;
+          assert stats.generations[0].collections > 0;
+          assert stats.generations[2].collections > 0;
+          assert stats.generations[2].freed > 0;
+          assert stats.generations[0].promoted > 0;
+          assert stats.generations[0].pool_hits + stats.generations[0].pool_misses > nloop;
+          assert countof stats.pause_histogram == 32;
+          var npauses = 0;
+          for(each k, n -> stats.pause_histogram)
+            npauses += n;
+          assert stats.pause_count == npauses;
+          assert stats.pause_max_ns <= stats.pause_total_ns;
+          var ncollections = 0, ntime = 0;
+          for(each k, g -> stats.generations) {
+            ncollections += g.collections;
+            ntime += g.time_ns;
+          }
+          assert stats.pause_count <= ncollections;
+          assert ntime <= stats.pause_total_ns;
+
+          assert std.gc.set_incremental_budget(0) == 64;
+          std.gc.collect();
+          for(var i = 0;  i < 300;  ++i)
+            assert live[i]() == i;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      code.execute();
+    }
+
+    ::rocket::xmemclean();
+    ::rocket::xmemclean();
+    ASTERIA_TEST_CHECK(bcnt.load() == 0);
+  }
@@ -2,38 +2,13 @@
 // Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
 
 #include "utils.hpp"
+#include "allocation_count.hpp"
 #include "../asteria/simple_script.hpp"
 #include "../asteria/runtime/garbage_collector.hpp"
 #include "../asteria/runtime/variable.hpp"
 #include "../rocket/xmemory.hpp"
 using namespace ::asteria;
 
-atomic_relaxed<int> bcnt;
-
-void* operator new(size_t cb)
-  {
-    auto ptr = ::std::malloc(cb);
-    if(!ptr)
-      throw ::std::bad_alloc();
-
-    bcnt.xadd(1);
-    return ptr;
-  }
-
-void operator delete(void* ptr) noexcept
-  {
-    if(!ptr)
-      return;
-
-    bcnt.xsub(1);
-    ::std::free(ptr);
-  }
-
-void operator delete(void* ptr, size_t) noexcept
-  {
-    operator delete(ptr);
-  }
-
 int main()
   {
     // Ignore leaks of emutls, emergency pool, etc.
@@ -0,0 +1,46 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/module_loader.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      get_real_path(&__FILE__), __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        const chars = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        var fname = "/tmp/.import_cache-test_" + std.string.implode(std.array.shuffle(std.string.explode(chars)));
+
+        std.filesystem.write(fname, "return 42;");
+        assert import(fname) == 42;
+        assert import(fname) == 42;
+
+        // Modify the file. The size is changed, so the cached module must be
+        // discarded, even if the modification time isn't.
+        std.filesystem.write(fname, "return 'meow';");
+        assert import(fname) == 'meow';
+        assert import(fname) == 'meow';
+
+        // Compile errors are not cached.
+        std.filesystem.write(fname, "return +;");
+        assert catch( import(fname) ) != null;
+        std.filesystem.write(fname, "return __varg(0) * 2;");
+        assert import(fname, 21) == 42;
+
+        std.filesystem.remove_file(fname);
+        assert catch( import(fname) ) != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // Only the last version of the file should have been cached.
+    ASTERIA_TEST_CHECK(code.global().module_loader()->count_cached_modules() == 1);
+    code.mut_global().module_loader()->clear_cached_modules();
+    ASTERIA_TEST_CHECK(code.global().module_loader()->count_cached_modules() == 0);
+  }
@@ -0,0 +1,39 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include <stdio.h>
+using namespace ::asteria;
+
+int main()
+  {
+    // Feed standard input from a temporary file.
+    ::FILE* fp = ::tmpfile();
+    ASTERIA_TEST_CHECK(fp);
+    static constexpr char input[] = "h\xC3\xA9llo\nworld\n\nline 4\nline 5\r\nline 6\nlast";
+    ASTERIA_TEST_CHECK(::fwrite(input, 1, sizeof(input) - 1, fp) == sizeof(input) - 1);
+    ::rewind(fp);
+    ASTERIA_TEST_CHECK(::dup2(::fileno(fp), STDIN_FILENO) == STDIN_FILENO);
+    ::clearerr(stdin);
+
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        assert std.io.getc() == 0x68;
+        assert std.io.getc() == 0xE9;
+        assert std.io.getln() == "llo";
+        assert std.io.getlns(0) == [];
+        assert std.io.getlns(2) == ["world", ""];
+        assert std.io.getln() == "line 4";
+        assert std.io.getlns() == ["line 5\r", "line 6", "last"];
+        assert std.io.getln() == null;
+        assert std.io.getlns() == null;
+        assert std.io.getc() == null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
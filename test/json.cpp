@@ -20,6 +20,11 @@ int main()
         assert std.json.format("hello") == "\"hello\"";
         assert std.json.format("喵") == "\"\\u55B5\"";
         assert std.json.format("\a\b\v\f\n\r\t") == "\"\\u0007\\b\\u000B\\f\\n\\r\\t\"";
+        assert std.json.format("0123456789abcdef0123456789abcdef\"0123456789abcdef\x7F喵") ==
+               "\"0123456789abcdef0123456789abcdef\\\"0123456789abcdef\\u007F\\u55B5\"";
+        assert std.json.format(123456789012345) == "123456789012345";
+        assert std.json.format(-1234567890123456) == "-1.234567890123456e+15";
+        assert std.json.format(-0.0) == "-0";
 
         assert std.json.format([]) == "[]";
         assert std.json.format([0]) == "[0]";
@@ -103,6 +108,72 @@ int main()
         assert countof r[1].c == 0;
         assert r[1].d == 4;
 
+        var p = std.json.Parser(1);
+        var out = [];
+        var text = "[{a:1}, {a:'two'},\n{a:3}, 4, ]";
+        for(var i = 0;  i < countof text;  ++i)
+          p.feed(std.string.slice(text, i, 1), func(k, v) { out[$] = [ k, v ];  });
+        assert countof out == 4;
+        p.finish(func(k, v) { out[$] = [ k, v ];  });
+        assert countof out == 4;
+        assert out[0][0] == 0;
+        assert out[0][1].a == 1;
+        assert out[1][1].a == "two";
+        assert out[2][0] == 2;
+        assert out[3] == [ 3, 4 ];
+
+        out = [];
+        p.feed("{ \"b\": [1, 2], c: null }", func(k, v) { out[$] = [ k, v ];  });
+        p.finish(func(k, v) { out[$] = [ k, v ];  });
+        assert out == [ [ "b", [1, 2] ], [ "c", null ] ];
+
+        // Duplicate keys are detected in values that are passed.
+        assert catch( p.feed("{ a: 1, a: 2 }", func(k, v) { }) ) != null;
+        p.clear();
+
+        // Values are not lost if the callback throws an exception.
+        out = [];
+        assert catch( p.feed("[1, 2, 3, 4]", func(k, v) { out[$] = v;  throw v;  }) ) == 1;
+        assert out == [ 1 ];
+        p.feed("", func(k, v) { out[$] = v;  });
+        assert out == [ 1, 2, 3, 4 ];
+        p.finish(func(k, v) { out[$] = v;  });
+        assert out == [ 1, 2, 3, 4 ];
+
+        p = std.json.Parser(0, true);
+        out = [];
+        p.feed("{\"x\":1}\n[2]\n\n", func(k, v) { out[$] = v;  });
+        p.feed("3", func(k, v) { out[$] = v;  });
+        assert countof out == 2;
+        p.finish(func(k, v) { out[$] = v;  });
+        assert countof out == 3;
+        assert out[0].x == 1;
+        assert out[1] == [2];
+        assert out[2] == 3;
+
+        p.finish(func(k, v) { out[$] = v;  });
+        assert countof out == 3;
+        assert catch( p.feed("1 2", func(k, v) { }) ) != null;
+        p.clear();
+        assert catch( std.json.Parser(-1) ) != null;
+        assert catch( std.json.Parser().finish(func(k, v) { }) ) != null;
+
+        // A long token may arrive in many small chunks.
+        p = std.json.Parser();
+        text = "[\"" + std.string.padr("", 10000, "meow") + "\"]";
+        for(var i = 0;  i < countof text;  i += 7)
+          p.feed(std.string.slice(text, i, 7), func(k, v) { out = v;  });
+        p.finish(func(k, v) { out = v;  });
+        assert out == [ std.string.padr("", 10000, "meow") ];
+
+        // A BOM may be split, but not truncated.
+        p.feed("\xEF\xBB", func(k, v) { });
+        p.feed("\xBF[1]", func(k, v) { out = v;  });
+        p.finish(func(k, v) { out = v;  });
+        assert out == [ 1 ];
+        p.feed("\xEF\xBB", func(k, v) { });
+        assert catch( p.finish(func(k, v) { }) ) != null;
+
         const depth = 1000;
         var r = [];
         for(var i = 1; i < depth; ++i) {
@@ -0,0 +1,321 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/library/json.hpp"
+#include "../asteria/value.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/compiler_error.hpp"
+#include "../asteria/compiler/enums.hpp"
+#include "../rocket/tinybuf_str.hpp"
+#include <stdio.h>
+#include <unistd.h>
+using namespace ::asteria;
+
+namespace {
+
+opt<Punctuator>
+do_accept_punctuator_opt(Token_Stream& tstrm, initializer_list<Punctuator> accept)
+  {
+    auto qtok = tstrm.peek_opt();
+    if(!qtok)
+      return nullopt;
+
+    if(!qtok->is_punctuator())
+      return nullopt;
+
+    auto punct = qtok->as_punctuator();
+    if(::rocket::is_none_of(punct, accept))
+      return nullopt;
+
+    tstrm.shift();
+    return punct;
+  }
+
+struct Xparse_array
+  {
+    V_array arr;
+  };
+
+struct Xparse_object
+  {
+    V_object obj;
+    phsh_string key;
+    Source_Location key_sloc;
+  };
+
+using Xparse = ::rocket::variant<Xparse_array, Xparse_object>;
+
+void
+do_accept_object_key(Xparse_object& ctxo, Token_Stream& tstrm)
+  {
+    auto qtok = tstrm.peek_opt();
+    if(!qtok)
+      throw Compiler_Error(xtc_status,
+                compiler_status_closing_brace_or_json5_key_expected, tstrm.next_sloc());
+
+    if(qtok->is_identifier())
+      ctxo.key = qtok->as_identifier();
+    else if(qtok->is_string_literal())
+      ctxo.key = qtok->as_string_literal();
+    else
+      throw Compiler_Error(xtc_status,
+                compiler_status_closing_brace_or_json5_key_expected, tstrm.next_sloc());
+
+    ctxo.key_sloc = qtok->sloc();
+    tstrm.shift();
+
+    auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_colon });
+    if(!kpunct)
+      throw Compiler_Error(xtc_status,
+                compiler_status_colon_expected, tstrm.next_sloc());
+  }
+
+Value
+do_parse_nonrecursive(Token_Stream& tstrm)
+  {
+    // Implement a non-recursive descent parser.
+    Value value;
+    cow_vector<Xparse> stack;
+
+    // Accept a value. No other things such as closed brackets are allowed.
+  parse_next:
+    auto qtok = tstrm.peek_opt();
+    if(!qtok)
+      throw Compiler_Error(xtc_format,
+                compiler_status_expression_expected, tstrm.next_sloc(),
+                "Value expected");
+
+    if(qtok->is_punctuator()) {
+      // Accept an `[` or `{`.
+      if(qtok->as_punctuator() == punctuator_bracket_op) {
+        tstrm.shift();
+
+        auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_bracket_cl });
+        if(!kpunct) {
+          stack.emplace_back(Xparse_array());
+          goto parse_next;
+        }
+
+        // Accept an empty array.
+        value = V_array();
+      }
+      else if(qtok->as_punctuator() == punctuator_brace_op) {
+        tstrm.shift();
+
+        auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl });
+        if(!kpunct) {
+          stack.emplace_back(Xparse_object());
+          do_accept_object_key(stack.mut_back().mut<Xparse_object>(), tstrm);
+          goto parse_next;
+        }
+
+        // Accept an empty object.
+        value = V_object();
+      }
+      else
+        throw Compiler_Error(xtc_format,
+                  compiler_status_expression_expected, tstrm.next_sloc(),
+                  "Value expected");
+    }
+    else if(qtok->is_identifier()) {
+      // Accept a literal.
+      if(qtok->as_identifier() == "null") {
+        tstrm.shift();
+        value = nullopt;
+      }
+      else if(qtok->as_identifier() == "true") {
+        tstrm.shift();
+        value = true;
+      }
+      else if(qtok->as_identifier() == "false") {
+        tstrm.shift();
+        value = false;
+      }
+      else if(qtok->as_identifier() == "Infinity") {
+        tstrm.shift();
+        value = ::std::numeric_limits<double>::infinity();
+      }
+      else if(qtok->as_identifier() == "NaN") {
+        tstrm.shift();
+        value = ::std::numeric_limits<double>::quiet_NaN();
+      }
+      else
+        throw Compiler_Error(xtc_format,
+                  compiler_status_expression_expected, tstrm.next_sloc(),
+                  "Value expected");
+    }
+    else if(qtok->is_real_literal()) {
+      // Accept a number.
+      value = qtok->as_real_literal();
+      tstrm.shift();
+    }
+    else if(qtok->is_string_literal()) {
+      // Accept a UTF-8 string.
+      value = qtok->as_string_literal();
+      tstrm.shift();
+    }
+    else
+      throw Compiler_Error(xtc_format,
+                compiler_status_expression_expected, tstrm.next_sloc(),
+                "Value expected");
+
+    while(stack.size()) {
+      // Advance to the next element.
+      auto& ctx = stack.mut_back();
+      switch(ctx.index())
+        {
+        case 0:
+          {
+            auto& ctxa = ctx.mut<Xparse_array>();
+            ctxa.arr.emplace_back(move(value));
+
+            // Look for the next element.
+            auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_bracket_cl, punctuator_comma });
+            if(!kpunct)
+              throw Compiler_Error(xtc_status,
+                        compiler_status_closing_bracket_or_comma_expected, tstrm.next_sloc());
+
+            if(*kpunct == punctuator_comma) {
+              // A closing bracket may still follow.
+              kpunct = do_accept_punctuator_opt(tstrm, { punctuator_bracket_cl });
+              if(!kpunct)
+                goto parse_next;
+            }
+
+            // Close this array.
+            value = move(ctxa.arr);
+            break;
+          }
+
+        case 1:
+          {
+            auto& ctxo = ctx.mut<Xparse_object>();
+            auto pair = ctxo.obj.try_emplace(move(ctxo.key), move(value));
+            if(!pair.second)
+              throw Compiler_Error(xtc_status,
+                        compiler_status_duplicate_key_in_object, ctxo.key_sloc);
+
+            // Look for the next element.
+            auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl, punctuator_comma });
+            if(!kpunct)
+              throw Compiler_Error(xtc_status,
+                        compiler_status_closing_brace_or_comma_expected, tstrm.next_sloc());
+
+            if(*kpunct == punctuator_comma) {
+              // A closing brace may still follow.
+              kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl });
+              if(!kpunct) {
+                do_accept_object_key(stack.mut_back().mut<Xparse_object>(), tstrm);
+                goto parse_next;
+              }
+            }
+
+            // Close this object.
+            value = move(ctxo.obj);
+            break;
+          }
+
+        default:
+          ROCKET_ASSERT(false);
+      }
+
+      stack.pop_back();
+    }
+
+    return value;
+  }
+
+Value
+do_parse_reference(V_string text)
+  {
+    // This is the old implementation of `std.json.parse`, which reuses the
+    // tokenizer of Asteria, allowing quite a few extensions e.g. binary
+    // numeric literals and comments.
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(text, tinybuf::open_read);
+
+    Compiler_Options opts;
+    opts.escapable_single_quotes = true;
+    opts.keywords_as_identifiers = true;
+    opts.integers_as_reals = true;
+
+    Token_Stream tstrm(opts);
+    tstrm.reload(&"[JSON text]", 1, move(cbuf));
+    if(tstrm.empty())
+      ASTERIA_THROW(("Empty JSON string"));
+
+    // Parse a single value.
+    auto value = do_parse_nonrecursive(tstrm);
+    if(!tstrm.empty())
+      ASTERIA_THROW(("Excess text at end of JSON string"));
+
+    return value;
+  }
+
+}  // namespace
+
+int main()
+  {
+    // Valid documents shall be parsed identically by both parsers.
+    static constexpr const char* valid[] =
+      {
+        "null", "true", "false", " 42 ", "-76.5", "+1e10", "0x1Fp4", "0b1011",
+        "1`000`000", "1e-300", "Infinity", "-Infinity", "NaN", "-nan",
+        "\"\"", "'single'", "\"\\u55B5\\x41\\U01F600\\t\\e\\Z\\/\\?\"", "\"\xE5\x96\xB5\"",
+        "[]", "[ ]", "[0,1,]", "[[[]],[[],[]]]", "{}", "{ a: 1, 'b': [2], \"c\": { d: null }, }",
+        "// comment\n[1, /* block\n comment */ 2]", "[1] // tail",
+        "{\"k\":\"v\"}\n\n  ",
+      };
+
+    for(const char* text : valid) {
+      auto lhs = std_json_parse(::rocket::sref(text));
+      auto rhs = do_parse_reference(::rocket::sref(text));
+      ASTERIA_TEST_CHECK(std_json_format(lhs, nullopt, true) == std_json_format(rhs, nullopt, true));
+    }
+
+    // Invalid documents shall be rejected by both parsers.
+    static constexpr const char* invalid[] =
+      {
+        "", "  ", "// nothing", "[", "[1", "[1,", "{", "{a", "{a:", "{a:1", "{a:1,", "]", "}",
+        "[1 2]", "{a 1}", "{a:1 b:2}", "{1:2}", "{a:1,a:2}", "[,]", "[1,,]", "2 1", "nul",
+        "-", "+x", "1x", "0x", "1e", "\"abc", "'abc", "\"a\nb\"", "\"\\q\"", "\"\\u12\"",
+        "\"\\uZZZZ\"", "\"\xFF\"", "\"\xE5\x96", "[1] 2", "/* open", "undefined", "[;]",
+        "//\xE5" "c\n[1]", "/* \xFF */ [1]", "0`x1.8p2",
+      };
+
+    for(const char* text : invalid) {
+      ASTERIA_TEST_CHECK_CATCH(std_json_parse(::rocket::sref(text)));
+      ASTERIA_TEST_CHECK_CATCH(do_parse_reference(::rocket::sref(text)));
+    }
+
+    // A UTF-8 BOM is ignored. Surrogate pairs are combined.
+    ASTERIA_TEST_CHECK(std_json_parse(::rocket::sref("\xEF\xBB\xBF[1]")).as_array().size() == 1);
+    ASTERIA_TEST_CHECK(std_json_parse(::rocket::sref("\"\\uD83D\\uDE00\"")).as_string() == "\xF0\x9F\x98\x80");
+    ASTERIA_TEST_CHECK_CATCH(std_json_parse(::rocket::sref("\"\\uD83D\"")));
+    ASTERIA_TEST_CHECK_CATCH(std_json_parse(::rocket::sref("\"\\uDE00\"")));
+
+    // Build a document that is large enough to straddle many chunks when
+    // it is read from a file.
+    cow_string text = &"[\n";
+    for(int k = 0;  k < 20000;  ++k) {
+      text += format_string("  { id: $1, name: \"record \\\"$1\\\" \xE5\x96\xB5\", ", k);
+      text += format_string("value: $1.25, tags: [ 'a', 'b' ], /* $1 */ }, // $1\n", k);
+    }
+    text += &"]\n";
+
+    auto lhs = std_json_parse(text);
+    auto rhs = do_parse_reference(text);
+    ASTERIA_TEST_CHECK(lhs.as_array().size() == 20000);
+    ASTERIA_TEST_CHECK(std_json_format(lhs, nullopt, true) == std_json_format(rhs, nullopt, true));
+
+    char path[] = "/tmp/asteria_test_json_parser_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASTERIA_TEST_CHECK(fd >= 0);
+    ASTERIA_TEST_CHECK(::write(fd, text.data(), text.size()) == (::ssize_t) text.size());
+    ::close(fd);
+
+    auto fval = std_json_parse_file(::rocket::sref(path));
+    ::unlink(path);
+    ASTERIA_TEST_CHECK(std_json_format(fval, nullopt, true) == std_json_format(rhs, nullopt, true));
+  }
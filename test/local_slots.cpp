@@ -0,0 +1,113 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/llds/reference_dictionary.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Slots are assigned in insertion order, and survive rehashing.
+    Reference_Dictionary dict;
+    cow_vector<phsh_string> names;
+    for(int k = 0;  k < 100;  ++k)
+      names.emplace_back(format_string("name_$1", k));
+
+    for(const auto& name : names)
+      dict.insert(name, nullptr, true).set_temporary(name.rdstr());
+    dict.insert(&"__builtin", nullptr, false);
+
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(0)) == 0);
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(42)) == 42);
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(99)) == 99);
+    ASTERIA_TEST_CHECK(dict.find_slot(&"__builtin") == Reference_Dictionary::no_slot);
+    ASTERIA_TEST_CHECK(dict.find_slot(&"unknown") == Reference_Dictionary::no_slot);
+    ASTERIA_TEST_CHECK(dict.find_opt(42, names.at(42))->dereference_readonly().as_string() == "name_42");
+
+    // A stale slot falls back to a normal lookup.
+    ASTERIA_TEST_CHECK(dict.find_opt(41, names.at(42))->dereference_readonly().as_string() == "name_42");
+    ASTERIA_TEST_CHECK(dict.find_opt(Reference_Dictionary::no_slot, names.at(7)) == dict.find_opt(names.at(7)));
+    ASTERIA_TEST_CHECK(dict.find_opt(3, &"unknown") == nullptr);
+
+    // Erasing an element renumbers subsequent ones.
+    ASTERIA_TEST_CHECK(dict.erase(names.at(10), nullptr));
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(9)) == 9);
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(11)) == 10);
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(99)) == 98);
+    ASTERIA_TEST_CHECK(dict.find_opt(98, names.at(99))->dereference_readonly().as_string() == "name_99");
+
+    dict.clear();
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(0)) == Reference_Dictionary::no_slot);
+    dict.insert(names.at(5), nullptr, true);
+    ASTERIA_TEST_CHECK(dict.find_slot(names.at(5)) == 0);
+
+    // Local references in scripts are looked up by slot.
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func sum(n, ...) {
+          var s = 0, t = 0;
+          for(var i = 0;  i < n;  ++i) {
+            var u = i * 2;
+            s += u;
+            t += __varg(0) ?? 1;
+          }
+          return [ s, t ];
+        }
+        assert sum(10) == [ 90, 10 ];
+        assert sum(10, 3) == [ 90, 30 ];
+
+        // Names in clauses that are jumped over are still declared.
+        func pick(k) {
+          var r = [];
+          switch(k) {
+            case 1:
+              var a = 1;
+            case 2:
+              var b = 2;
+              r[$] = b;
+            case 3:
+              var c = 3;
+              r[$] = c;
+          }
+          return r;
+        }
+        assert pick(1) == [ 2, 3 ];
+        assert pick(2) == [ 2, 3 ];
+        assert pick(3) == [ 3 ];
+
+        // Redeclaration does not create a new slot.
+        var x = 1;
+        var y = 2;
+        var x = 3;
+        var z = 4;
+        assert x == 3;
+        assert y == 2;
+        assert z == 4;
+
+        // Closures capture variables from outer scopes.
+        func make(p) {
+          var q = p + 1;
+          return func(r) { var w = r;  return p * 100 + q * 10 + w;  };
+        }
+        assert make(1)(3) == 123;
+
+        try
+          throw 5;
+        catch(e) {
+          var f = e + 1;
+          assert f == 6;
+        }
+
+        for(each k, v -> [ 7, 8 ]) {
+          var g = k + v;
+          assert g == k * 2 + 7;
+        }
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
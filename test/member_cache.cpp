@@ -0,0 +1,70 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // A hinted lookup checks the hinted bucket first.
+    V_object obj;
+    obj.try_emplace(&"alpha", 1);
+    obj.try_emplace(&"beta", 2);
+    obj.try_emplace(&"gamma", 3);
+
+    size_t hint = 12345;
+    ASTERIA_TEST_CHECK(obj.ptr(hint, &"beta")->as_integer() == 2);
+    ASTERIA_TEST_CHECK(hint < obj.bucket_count());
+    size_t beta_hint = hint;
+    ASTERIA_TEST_CHECK(obj.ptr(hint, &"beta")->as_integer() == 2);
+    ASTERIA_TEST_CHECK(hint == beta_hint);
+    ASTERIA_TEST_CHECK(obj.ptr(hint, &"gamma")->as_integer() == 3);
+    ASTERIA_TEST_CHECK(obj.ptr(hint, &"delta") == nullptr);
+    hint = beta_hint;
+    ASTERIA_TEST_CHECK(obj.mut_ptr(hint, &"alpha")->as_integer() == 1);
+
+    // Objects with different layouts are accessed by the same nodes.
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func get_b(o) {
+          return o.b;
+        }
+        var recs = [
+          { a: 1, b: 2, c: 3 },
+          { b: 4 },
+          { c: 5, x: 6, y: 7, z: 8, b: 9, w: 10 },
+          { a: 11 },
+          null,
+          { b: 12, a: 13 },
+        ];
+        var r = [];
+        for(each k, o -> recs)
+          r[$] = get_b(o);
+        assert r == [ 2, 4, 9, null, null, 12 ];
+
+        var s = 0;
+        for(var i = 0;  i < 100;  ++i) {
+          var o = { id: i, name: "n", b: i * 2 };
+          if(i % 3 == 0)
+            unset o.id;
+          s += o.b;
+          o.b += 1;
+          assert o.b == i * 2 + 1;
+        }
+        assert s == 9900;
+
+        var t = { b: 1 };
+        assert get_b(t) == 1;
+        unset t.b;
+        assert get_b(t) == null;
+        t.b = 3;
+        assert get_b(t) == 3;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
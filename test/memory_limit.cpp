@@ -0,0 +1,85 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var kept = "x" * 100000;
+
+        // Runaway allocations are stopped, and can be caught.
+        var caught = false;
+        try {
+          var s = "abcd";
+          for(;;)
+            s += s;
+        }
+        catch(e)
+          caught = std.string.find(e, "memory limit exceeded") != null;
+        assert caught;
+
+        caught = false;
+        try {
+          var a = [];
+          a[1000000] = true;
+        }
+        catch(e)
+          caught = std.string.find(e, "memory limit exceeded") != null;
+        assert caught;
+
+        caught = false;
+        try
+          std.array.generate(func(i, x) = i, 1000000);
+        catch(e)
+          caught = std.string.find(e, "memory limit exceeded") != null;
+        assert caught;
+
+        // Memory that has been released can be reused.
+        var a = [];
+        for(var i = 0;  i < 1000;  ++i)
+          a[$] = { value: i, text: "y" * 100 };
+        return kept;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+
+    auto& global = code.mut_global();
+    ASTERIA_TEST_CHECK(global.memory_limit() == 0);
+    global.set_memory_limit(10000000);
+    ASTERIA_TEST_CHECK(global.memory_limit() == 10000000);
+
+    size_t base = global.memory_usage();
+    auto kept = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(kept.as_string().size() == 100000);
+
+    // The result is still charged. Others are refunded after variables have
+    // been collected.
+    global.garbage_collector()->collect_variables();
+    ASTERIA_TEST_CHECK(global.memory_usage() >= base + 100000);
+    ASTERIA_TEST_CHECK(global.memory_usage() < base + 200000);
+    ASTERIA_TEST_CHECK(global.peak_memory_usage() > 5000000);
+    ASTERIA_TEST_CHECK(global.peak_memory_usage() <= 10000000 + 10000000 / 8);
+
+    kept = nullopt;
+    ASTERIA_TEST_CHECK(global.memory_usage() < base + 100000);
+    global.reset_peak_memory_usage();
+    ASTERIA_TEST_CHECK(global.peak_memory_usage() == global.memory_usage());
+
+    // Values can outlive the context that has created them.
+    {
+      Simple_Script other;
+      other.reload_string(&__FILE__, __LINE__, &"return 'z' * 1000;");
+      kept = other.execute().dereference_readonly();
+      ASTERIA_TEST_CHECK(other.global().memory_usage() >= 1000);
+    }
+    ASTERIA_TEST_CHECK(kept.as_string().size() == 1000);
+  }
@@ -541,6 +541,34 @@ int main()
         assert __isvoid func(){ return; }() == true;
         assert __isvoid func(){ return 1; }() == false;
 
+        func counter() {
+          var n = 0, o = { k: 5 };
+          return func(d) { var t = { v: d };  n++;  n += t.v;  return n * o.k;  };
+        }
+        var next = counter();
+        assert next(1) == 10;
+        assert next(2) == 25;
+
+        var dv;
+        func defer_tail() { return 0;  }
+        func defer_add(k) { defer dv = k + 1;  return defer_tail();  }
+        defer_add(41);
+        assert dv == 42;
+
+        func sum_below(n) {
+          var s = 0, r = 0.5, t = "a";
+          for(var i = 0;  i < n;  ++i) {
+            if(i != s)
+              s += i;
+            r *= r;
+            t += t;
+          }
+          return [ s, r, t, n <=> s ];
+        }
+        assert sum_below(4) == [ 3, 1.52587890625e-5, "aaaaaaaaaaaaaaaa", 1 ];
+        try { sum_below("4");  assert false;  }
+          catch(e) assert std.string.find(e, "not comparable") != null;
+
 ///////////////////////////////////////////////////////////////////////////////
       )__");
     code.execute();
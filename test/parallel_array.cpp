@@ -0,0 +1,67 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var data = std.array.generate(func(i, p) = { id: i, name: "r" + std.string.format("$1", i) }, 5000);
+
+        var r = std.array.pmap(data, func(x) = x.id * 2);
+        assert countof r == 5000;
+        for(var i = 0;  i < 5000;  ++i)
+          assert r[i] == i * 2;
+
+        r = std.array.pfilter(data, func(x) = x.id % 3 == 0);
+        assert countof r == 1667;
+        assert r[0].name == "r0";
+        assert r[1666].id == 4998;
+
+        assert std.array.preduce(data, func(a, x) = { id: a.id + x.id }).id == 12497500;
+        assert std.array.preduce([ 1, 2, 3, 4 ], func(a, x) = a + x, 10) == 20;
+        assert std.array.preduce([], func(a, x) = a + x, 10) == 10;
+        assert std.array.preduce([], func(a, x) = a + x) == null;
+        assert std.array.preduce([], func(a, x) = a + x, null) == null;
+        assert std.array.preduce([ 1 ], func(a, x) = [ a, x ], null) == [ null, 1 ];
+        var ints = std.array.generate(func(i, p) = i, 5000);
+        assert std.array.preduce(ints, func(a, x) = a + x) == 12497500;
+        assert catch(std.array.preduce(ints, func(a, x) = a + x, null)) != null;
+        assert std.array.pmap([], func(x) = x) == [];
+
+        // Standard library functions are available on worker threads.
+        r = std.array.pmap([ -1, 2, -3 ], func(x) = std.numeric.abs(x));
+        assert r == [ 1, 2, 3 ];
+
+        // Callbacks may not capture variables.
+        var k = 2;
+        assert catch(std.array.pmap(data, func(x) = x.id * k)) != null;
+        assert catch(std.array.pmap([ 1 ], func(x) = x * k)) != null;
+
+        // Functions can't be passed to or returned from worker threads.
+        assert catch(std.array.pmap([ func() {} ], func(x) = x)) != null;
+        assert catch(std.array.pmap([ 1 ], func(x) = func() {})) != null;
+        assert catch(std.array.pmap([ 1 ], std.numeric.abs)) != null;
+
+        // Callbacks may make parallel calls, which are run on their worker threads.
+        r = std.array.pmap(ints, func(x) =
+                std.array.preduce(std.array.pmap(std.array.generate(func(i, p) = i, 600),
+                                                 func(y) = y + 1),
+                                  func(a, y) = a + y) + x);
+        assert countof r == 5000;
+        assert r[0] == 180300;
+        assert r[4999] == 185299;
+
+        // Exceptions are propagated to the calling thread.
+        assert catch(std.array.pmap(data, func(x) { if(x.id == 4321) throw "meow";  return x;  })) != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
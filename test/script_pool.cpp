@@ -0,0 +1,78 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/script_pool.hpp"
+#include <thread>
+#include <atomic>
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.set_keep_code(true);
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var n = __varg(0);
+        var s = 0;
+        for(var i = 1;  i <= n;  ++i)
+          s += i;
+        return std.string.format("$1", s);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+
+    Script_Pool pool(code, 4);
+    ASTERIA_TEST_CHECK(pool.size() == 4);
+    ASTERIA_TEST_CHECK(pool.count_available() == 4);
+
+    auto lease = pool.checkout();
+    ASTERIA_TEST_CHECK(pool.count_available() == 3);
+    cow_vector<Value> args;
+    args.emplace_back(V_integer(100));
+    ASTERIA_TEST_CHECK(lease.execute(move(args)).dereference_readonly().as_string() == "5050");
+
+    // Global references are destroyed when a context is returned.
+    auto& global = lease.mut_global();
+    global.insert_named_reference(&"leak").set_temporary(V_integer(42));
+    lease.reset();
+    ASTERIA_TEST_CHECK(!lease);
+    ASTERIA_TEST_CHECK(pool.count_available() == 4);
+    ASTERIA_TEST_CHECK(global.get_named_reference_opt(&"leak") == nullptr);
+    ASTERIA_TEST_CHECK(global.get_named_reference_opt(&"std") != nullptr);
+
+    // All contexts share the same standard library.
+    Script_Pool::Lease leases[4];
+    for(auto& l : leases)
+      l = pool.try_checkout();
+    ASTERIA_TEST_CHECK(pool.count_available() == 0);
+    ASTERIA_TEST_CHECK(!pool.try_checkout());
+    for(auto& l : leases)
+      ASTERIA_TEST_CHECK(l.mut_global().std_library().size() == code.global().std_library().size());
+    for(auto& l : leases)
+      l.reset();
+    ASTERIA_TEST_CHECK(pool.count_available() == 4);
+
+    // Workers block until a context becomes available.
+    ::std::atomic<int> nfailed(0);
+    ::std::thread workers[8];
+    for(int t = 0;  t < 8;  ++t)
+      workers[t] = ::std::thread(
+        [&, t] {
+          for(int k = 0;  k < 50;  ++k) {
+            auto wl = pool.checkout();
+            cow_vector<Value> wargs;
+            wargs.emplace_back(V_integer(t + k));
+            auto str = wl.execute(move(wargs)).dereference_readonly().as_string();
+            if(str != format_string("$1", (t + k) * (t + k + 1) / 2))
+              nfailed ++;
+          }
+        });
+
+    for(auto& w : workers)
+      w.join();
+    ASTERIA_TEST_CHECK(nfailed.load() == 0);
+    ASTERIA_TEST_CHECK(pool.count_available() == 4);
+  }
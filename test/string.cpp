@@ -110,6 +110,16 @@ int main()
         assert std.string.rfind("hello" + "z" * 10000 + "hello", 10005, "hello") == 10005;
         assert std.string.rfind("hello" + "z" * 10000 + "hello", 10006, "hello") == null;
 
+        var long_patt = "0123456789" * 5;
+        assert std.string.find("z" * 100 + long_patt + "z" * 100 + long_patt, long_patt) == 100;
+        assert std.string.rfind("z" * 100 + long_patt + "z" * 100 + long_patt, long_patt) == 250;
+        assert std.string.find("z" * 100 + "#" + "z" * 100, "#") == 100;
+        assert std.string.rfind("#" + "z" * 100 + "#" + "z" * 100, "#") == 101;
+        assert std.string.find("ab" * 40 + "abc" + "ab" * 40, "abc") == 80;
+        assert std.string.rfind("ab" * 40 + "abc" + "ab" * 40, "bca") == 81;
+        assert std.string.find("ab" * 40, "abc") == null;
+        assert std.string.rfind("ab" * 40, "bca") == null;
+
         assert std.string.replace("hello hello world", "llo", "####") == "he#### he#### world";
         assert std.string.replace("hello hello world", 2, "llo", "####") == "he#### he#### world";
         assert std.string.replace("hello hello world", 3, "llo", "####") == "hello he#### world";
@@ -258,6 +268,15 @@ int main()
         assert catch( std.string.base64_decode("aGVsbG8=!invalid") ) != null;
         assert std.string.base64_decode("") == "";
 
+        var long_data = "hello?!\xFE\x01" * 50;
+        assert std.string.hex_decode(std.string.hex_encode(long_data)) == long_data;
+        assert std.string.hex_decode(std.string.hex_encode(long_data, " ")) == long_data;
+        assert std.string.base32_decode(std.string.base32_encode(long_data)) == long_data;
+        assert std.string.base64_decode(std.string.base64_encode(long_data)) == long_data;
+        assert std.string.base64_encode("hello" * 20) == "aGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxsbw==";
+        assert catch( std.string.base64_decode("aGVsbG9oZWxsb2hlbGxvaGVsbG9oZWxs!b2hlbGxvaGVsbG9o") ) != null;
+        assert catch( std.string.hex_decode("00112233445566778899aabbccddeeff00112233445566778899aabbccddeefg") ) != null;
+
         assert std.string.url_encode("") == "";
         assert std.string.url_encode("abcdАВГД甲乙丙丁") == "abcd%D0%90%D0%92%D0%93%D0%94%E7%94%B2%E4%B9%99%E4%B8%99%E4%B8%81";
         assert std.string.url_encode(" \t`~!@#$%^&*()_+-={}|[]\\:\";\'<>?,./") == "%20%09%60~%21%40%23%24%25%5E%26%2A%28%29_%2B-%3D%7B%7D%7C%5B%5D%5C%3A%22%3B%27%3C%3E%3F%2C.%2F";
@@ -288,6 +307,12 @@ int main()
         assert std.string.utf8_validate("abcdАВГД甲乙丙丁") == true;
         assert std.string.utf8_validate("\xC0\x80\x61") == false;
         assert std.string.utf8_validate("\xFF\xFE\x62") == false;
+        assert std.string.utf8_validate("\xC3\x61") == false;
+        assert std.string.utf8_validate("\xED\xA0\x80") == false;
+        assert std.string.utf8_validate("\xF4\x90\x80\x80") == false;
+        assert std.string.utf8_validate("a" * 40 + "\xE7\x94") == false;
+        assert std.string.utf8_validate("a" * 30 + "甲乙丙丁" * 20 + "a" * 30) == true;
+        assert std.string.utf8_validate("a" * 30 + "甲乙丙丁" * 20 + "\x80" + "a" * 30) == false;
 
         assert std.string.utf8_encode(30002) == "甲";
         assert catch( std.string.utf8_encode(0xFFFFFF) ) != null;
@@ -301,6 +326,10 @@ int main()
         assert std.string.utf8_decode("\xC0\x80\x61", true) == [ 192, 128, 97 ];
         assert catch( std.string.utf8_decode("\xFF\xFE\x62") ) != null;
         assert std.string.utf8_decode("\xFF\xFE\x62", true) == [ 255, 254, 98 ];
+        assert std.string.utf8_decode("\xC3\x61", true) == [ 195, 97 ];
+        assert countof std.string.utf8_decode("a" * 30 + "甲乙丙丁" * 20 + "a" * 30) == 140;
+        assert std.string.utf8_encode(std.string.utf8_decode("a" * 30 + "甲乙丙丁" * 20)) == "a" * 30 + "甲乙丙丁" * 20;
+        assert std.string.utf8_encode([ 97, 0xD800, 98 ], true) == "a\uFFFDb";
 
         assert std.string.format("1$$2") == "1$2";
         assert std.string.format("hello $1 $2", "world", '!') == "hello world !";
@@ -342,6 +371,16 @@ int main()
         assert std.string.pcre_replace("a11b2c333d4e555", '(\d{3})(\w)', '$2$1') == "a11b2cd3334e555";
         assert std.string.pcre_replace("a11b2c333d4e555", '\d{34}\w', '#') == "a11b2c333d4e555";
 
+        for(var i = 0;  i < 3;  ++i) {
+          assert std.string.pcre_find("aBc", 'b') == null;
+          assert std.string.pcre_find("aBc", 'b', ["caseless"]) == [1,1];
+          assert std.string.pcre_replace("aBcb", 'b', '#') == "aBc#";
+          assert std.string.pcre_replace("aBcb", 'b', '#', ["caseless"]) == "a#c#";
+        }
+
+        var long_text = std.string.padr("", 20000, "xy") + 'z';
+        assert std.string.pcre_match(long_text, '^((x|y)*)z$')[1] == std.string.slice(long_text, 0, countof long_text - 1);
+
         var M_dw = std.string.PCRE('\d+\w');
         assert M_dw.find("a11b2c333d4e555") == [1,3];
         assert M_dw.match("a11b2c333d4e555") == [ "11b" ];
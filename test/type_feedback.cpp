@@ -0,0 +1,75 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func add(x, y) { return x + y;  }
+        func sub(x, y) { return x - y;  }
+        func less(x, y) { return x < y;  }
+        func accum(x, y) { var z = x;  z += y;  return z;  }
+
+        // Specialize these nodes for integers.
+        for(var i = 0;  i < 100;  ++i) {
+          assert add(i, 1) == i + 1;
+          assert sub(i, 1) == i - 1;
+          assert less(i, 50) == (i < 50);
+          assert accum(i, 2) == i + 2;
+        }
+
+        // Integer overflow is still detected.
+        assert catch(add(0x7FFFFFFFFFFFFFFF, 1)) != null;
+        assert catch(sub(-0x7FFFFFFFFFFFFFFF, 2)) != null;
+
+        // Operands of other types fall back to the general path.
+        assert add(1.5, 2.25) == 3.75;
+        assert add("a", "b") == "ab";
+        assert add(true, false) == true;
+        assert less("a", "b") == true;
+        assert accum(1.5, 1.0) == 2.5;
+        assert add(1, 2.5) == 3.5;
+        assert add(3, 4) == 7;
+        assert less(3, 4) == true;
+
+        // Specialize these nodes for reals.
+        func mul(x, y) { return x * y;  }
+        func div(x, y) { return x / y;  }
+        func lte(x, y) { return x <= y;  }
+        for(var i = 0;  i < 100;  ++i) {
+          assert mul(i * 1.0, 0.5) == i / 2.0;
+          assert div(i * 1.0, 4.0) == i / 4.0;
+          assert lte(i * 1.0, 50.0) == (i <= 50);
+        }
+
+        // Relational comparison of NaNs still throws exceptions.
+        assert catch(lte(nan, 1.0)) != null;
+        assert lte(0.5, 1.0) == true;
+        assert div(1.0, 0.0) == infinity;
+        assert mul(3, 5) == 15;
+        assert div(7, 2) == 3;
+        assert mul("ab", 2) == "abab";
+
+        // An unordered comparison must not specialize the node again, or
+        // operands of other types would never reach the general executor.
+        func lt(x, y) { return x < y;  }
+        for(var i = 0;  i < 50;  ++i)
+          assert lt(i * 1.0, 25.0) == (i < 25);
+        assert catch(lt(0.0 / 0.0, 1.0)) != null;
+        assert lt(1, 2) == true;
+        assert lt("a", "b") == true;
+        for(var i = 0;  i < 50;  ++i)
+          assert lt(i * 1.0, 25.0) == (i < 25);
+        assert lt(2, 1) == false;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
@@ -0,0 +1,97 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "allocation_count.hpp"
+#include "../asteria/llds/variable_arena.hpp"
+#include "../asteria/runtime/variable.hpp"
+#include <thread>
+using namespace ::asteria;
+
+int main()
+  {
+    // Ignore leaks of emutls, emergency pool, etc.
+    delete new int;
+
+    bcnt.store(0);
+    refcnt_ptr<Variable> survivor;
+    {
+      Variable_Arena arena;
+      cow_vector<refcnt_ptr<Variable>> vars;
+      for(int k = 0;  k < 3000;  ++k) {
+        vars.emplace_back(new(arena) Variable());
+        vars.mut_back()->initialize(V_integer(k));
+      }
+
+      ASTERIA_TEST_CHECK(arena.count_variables() == 3000);
+      ASTERIA_TEST_CHECK(arena.count_slabs() > 1);
+      size_t nslabs = arena.count_slabs();
+
+      // Freed storage is reused before new slabs are allocated.
+      const Variable* last = vars.back().get();
+      vars.pop_back();
+      ASTERIA_TEST_CHECK(arena.count_variables() == 2999);
+      vars.emplace_back(new(arena) Variable());
+      ASTERIA_TEST_CHECK(vars.back().get() == last);
+
+      for(size_t k = 0;  k < vars.size();  k += 2)
+        vars.mut(k).reset();
+      for(int k = 0;  k < 1500;  ++k)
+        vars.emplace_back(new(arena) Variable());
+      ASTERIA_TEST_CHECK(arena.count_variables() == 3000);
+      ASTERIA_TEST_CHECK(arena.count_slabs() == nslabs);
+
+      // Variables from the heap are not counted.
+      auto heap_var = ::rocket::make_refcnt<Variable>();
+      ASTERIA_TEST_CHECK(arena.count_variables() == 3000);
+
+      // A variable may outlive its arena.
+      survivor = vars.at(1);
+    }
+
+    ASTERIA_TEST_CHECK(survivor->get_value().as_integer() == 1);
+    survivor->initialize(V_string(&"still alive"));
+    ASTERIA_TEST_CHECK(survivor->get_value().as_string() == "still alive");
+    survivor.reset();
+    ASTERIA_TEST_CHECK(bcnt.load() == 0);
+
+    {
+      // Empty slabs are released, except the one that is being carved.
+      Variable_Arena arena;
+      cow_vector<refcnt_ptr<Variable>> vars;
+      for(int k = 0;  k < 3000;  ++k)
+        vars.emplace_back(new(arena) Variable());
+      ASTERIA_TEST_CHECK(arena.count_slabs() > 1);
+
+      vars.clear();
+      ASTERIA_TEST_CHECK(arena.count_variables() == 0);
+      ASTERIA_TEST_CHECK(arena.count_slabs() == 1);
+    }
+    ASTERIA_TEST_CHECK(bcnt.load() == 0);
+
+    cow_vector<refcnt_ptr<Variable>> shared[4];
+    {
+      // Variables may be destroyed on other threads while the arena is in
+      // use, and after it has been destroyed.
+      Variable_Arena arena;
+      for(int k = 0;  k < 20000;  ++k)
+        shared[k % 4].emplace_back(new(arena) Variable());
+
+      ::std::thread t0([&] { shared[0].clear();  });
+      ::std::thread t1([&] { shared[1].clear();  });
+      cow_vector<refcnt_ptr<Variable>> vars;
+      for(int k = 0;  k < 10000;  ++k)
+        vars.emplace_back(new(arena) Variable());
+      t0.join();
+      t1.join();
+      ASTERIA_TEST_CHECK(arena.count_variables() == 20000);
+    }
+
+    ::std::thread t2([&] { shared[2].clear();  });
+    ::std::thread t3([&] { shared[3].clear();  });
+    t2.join();
+    t3.join();
+    for(auto& vars : shared)
+      vars.shrink_to_fit();
+    ASTERIA_TEST_CHECK(bcnt.load() == 0);
+  }
@@ -0,0 +1,62 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/llds/variable_hashmap.hpp"
+#include <unordered_set>
+using namespace ::asteria;
+
+int main()
+  {
+    // Keys are never dereferenced, so fake ones are used.
+    Variable_HashMap map;
+    ::std::unordered_set<uintptr_t> ref;
+    uint64_t seed = 1;
+
+    for(int k = 0;  k < 300000;  ++k) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      uint32_t range = 1U << (4 + k / 20000);
+      uintptr_t key = (uintptr_t) ((seed >> 33) % range + 1) * 16;
+      auto var = reinterpret_cast<Variable*>(key);
+
+      switch(seed >> 62)
+        {
+        case 0:
+        case 1:
+          ASTERIA_TEST_CHECK(map.insert(var, var) == ref.insert(key).second);
+          break;
+
+        case 2:
+          ASTERIA_TEST_CHECK(map.erase(var) == (ref.erase(key) != 0));
+          break;
+
+        default:
+          if(map.extract_variable(var))
+            ASTERIA_TEST_CHECK(ref.erase(reinterpret_cast<uintptr_t>(var)) == 1);
+          else
+            ASTERIA_TEST_CHECK(ref.empty());
+          break;
+        }
+
+      ASTERIA_TEST_CHECK(map.size() == ref.size());
+    }
+
+    for(uintptr_t key : ref) {
+      Variable* var = nullptr;
+      ASTERIA_TEST_CHECK(map.find(reinterpret_cast<Variable*>(key), &var));
+      ASTERIA_TEST_CHECK(var == reinterpret_cast<Variable*>(key));
+    }
+
+    size_t count = 0;
+    map.for_each([&](Variable*) { count ++;  });
+    ASTERIA_TEST_CHECK(count == ref.size());
+
+    // Keys that are associated with null variables can be found, but are
+    // discarded instead of being extracted.
+    map.clear();
+    ASTERIA_TEST_CHECK(map.insert(&count, nullptr));
+    ASTERIA_TEST_CHECK(map.find(&count));
+    Variable* var;
+    ASTERIA_TEST_CHECK(map.extract_variable(var) == false);
+    ASTERIA_TEST_CHECK(map.empty());
+  }
@@ -0,0 +1,92 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "allocation_count.hpp"
+#include "../rocket/xmemory.hpp"
+#include <thread>
+using namespace ::asteria;
+
+int main()
+  {
+    // Ignore leaks of emutls, emergency pool, etc.
+    delete new int;
+
+    bcnt.store(0);
+    ::rocket::xmemstats stats;
+    ::rocket::xmemstat(stats);
+    uint64_t hits = stats.hits;
+    uint64_t misses = stats.misses;
+
+    // Freed blocks are cached, and are reused by the same thread.
+    ::rocket::xmeminfo info[100];
+    for(auto& r : info) {
+      r.element_size = 1;
+      r.count = 48;
+      ::rocket::xmemalloc(r);
+      ASTERIA_TEST_CHECK(r.count == 64);
+    }
+    ::rocket::xmemstat(stats);
+    ASTERIA_TEST_CHECK(stats.misses == misses + 100);
+
+    for(auto& r : info)
+      ::rocket::xmemfree(r);
+    ::rocket::xmemstat(stats);
+    ASTERIA_TEST_CHECK(stats.bytes_cached >= 6400);
+
+    for(auto& r : info) {
+      r.element_size = 1;
+      r.count = 64;
+      ::rocket::xmemalloc(r);
+    }
+    ::rocket::xmemstat(stats);
+    ASTERIA_TEST_CHECK(stats.hits == hits + 100);
+    ASTERIA_TEST_CHECK(stats.misses == misses + 100);
+
+    // Blocks can be freed by threads other than the one which has allocated
+    // them. A thread returns its cached blocks to the global pools when it
+    // exits.
+    ::std::thread other(
+      [&] {
+        for(auto& r : info)
+          ::rocket::xmemfree(r);
+      });
+    other.join();
+
+    // Multiple threads allocate and free blocks of various sizes, and check
+    // for corruption.
+    atomic_relaxed<int> nfailed;
+    ::std::thread workers[8];
+    for(int t = 0;  t < 8;  ++t)
+      workers[t] = ::std::thread(
+        [&, t] {
+          ::rocket::xmeminfo blocks[64] = { };
+          for(uint32_t k = 0;  k < 100000;  ++k) {
+            uint32_t i = (k * 37 + (uint32_t) t) % 64;
+            auto& r = blocks[i];
+            if(r.data) {
+              if(*(uint32_t*) r.data != i + (uint32_t) t * 1000)
+                nfailed.xadd(1);
+              ::rocket::xmemfree(r);
+            }
+
+            r.element_size = 8;
+            r.count = (k * 7919) % 300 + 1;
+            ::rocket::xmemalloc(r);
+            *(uint32_t*) r.data = i + (uint32_t) t * 1000;
+          }
+
+          for(auto& r : blocks)
+            ::rocket::xmemfree(r);
+        });
+
+    for(auto& w : workers)
+      w.join();
+    ASTERIA_TEST_CHECK(nfailed.load() == 0);
+
+    // All blocks are now in the global pools.
+    ::rocket::xmemclean();
+    ::rocket::xmemstat(stats);
+    ASTERIA_TEST_CHECK(stats.bytes_cached == 0);
+    ASTERIA_TEST_CHECK(bcnt.load() == 0);
+  }